@@ -0,0 +1,120 @@
+// ============================================
+// Plant Legends - 批次距離核心基準測試
+// ============================================
+// 一株植物對上 N 個緊密排列的敵人座標，找射程內最近者：
+//   vec2   : 舊 findPlantTargets 的寫法，逐一 Vec2::distanceSq，找到更近者時取 sqrt
+//   scalar : 欄位式純量迴圈
+//   sse2 / avx2 : 向量化核心（CPU 不支援時略過）
+
+#include "core/simd_distance.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace PL;
+
+namespace {
+
+constexpr u32 kOrigins = 64;
+constexpr f32 kRange = 400.0f;
+
+struct Field {
+    std::vector<f32> xs, ys;
+    std::vector<Vec2> points;  // 同一批座標的 AoS 版本
+    std::vector<Vec2> origins;
+};
+
+Field makeField(u32 count, u32 seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<f32> xDist(0.0f, 1300.0f);
+    std::uniform_real_distribution<f32> yDist(0.0f, 700.0f);
+
+    Field field;
+    for (u32 i = 0; i < count; i++) {
+        Vec2 p(xDist(gen), yDist(gen));
+        field.xs.push_back(p.x);
+        field.ys.push_back(p.y);
+        field.points.push_back(p);
+    }
+    for (u32 i = 0; i < kOrigins; i++) {
+        field.origins.emplace_back(xDist(gen), yDist(gen));
+    }
+    return field;
+}
+
+// 舊路徑：Vec2 距離平方，更近時取 sqrt 記錄距離
+u64 runVec2(const Field& f) {
+    u64 checksum = 0;
+    for (const Vec2& origin : f.origins) {
+        u32 closest = kInvalidIndex;
+        f32 closestDist = kRange;
+        for (u32 i = 0; i < (u32)f.points.size(); i++) {
+            f32 distSq = origin.distanceSq(f.points[i]);
+            if (distSq < closestDist * closestDist) {
+                closestDist = std::sqrt(distSq);
+                closest = i;
+            }
+        }
+        checksum += closest;
+    }
+    return checksum;
+}
+
+template<typename Kernel>
+u64 runKernel(const Field& f, Kernel kernel) {
+    u64 checksum = 0;
+    for (const Vec2& origin : f.origins) {
+        checksum += kernel(origin, f.xs.data(), f.ys.data(), (u32)f.xs.size(), kRange * kRange).index;
+    }
+    return checksum;
+}
+
+template<typename Fn>
+f64 timeNs(u32 iterations, u64& checksum, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (u32 it = 0; it < iterations; it++) {
+        checksum = fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    // 每次查詢（一個原點）的平均時間
+    return std::chrono::duration<f64, std::nano>(end - start).count() / (iterations * (f64)kOrigins);
+}
+
+} // namespace
+
+int main() {
+    const u32 counts[] = {64, 256, 1024, 4096, 16384, 100000};
+    const simd::Level level = simd::detectLevel();
+
+    std::printf("CPU level: %s\n", simd::levelName(level));
+    std::printf("%-8s %12s %12s %12s %12s %9s\n", "enemies", "vec2(ns)", "scalar(ns)", "sse2(ns)", "avx2(ns)", "speedup");
+
+    for (u32 n : counts) {
+        Field field = makeField(n, 42u + n);
+        const u32 iterations = std::max(5u, 20000000u / (n * kOrigins));
+
+        u64 ref = 0, sum = 0;
+        f64 vec2 = timeNs(iterations, ref, [&] { return runVec2(field); });
+        f64 scalar = timeNs(iterations, sum, [&] { return runKernel(field, simd::nearestScalar); });
+        bool match = sum == ref;
+
+        f64 sse2 = 0.0;
+        if (level >= simd::Level::SSE2) {
+            sse2 = timeNs(iterations, sum, [&] { return runKernel(field, simd::nearestSSE2); });
+            match = match && sum == ref;
+        }
+        f64 avx2 = 0.0;
+        if (level >= simd::Level::AVX2) {
+            avx2 = timeNs(iterations, sum, [&] { return runKernel(field, simd::nearestAVX2); });
+            match = match && sum == ref;
+        }
+
+        f64 best = avx2 > 0.0 ? avx2 : (sse2 > 0.0 ? sse2 : scalar);
+        std::printf("%-8u %12.1f %12.1f %12.1f %12.1f %8.1fx%s\n", n, vec2, scalar, sse2, avx2, vec2 / best,
+                    match ? "" : "  MISMATCH");
+    }
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+// ============================================
+// Plant Legends - Lua 函數呼叫基準測試
+// ============================================
+// 同一個 Lua 函數 f(a, b) = a + b，比較每秒呼叫次數：
+//   manual : 手寫 lua_rawgeti + push + lua_pcall + tointeger + pop
+//   ref    : callFunction<int>(LuaFunction, ...)
+//   name   : callFunction<int>("name", ...)，每次查全域表
+//   vec2   : callFunction<Vec2>(LuaFunction, Vec2, f32)，兩個棧位的參數與回傳值
+
+#include "lua/lua_manager.hpp"
+#include <chrono>
+#include <cstdio>
+
+using namespace PL;
+
+namespace {
+
+constexpr u32 kCalls = 2000000;
+
+template<typename Fn>
+f64 callsPerSec(i64& checksum, Fn&& fn) {
+    checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (u32 i = 0; i < kCalls; i++) {
+        checksum += fn((i32)i);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return kCalls / std::chrono::duration<f64>(end - start).count();
+}
+
+} // namespace
+
+int main() {
+    LuaManager& lua = LuaManager::instance();
+    if (!lua.initialize()) {
+        std::fprintf(stderr, "Failed to initialize Lua\n");
+        return 1;
+    }
+    lua.executeString(
+        "function bench_add(a, b) return a + b end\n"
+        "function bench_scale(x, y, k) return x * k, y * k end\n");
+    
+    lua_State* L = lua.getState();
+    LuaFunction add = lua.findFunction("bench_add");
+    LuaFunction scale = lua.findFunction("bench_scale");
+    
+    i64 ref = 0, sum = 0;
+    f64 manual = callsPerSec(ref, [&](i32 i) {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, add.ref);
+        lua_pushinteger(L, i);
+        lua_pushinteger(L, 1);
+        if (lua_pcall(L, 2, 1, 0) != LUA_OK) {
+            lua_pop(L, 1);
+            return (i64)0;
+        }
+        i64 value = lua_tointeger(L, -1);
+        lua_pop(L, 1);
+        return value;
+    });
+    f64 byRef = callsPerSec(sum, [&](i32 i) { return (i64)lua.callFunction<i32>(add, i, 1); });
+    bool match = sum == ref;
+    f64 byName = callsPerSec(sum, [&](i32 i) { return (i64)lua.callFunction<i32>("bench_add", i, 1); });
+    match = match && sum == ref;
+    f64 vec2 = callsPerSec(sum, [&](i32 i) { return (i64)lua.callFunction<Vec2>(scale, Vec2((f32)i, 1.0f), 2.0f).y; });
+    
+    const LuaHeapStats& heap = lua.getHeapStats();
+    std::printf("%-8s %14s %9s\n", "path", "calls/sec", "vs manual");
+    std::printf("%-8s %14.0f %8.2fx\n", "manual", manual, 1.0);
+    std::printf("%-8s %14.0f %8.2fx\n", "ref", byRef, byRef / manual);
+    std::printf("%-8s %14.0f %8.2fx\n", "name", byName, byName / manual);
+    std::printf("%-8s %14.0f %8.2fx\n", "vec2", vec2, vec2 / manual);
+    std::printf("errors: %llu, lua allocs: %llu%s\n", (unsigned long long)lua.getCallStats().errors,
+                (unsigned long long)heap.allocs, match ? "" : "  MISMATCH");
+    
+    lua.releaseFunction(add);
+    lua.releaseFunction(scale);
+    lua.shutdown();
+    return 0;
+}
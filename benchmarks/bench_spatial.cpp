@@ -0,0 +1,142 @@
+// ============================================
+// Plant Legends - 空間雜湊基準測試
+// ============================================
+// 比較逐一掃描所有敵人（舊 findPlantTargets 路徑）與均勻桶狀網格：
+//   nearest : 每株植物找射程內最近的敵人
+//   radius  : 每株植物收集半徑內的所有敵人（AoE / 光環）
+// 雜湊的時間包含每幀重建。
+
+#include "core/spatial_hash.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace PL;
+
+namespace {
+
+constexpr f32 kFieldWidth = 1300.0f;
+constexpr f32 kFieldHeight = 700.0f;
+constexpr u32 kPlants = 45;       // 9x5 網格全滿
+constexpr f32 kRange = 300.0f;
+constexpr f32 kAuraRadius = 200.0f;
+
+struct Field {
+    std::vector<f32> ex, ey;
+    std::vector<u8> alive;
+    std::vector<Vec2> plants;
+};
+
+Field makeField(u32 enemyCount, u32 seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<f32> xDist(0.0f, kFieldWidth);
+    std::uniform_real_distribution<f32> yDist(0.0f, kFieldHeight);
+
+    Field field;
+    field.ex.resize(enemyCount);
+    field.ey.resize(enemyCount);
+    field.alive.assign(enemyCount, 1);
+    for (u32 i = 0; i < enemyCount; i++) {
+        field.ex[i] = xDist(gen);
+        field.ey[i] = yDist(gen);
+    }
+    for (u32 p = 0; p < kPlants; p++) {
+        field.plants.emplace_back(140.0f + (p % 9) * 80.0f, 150.0f + (p / 9) * 100.0f);
+    }
+    return field;
+}
+
+// 舊路徑：每株植物掃描全部敵人
+u64 bruteNearest(const Field& f) {
+    u64 checksum = 0;
+    const u32 n = (u32)f.ex.size();
+    for (const Vec2& origin : f.plants) {
+        u32 closest = kInvalidIndex;
+        f32 closestDistSq = kRange * kRange;
+        for (u32 i = 0; i < n; i++) {
+            if (!f.alive[i]) continue;
+            f32 distSq = origin.distanceSq(Vec2(f.ex[i], f.ey[i]));
+            if (distSq < closestDistSq) {
+                closestDistSq = distSq;
+                closest = i;
+            }
+        }
+        checksum += closest;
+    }
+    return checksum;
+}
+
+u64 bruteRadius(const Field& f) {
+    u64 checksum = 0;
+    const u32 n = (u32)f.ex.size();
+    const f32 radiusSq = kAuraRadius * kAuraRadius;
+    for (const Vec2& origin : f.plants) {
+        for (u32 i = 0; i < n; i++) {
+            if (f.alive[i] && origin.distanceSq(Vec2(f.ex[i], f.ey[i])) <= radiusSq) {
+                checksum += i;
+            }
+        }
+    }
+    return checksum;
+}
+
+u64 hashNearest(const Field& f, SpatialHash& hash) {
+    hash.build(f.ex.data(), f.ey.data(), f.alive.data(), (u32)f.ex.size());
+    u64 checksum = 0;
+    for (const Vec2& origin : f.plants) {
+        u32 id;
+        f32 distSq;
+        checksum += hash.kNearest(origin, 1, kRange, &id, &distSq) ? id : kInvalidIndex;
+    }
+    return checksum;
+}
+
+u64 hashRadius(const Field& f, SpatialHash& hash) {
+    hash.build(f.ex.data(), f.ey.data(), f.alive.data(), (u32)f.ex.size());
+    u64 checksum = 0;
+    for (const Vec2& origin : f.plants) {
+        hash.forEachInRadius(origin, kAuraRadius, [&](u32 id, f32) { checksum += id; });
+    }
+    return checksum;
+}
+
+template<typename Fn>
+f64 timeUs(u32 iterations, u64& checksum, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (u32 it = 0; it < iterations; it++) {
+        checksum = fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<f64, std::micro>(end - start).count() / iterations;
+}
+
+} // namespace
+
+int main() {
+    const u32 counts[] = {64, 256, 1024, 4096, 16384, 100000};
+
+    SpatialHash hash;
+    hash.configure(0.0f, 0.0f, kFieldWidth, kFieldHeight, 100.0f);
+
+    std::printf("%-8s %-8s %12s %12s %9s\n", "enemies", "query", "brute(us)", "hash(us)", "speedup");
+
+    for (u32 n : counts) {
+        Field field = makeField(n, 1234u + n);
+        const u32 iterations = std::max(3u, 2000000u / (n * kPlants / 16 + 1));
+
+        u64 a = 0, b = 0;
+        f64 brute = timeUs(iterations, a, [&] { return bruteNearest(field); });
+        f64 fast = timeUs(iterations, b, [&] { return hashNearest(field, hash); });
+        std::printf("%-8u %-8s %12.2f %12.2f %8.1fx%s\n", n, "nearest", brute, fast, brute / fast,
+                    a == b ? "" : "  MISMATCH");
+
+        brute = timeUs(iterations, a, [&] { return bruteRadius(field); });
+        fast = timeUs(iterations, b, [&] { return hashRadius(field, hash); });
+        std::printf("%-8u %-8s %12.2f %12.2f %8.1fx%s\n", n, "radius", brute, fast, brute / fast,
+                    a == b ? "" : "  MISMATCH");
+    }
+
+    return 0;
+}
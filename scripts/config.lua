@@ -22,6 +22,16 @@ config = {
         cell_width = 80,
         cell_height = 100,
         
+        -- 投射物池容量（關卡可用 projectile_pool 覆寫）
+        projectile_pool_size = 1024,
+        
+        -- 模擬步長（每秒 tick 數，與畫面更新率無關）與每幀最多補幾個 tick
+        tick_rate = 60,
+        max_steps_per_frame = 5,
+        
+        -- 每幀 Lua GC 上限（毫秒，只用幀的空閒時間；0 = Lua 自動 GC）
+        lua_gc_max_ms = 1.0,
+        
         -- Combo
         combo_timeout = 3.0,  -- 秒
         combo_multipliers = {
@@ -67,10 +77,12 @@ config = {
             slow_amount = 0.5,
             slow_duration = 2.0,
             freeze_chance = 0.1,
+            freeze_duration = 1.0,
         },
         lightning = {
             chain_count = 3,
             chain_damage_decay = 0.7,
+            chain_range = 150,
         },
         poison = {
             dot_damage = 0.05,
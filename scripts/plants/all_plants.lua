@@ -247,7 +247,7 @@ plants.frost_sprite = {
             duration = 2.0,
         })
         -- 有機率凍結
-        if math.random() < 0.1 then
+        if game:random() < 0.1 then
             target:apply_status("freeze", { duration = 1.0 })
         end
     end,
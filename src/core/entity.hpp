@@ -5,57 +5,29 @@
 #pragma once
 
 #include "core/types.hpp"
-#include "sf3.hpp"
-#include <vector>
 #include <memory>
 
 namespace PL {
 
+// 位置、血量、計時器、狀態效果等熱資料存放在 Game 的 SoA 儲存中，
+// Entity 只保留每個實例的冷資料；其他系統以句柄引用實體。
 class Entity {
 public:
     Entity(EntityType type);
     virtual ~Entity() = default;
     
     // 生命週期
-    virtual void update(f32 dt);
     virtual void render() = 0;
     
-    // 狀態
-    bool isAlive() const { return alive; }
-    bool isActive() const { return active; }
-    void setActive(bool a) { active = a; }
-    
-    // 位置  
-    const Vec2& getPosition() const { return position; }
-    void setPosition(const Vec2& pos) { position = pos; }
-    
     // 類型
     EntityType getType() const { return type; }
     
     // ID
     u32 getId() const { return id; }
     
-    // 碰撞
-    const SF3::Rect& getBounds() const { return bounds; }
-    void setBounds(const SF3::Rect& b) { bounds = b; }
-    
-    // 狀態效果
-    void addStatus(const StatusEffect& effect);
-    void updateStatuses(f32 dt);
-    bool hasStatus(StatusType type) const;
-    
-    // 標記為銷毀
-    void destroy() { alive = false; }
-    
 protected:
     u32 id;
     EntityType type;
-    Vec2 position;
-    SF3::Rect bounds;
-    bool alive = true;
-    bool active = true;
-    
-    std::vector<StatusEffect> statuses;
     
     static u32 nextId;
 };
@@ -0,0 +1,139 @@
+// ============================================
+// Plant Legends - File Watcher Implementation
+// ============================================
+
+#include "file_watcher.hpp"
+#include "log.hpp"
+#include <algorithm>
+#include <chrono>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#define PL_HAS_INOTIFY 1
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace PL {
+
+namespace {
+
+bool isScript(const std::string& name) {
+    return name.size() > 4 && name.compare(name.size() - 4, 4, ".lua") == 0;
+}
+
+void addUnique(std::vector<std::string>& out, std::string path) {
+    if (std::find(out.begin(), out.end(), path) == out.end()) {
+        out.push_back(std::move(path));
+    }
+}
+
+f64 nowSeconds() {
+    using namespace std::chrono;
+    return duration<f64>(steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+FileWatcher::FileWatcher() {
+#ifdef PL_HAS_INOTIFY
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        PL_LOG_WARN(General, "inotify unavailable, falling back to polling");
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef PL_HAS_INOTIFY
+    if (fd >= 0) close(fd);
+#endif
+}
+
+bool FileWatcher::addDirectory(const std::string& dir) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir, ec)) return false;
+    
+    int wd = -1;
+#ifdef PL_HAS_INOTIFY
+    if (fd >= 0) {
+        // 編輯器可能原地寫入（CLOSE_WRITE）或寫暫存檔再改名（MOVED_TO）
+        wd = inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) {
+            PL_LOG_WARN(General, "Cannot watch %s", dir.c_str());
+            return false;
+        }
+    }
+#endif
+    
+    dirs.push_back(dir);
+    watches.push_back(wd);
+    if (fd < 0) scanDirectory(dir, nullptr);
+    return true;
+}
+
+u32 FileWatcher::poll(std::vector<std::string>& changed) {
+    changed.clear();
+    if (fd >= 0) {
+        pollInotify(changed);
+    } else {
+        pollScan(changed);
+    }
+    return (u32)changed.size();
+}
+
+void FileWatcher::pollInotify(std::vector<std::string>& changed) {
+#ifdef PL_HAS_INOTIFY
+    alignas(inotify_event) char buffer[4096];
+    
+    for (;;) {
+        ssize_t len = read(fd, buffer, sizeof(buffer));
+        if (len <= 0) break;  // EAGAIN：沒有更多事件
+        
+        for (char* p = buffer; p < buffer + len; ) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + event->len;
+            if (event->len == 0 || !isScript(event->name)) continue;
+            
+            auto it = std::find(watches.begin(), watches.end(), event->wd);
+            if (it == watches.end()) continue;
+            addUnique(changed, dirs[it - watches.begin()] + "/" + event->name);
+        }
+    }
+#else
+    (void)changed;
+#endif
+}
+
+void FileWatcher::pollScan(std::vector<std::string>& changed) {
+    const f64 now = nowSeconds();
+    if (now - lastScan < kScanInterval) return;
+    lastScan = now;
+    
+    for (const std::string& dir : dirs) {
+        scanDirectory(dir, &changed);
+    }
+}
+
+void FileWatcher::scanDirectory(const std::string& dir, std::vector<std::string>* changed) {
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        const std::string path = entry.path().generic_string();
+        if (!entry.is_regular_file(ec) || !isScript(path)) continue;
+        
+        auto time = entry.last_write_time(ec);
+        if (ec) continue;
+        
+        auto it = std::find_if(files.begin(), files.end(),
+                               [&](const FileTime& f) { return f.path == path; });
+        if (it == files.end()) {
+            files.push_back({ path, time });
+            if (changed) addUnique(*changed, path);
+        } else if (it->time != time) {
+            it->time = time;
+            if (changed) addUnique(*changed, path);
+        }
+    }
+}
+
+} // namespace PL
@@ -0,0 +1,51 @@
+// ============================================
+// Plant Legends - 檔案變更監看
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace PL {
+
+// 監看目錄（不遞迴）中被寫入或搬入的 .lua 檔。
+// Linux 使用非阻塞的 inotify，poll() 只讀取已排入的事件，沒有變更時是一次 read()；
+// 其他平台退回每 kScanInterval 秒比對一次修改時間。
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    
+    bool addDirectory(const std::string& dir);
+    
+    // 取出上次呼叫以來變更的檔案路徑（去重），回傳數量，不阻塞
+    u32 poll(std::vector<std::string>& changed);
+    
+    bool usesInotify() const { return fd >= 0; }
+    u32 getDirectoryCount() const { return (u32)dirs.size(); }
+    
+private:
+    static constexpr f64 kScanInterval = 0.25;
+    
+    struct FileTime {
+        std::string path;
+        std::filesystem::file_time_type time;
+    };
+    
+    int fd = -1;
+    std::vector<std::string> dirs;
+    std::vector<int> watches;           // 與 dirs 對應的 inotify watch descriptor
+    std::vector<FileTime> files;        // 輪詢模式的上次修改時間
+    f64 lastScan = 0.0;
+    
+    void pollInotify(std::vector<std::string>& changed);
+    void pollScan(std::vector<std::string>& changed);
+    void scanDirectory(const std::string& dir, std::vector<std::string>* changed);
+};
+
+} // namespace PL
@@ -0,0 +1,55 @@
+// ============================================
+// Plant Legends - 固定步長
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+
+namespace PL {
+
+// 固定步長累加器
+// 幀時間累加後切成整數個固定 tick，模擬結果與幀率無關；
+// 剩下不足一個 tick 的時間以 alpha（0..1）交給渲染器在前後兩個 tick 之間插值。
+// 一幀最多執行 maxSteps 個 tick，超出的時間直接捨棄，
+// 避免慢幀讓下一幀要補更多 tick 而越拖越慢。
+class FixedTimestep {
+public:
+    void configure(f32 tickRate, u32 maxStepsPerFrame) {
+        step = tickRate > 0.0f ? 1.0f / tickRate : 1.0f / 60.0f;
+        maxSteps = maxStepsPerFrame > 0 ? maxStepsPerFrame : 1;
+        accumulator = 0.0f;
+    }
+    
+    // 累加本幀時間，回傳要執行的 tick 數
+    u32 advance(f32 frameDt) {
+        accumulator += frameDt > 0.0f ? frameDt : 0.0f;
+        u32 steps = (u32)(accumulator / step);
+        if (steps > maxSteps) {
+            droppedSteps += steps - maxSteps;
+            steps = maxSteps;
+            accumulator = 0.0f;
+        } else {
+            accumulator -= steps * step;
+        }
+        ticks += steps;
+        return steps;
+    }
+    
+    void reset() { accumulator = 0.0f; }
+    
+    f32 getStep() const { return step; }
+    f32 getAlpha() const { return accumulator / step; }
+    u32 getMaxSteps() const { return maxSteps; }
+    u64 getTicks() const { return ticks; }
+    u64 getDroppedSteps() const { return droppedSteps; }  // 被上限捨棄的 tick
+    
+private:
+    f32 step = 1.0f / 60.0f;
+    f32 accumulator = 0.0f;
+    u32 maxSteps = 5;
+    u64 ticks = 0;
+    u64 droppedSteps = 0;
+};
+
+} // namespace PL
@@ -0,0 +1,95 @@
+// ============================================
+// Plant Legends - 世代實體句柄
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include <vector>
+
+namespace PL {
+
+// 句柄 = 槽位索引 + 世代
+// 實體移除時槽位世代 +1，舊句柄自動失效，不需要引用計數。
+template<typename T>
+struct Handle {
+    u32 index = kInvalidIndex;
+    u32 generation = 0;
+
+    Handle() = default;
+    Handle(u32 index, u32 generation) : index(index), generation(generation) {}
+
+    bool isNull() const { return index == kInvalidIndex; }
+    explicit operator bool() const { return !isNull(); }
+
+    bool operator==(const Handle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const Handle& other) const {
+        return !(*this == other);
+    }
+};
+
+using PlantHandle = Handle<Plant>;
+using EnemyHandle = Handle<Enemy>;
+
+// 槽位表：穩定的槽位索引 -> SoA 中的 dense index
+class SlotTable {
+public:
+    // 分配槽位並指向 dense index
+    template<typename T>
+    Handle<T> allocate(u32 denseIndex) {
+        u32 slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+            dense[slot] = denseIndex;
+        } else {
+            slot = (u32)dense.size();
+            dense.push_back(denseIndex);
+            generations.push_back(0);
+        }
+        return Handle<T>(slot, generations[slot]);
+    }
+
+    // 解析句柄，失效時回傳 kInvalidIndex
+    template<typename T>
+    u32 resolve(const Handle<T>& handle) const {
+        if (handle.index >= dense.size() || generations[handle.index] != handle.generation) {
+            return kInvalidIndex;
+        }
+        return dense[handle.index];
+    }
+
+    u32 generation(u32 slot) const { return generations[slot]; }
+
+    // dense index 因 swap-remove 搬移
+    void move(u32 slot, u32 denseIndex) { dense[slot] = denseIndex; }
+
+    // 釋放槽位，使所有指向它的句柄失效
+    void release(u32 slot) {
+        dense[slot] = kInvalidIndex;
+        generations[slot]++;
+        freeSlots.push_back(slot);
+    }
+
+    // 釋放全部槽位（保留世代，避免舊句柄復活）
+    void releaseAll() {
+        freeSlots.clear();
+        for (u32 slot = (u32)dense.size(); slot-- > 0; ) {
+            if (dense[slot] != kInvalidIndex) {
+                generations[slot]++;
+                dense[slot] = kInvalidIndex;
+            }
+            freeSlots.push_back(slot);
+        }
+    }
+
+private:
+    std::vector<u32> dense;
+    std::vector<u32> generations;
+    std::vector<u32> freeSlots;
+};
+
+} // namespace PL
@@ -0,0 +1,212 @@
+// ============================================
+// Plant Legends - Logger Implementation
+// ============================================
+
+#include "core/log.hpp"
+#include <chrono>
+#include <cstdio>
+
+namespace PL {
+
+namespace {
+
+constexpr u32 kMask = Logger::kCapacity - 1;
+static_assert((Logger::kCapacity & kMask) == 0, "Logger capacity must be a power of two");
+
+const char* categoryName(LogCategory category) {
+    switch (category) {
+        case LogCategory::Game:    return "Game";
+        case LogCategory::Combat:  return "Combat";
+        case LogCategory::Spawn:   return "Spawn";
+        case LogCategory::Economy: return "Economy";
+        case LogCategory::Lua:     return "Lua";
+        default:                   return "General";
+    }
+}
+
+i64 nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// 消費端互斥（只在排空時使用，生產者不受影響）
+std::atomic_flag s_draining = ATOMIC_FLAG_INIT;
+
+} // namespace
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() {
+    slots = new Slot[kCapacity];
+    for (u32 i = 0; i < kCapacity; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+#ifdef NDEBUG
+    minLevel.store((u8)LogLevel::Info, std::memory_order_relaxed);
+#else
+    minLevel.store((u8)LogLevel::Debug, std::memory_order_relaxed);
+#endif
+
+    // 戰鬥與生成在大波次時最容易洗版
+    setRateLimit(LogCategory::Combat, 100);
+    setRateLimit(LogCategory::Spawn, 50);
+}
+
+Logger::~Logger() {
+    stop();
+    delete[] slots;
+}
+
+void Logger::start() {
+    if (running.exchange(true)) return;
+
+#ifdef PL_LOG_THREADED
+    worker = std::thread([this] {
+        while (running.load(std::memory_order_acquire)) {
+            if (drain(false) == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+    });
+#endif
+}
+
+void Logger::stop() {
+    if (running.exchange(false)) {
+#ifdef PL_LOG_THREADED
+        if (worker.joinable()) {
+            worker.join();
+        }
+#endif
+    }
+    flush();
+}
+
+void Logger::flush() {
+    drain(true);
+}
+
+void Logger::setRateLimit(LogCategory category, u32 perSecond) {
+    limits[(u32)category].perSecond.store(perSecond, std::memory_order_relaxed);
+}
+
+bool Logger::shouldLog(LogLevel level, LogCategory category) {
+    if ((u8)level < minLevel.load(std::memory_order_relaxed)) return false;
+
+    // 警告與錯誤不受頻率限制
+    if (level >= LogLevel::Warn) return true;
+
+    RateLimit& limit = limits[(u32)category];
+    const u32 perSecond = limit.perSecond.load(std::memory_order_relaxed);
+    if (perSecond == 0) return true;
+
+    // 每秒一個視窗；搶到換窗的生產者順便回報上一窗被擋下的數量
+    const i64 now = nowMs();
+    i64 start = limit.windowStart.load(std::memory_order_relaxed);
+    if (now - start >= 1000 &&
+        limit.windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        limit.count.store(0, std::memory_order_relaxed);
+        u32 skipped = limit.suppressed.exchange(0, std::memory_order_relaxed);
+        if (skipped > 0) {
+            write(LogLevel::Warn, category, "%u messages suppressed by rate limit", skipped);
+        }
+    }
+
+    if (limit.count.fetch_add(1, std::memory_order_relaxed) < perSecond) {
+        return true;
+    }
+    limit.suppressed.fetch_add(1, std::memory_order_relaxed);
+    suppressedTotal.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void Logger::write(LogLevel level, LogCategory category, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    push(level, category, fmt, args);
+    va_end(args);
+}
+
+void Logger::push(LogLevel level, LogCategory category, const char* fmt, va_list args) {
+    // 有界 MPMC 佇列（序號式）：序號 == pos 表示槽位可寫
+    u32 pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & kMask];
+        u32 seq = slot->sequence.load(std::memory_order_acquire);
+        i32 diff = (i32)(seq - pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    slot->category = category;
+    std::vsnprintf(slot->text, kMessageSize, fmt, args);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+u32 Logger::drain(bool wait) {
+    // 背景執行緒正在排空時，flush() 等它完成這一批再接手
+    while (s_draining.test_and_set(std::memory_order_acquire)) {
+        if (!wait) return 0;
+        std::this_thread::yield();
+    }
+
+    u32 count = 0;
+    bool wroteError = false;
+    while (true) {
+        Slot& slot = slots[dequeuePos & kMask];
+        u32 seq = slot.sequence.load(std::memory_order_acquire);
+        if ((i32)(seq - (dequeuePos + 1)) < 0) break;  // 尚未寫入
+
+        const char* name = categoryName(slot.category);
+        switch (slot.level) {
+            case LogLevel::Error:
+                std::fprintf(stderr, "[%s][ERROR] %s\n", name, slot.text);
+                wroteError = true;
+                break;
+            case LogLevel::Warn:
+                std::fprintf(stdout, "[%s][WARN] %s\n", name, slot.text);
+                break;
+            default:
+                std::fprintf(stdout, "[%s] %s\n", name, slot.text);
+                break;
+        }
+
+        slot.sequence.store(dequeuePos + kCapacity, std::memory_order_release);
+        dequeuePos++;
+        count++;
+    }
+
+    // 一批只 flush 一次
+    if (count > 0) {
+        std::fflush(stdout);
+        if (wroteError) std::fflush(stderr);
+        written.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    s_draining.clear(std::memory_order_release);
+    return count;
+}
+
+LoggerStats Logger::getStats() const {
+    LoggerStats stats;
+    stats.written = written.load(std::memory_order_relaxed);
+    stats.dropped = dropped.load(std::memory_order_relaxed);
+    stats.suppressed = suppressedTotal.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace PL
@@ -0,0 +1,141 @@
+// ============================================
+// Plant Legends - 非同步日誌
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include <atomic>
+#include <cstdarg>
+#include <thread>
+
+// 沒有執行緒支援的 Web 建置改為每幀在主執行緒排空
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define PL_LOG_THREADED 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PL_PRINTF_FORMAT(fmtIndex, argIndex) __attribute__((format(printf, fmtIndex, argIndex)))
+#else
+#define PL_PRINTF_FORMAT(fmtIndex, argIndex)
+#endif
+
+namespace PL {
+
+enum class LogLevel : u8 {
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error
+};
+
+enum class LogCategory : u8 {
+    General,
+    Game,
+    Combat,
+    Spawn,
+    Economy,
+    Lua,
+    Count
+};
+
+struct LoggerStats {
+    u64 written = 0;      // 已輸出
+    u64 dropped = 0;      // 佇列滿而捨棄
+    u64 suppressed = 0;   // 被頻率限制擋下
+};
+
+// 多生產者 / 單消費者的固定大小環形佇列。
+// 生產者以 CAS 取得槽位後直接把訊息格式化進槽位，不上鎖也不配置記憶體；
+// 背景執行緒批次寫出並只 flush 一次。佇列滿時捨棄訊息而不是等待。
+class Logger {
+public:
+    static constexpr u32 kCapacity = 4096;     // 必須是 2 的冪
+    static constexpr u32 kMessageSize = 240;
+
+    static Logger& instance();
+
+    void start();   // 啟動背景排空執行緒
+    void stop();    // 排空剩餘訊息並結束執行緒
+    void flush();   // 在呼叫端執行緒排空（無執行緒建置每幀呼叫）
+
+    void setMinLevel(LogLevel level) { minLevel.store((u8)level, std::memory_order_relaxed); }
+    LogLevel getMinLevel() const { return (LogLevel)minLevel.load(std::memory_order_relaxed); }
+
+    // 每個分類每秒最多輸出幾條（0 = 不限制）
+    void setRateLimit(LogCategory category, u32 perSecond);
+
+    // 等級與頻率限制檢查；通過時才值得格式化訊息
+    bool shouldLog(LogLevel level, LogCategory category);
+
+    void write(LogLevel level, LogCategory category, const char* fmt, ...) PL_PRINTF_FORMAT(4, 5);
+
+    LoggerStats getStats() const;
+
+private:
+    Logger();
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    struct Slot {
+        std::atomic<u32> sequence;
+        LogLevel level;
+        LogCategory category;
+        char text[kMessageSize];
+    };
+
+    struct RateLimit {
+        std::atomic<u32> perSecond{0};
+        std::atomic<i64> windowStart{0};
+        std::atomic<u32> count{0};
+        std::atomic<u32> suppressed{0};
+    };
+
+    Slot* slots;
+    alignas(64) std::atomic<u32> enqueuePos{0};
+    alignas(64) u32 dequeuePos = 0;
+
+    std::atomic<u8> minLevel;
+    RateLimit limits[(u32)LogCategory::Count];
+
+    std::atomic<u64> written{0};
+    std::atomic<u64> dropped{0};
+    std::atomic<u64> suppressedTotal{0};
+
+#ifdef PL_LOG_THREADED
+    std::thread worker;
+#endif
+    std::atomic<bool> running{false};
+
+    void push(LogLevel level, LogCategory category, const char* fmt, va_list args);
+    u32 drain(bool wait);
+};
+
+} // namespace PL
+
+// ============================================
+// 日誌巨集
+// ============================================
+// Debug / Trace 在 release（NDEBUG）下整段編譯掉，連參數都不求值。
+
+#define PL_LOG(level, category, ...)                                          \
+    do {                                                                      \
+        ::PL::Logger& plLogger_ = ::PL::Logger::instance();                   \
+        if (plLogger_.shouldLog(level, category)) {                           \
+            plLogger_.write(level, category, __VA_ARGS__);                    \
+        }                                                                     \
+    } while (0)
+
+#ifdef NDEBUG
+#define PL_LOG_TRACE(category, ...) ((void)0)
+#define PL_LOG_DEBUG(category, ...) ((void)0)
+#else
+#define PL_LOG_TRACE(category, ...) PL_LOG(::PL::LogLevel::Trace, ::PL::LogCategory::category, __VA_ARGS__)
+#define PL_LOG_DEBUG(category, ...) PL_LOG(::PL::LogLevel::Debug, ::PL::LogCategory::category, __VA_ARGS__)
+#endif
+
+#define PL_LOG_INFO(category, ...)  PL_LOG(::PL::LogLevel::Info, ::PL::LogCategory::category, __VA_ARGS__)
+#define PL_LOG_WARN(category, ...)  PL_LOG(::PL::LogLevel::Warn, ::PL::LogCategory::category, __VA_ARGS__)
+#define PL_LOG_ERROR(category, ...) PL_LOG(::PL::LogLevel::Error, ::PL::LogCategory::category, __VA_ARGS__)
@@ -0,0 +1,93 @@
+// ============================================
+// Plant Legends - 可設定種子的亂數
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+
+namespace PL {
+
+// PCG32（XSH-RR）：64 位元狀態，每次輸出 32 位元。
+// 同一個種子配上不同的 stream（遞增量）得到互不相關的序列，
+// 適合從一個關卡種子切出多條子串流。沒有共享狀態，每個 Game 各自一份。
+class Pcg32 {
+public:
+    Pcg32() { seed(0, 0); }
+    Pcg32(u64 initState, u64 stream) { seed(initState, stream); }
+    
+    void seed(u64 initState, u64 stream) {
+        state = 0;
+        inc = (stream << 1u) | 1u;
+        next();
+        state += initState;
+        next();
+    }
+    
+    u32 next() {
+        const u64 old = state;
+        state = old * 6364136223846793005ull + inc;
+        const u32 xorshifted = (u32)(((old >> 18u) ^ old) >> 27u);
+        const u32 rot = (u32)(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31u));
+    }
+    
+    // [0, 1)
+    f32 nextFloat() { return (next() >> 8) * (1.0f / 16777216.0f); }
+    
+    // [0, bound)，無偏差（Lemire 乘法 + 拒絕）
+    u32 nextBelow(u32 bound) {
+        if (bound == 0) return 0;
+        u64 m = (u64)next() * bound;
+        u32 low = (u32)m;
+        if (low < bound) {
+            const u32 threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                m = (u64)next() * bound;
+                low = (u32)m;
+            }
+        }
+        return (u32)(m >> 32);
+    }
+    
+    // [lo, hi]
+    i32 range(i32 lo, i32 hi) {
+        if (hi <= lo) return lo;
+        return (i32)((u32)lo + nextBelow((u32)hi - (u32)lo + 1u));
+    }
+    
+    bool chance(f32 probability) { return nextFloat() < probability; }
+    
+private:
+    u64 state = 0;
+    u64 inc = 1;
+};
+
+// 遊戲內的亂數子串流：各系統抽取次數互不影響，
+// 例如多放一株會爆擊的植物不會改變之後敵人的出生行。
+enum class RandomStream : u8 {
+    Spawn,    // 波次敵人的出生行
+    Combat,   // 爆擊、凍結等戰鬥判定
+    Drops,    // 掉落（保留給掉落系統）
+    Script,   // 腳本的 game:random()
+    Count
+};
+
+class GameRandom {
+public:
+    void seed(u64 s) {
+        seedValue = s;
+        for (u32 i = 0; i < (u32)RandomStream::Count; i++) {
+            streams[i].seed(s, i);
+        }
+    }
+    
+    u64 getSeed() const { return seedValue; }
+    Pcg32& operator[](RandomStream stream) { return streams[(u32)stream]; }
+    
+private:
+    u64 seedValue = 0;
+    Pcg32 streams[(u32)RandomStream::Count];
+};
+
+} // namespace PL
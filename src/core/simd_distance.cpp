@@ -0,0 +1,190 @@
+// ============================================
+// Plant Legends - SIMD Distance Implementation
+// ============================================
+
+#include "core/simd_distance.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PL_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// AVX2 以函式屬性個別開啟，執行時再檢查 CPU；MSVC 需整體以 /arch:AVX2 編譯
+#if defined(PL_SIMD_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define PL_SIMD_AVX2 1
+#define PL_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(PL_SIMD_SSE2) && defined(__AVX2__)
+#define PL_SIMD_AVX2 1
+#define PL_TARGET_AVX2
+#include <immintrin.h>
+#endif
+
+namespace PL {
+
+namespace {
+
+// 合併各通道的結果：距離較小者勝，相同時取較小索引
+void mergeLane(NearestResult& best, u32 index, f32 distSq) {
+    if (index == kInvalidIndex) return;
+    if (best.index == kInvalidIndex || distSq < best.distSq ||
+        (distSq == best.distSq && index < best.index)) {
+        best.index = index;
+        best.distSq = distSq;
+    }
+}
+
+// 從 start 開始的純量尾端；best 帶入 SIMD 部分的結果
+NearestResult scalarTail(const Vec2& origin, const f32* xs, const f32* ys, u32 start, u32 count,
+                         f32 rangeSq, NearestResult best) {
+    f32 limit = best.index != kInvalidIndex ? best.distSq : rangeSq;
+    for (u32 i = start; i < count; i++) {
+        f32 dx = xs[i] - origin.x;
+        f32 dy = ys[i] - origin.y;
+        f32 distSq = dx * dx + dy * dy;
+        if (distSq < limit) {
+            limit = distSq;
+            best.index = i;
+            best.distSq = distSq;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+namespace simd {
+
+NearestResult nearestScalar(const Vec2& origin, const f32* xs, const f32* ys, u32 count, f32 rangeSq) {
+    return scalarTail(origin, xs, ys, 0, count, rangeSq, NearestResult());
+}
+
+#ifdef PL_SIMD_SSE2
+
+NearestResult nearestSSE2(const Vec2& origin, const f32* xs, const f32* ys, u32 count, f32 rangeSq) {
+    const __m128 ox = _mm_set1_ps(origin.x);
+    const __m128 oy = _mm_set1_ps(origin.y);
+    const __m128i step = _mm_set1_epi32(4);
+    __m128 bestD = _mm_set1_ps(rangeSq);
+    __m128i bestI = _mm_set1_epi32(-1);
+    __m128i idx = _mm_setr_epi32(0, 1, 2, 3);
+
+    u32 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), ox);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), oy);
+        __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+        // 嚴格小於：同通道內保留先出現的索引
+        __m128i closer = _mm_castps_si128(_mm_cmplt_ps(d, bestD));
+        bestD = _mm_min_ps(d, bestD);
+        bestI = _mm_or_si128(_mm_and_si128(closer, idx), _mm_andnot_si128(closer, bestI));
+        idx = _mm_add_epi32(idx, step);
+    }
+
+    alignas(16) f32 laneD[4];
+    alignas(16) u32 laneI[4];
+    _mm_store_ps(laneD, bestD);
+    _mm_store_si128(reinterpret_cast<__m128i*>(laneI), bestI);
+
+    NearestResult best;
+    for (u32 l = 0; l < 4; l++) {
+        mergeLane(best, laneI[l], laneD[l]);
+    }
+    return scalarTail(origin, xs, ys, i, count, rangeSq, best);
+}
+
+#else
+
+NearestResult nearestSSE2(const Vec2& origin, const f32* xs, const f32* ys, u32 count, f32 rangeSq) {
+    return nearestScalar(origin, xs, ys, count, rangeSq);
+}
+
+#endif
+
+#ifdef PL_SIMD_AVX2
+
+PL_TARGET_AVX2
+NearestResult nearestAVX2(const Vec2& origin, const f32* xs, const f32* ys, u32 count, f32 rangeSq) {
+    const __m256 ox = _mm256_set1_ps(origin.x);
+    const __m256 oy = _mm256_set1_ps(origin.y);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256 bestD = _mm256_set1_ps(rangeSq);
+    __m256i bestI = _mm256_set1_epi32(-1);
+    __m256i idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    u32 i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), ox);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), oy);
+        __m256 d = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+        __m256 closer = _mm256_cmp_ps(d, bestD, _CMP_LT_OQ);
+        bestD = _mm256_min_ps(d, bestD);
+        bestI = _mm256_blendv_epi8(bestI, idx, _mm256_castps_si256(closer));
+        idx = _mm256_add_epi32(idx, step);
+    }
+
+    alignas(32) f32 laneD[8];
+    alignas(32) u32 laneI[8];
+    _mm256_store_ps(laneD, bestD);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(laneI), bestI);
+
+    NearestResult best;
+    for (u32 l = 0; l < 8; l++) {
+        mergeLane(best, laneI[l], laneD[l]);
+    }
+    return scalarTail(origin, xs, ys, i, count, rangeSq, best);
+}
+
+#else
+
+NearestResult nearestAVX2(const Vec2& origin, const f32* xs, const f32* ys, u32 count, f32 rangeSq) {
+    return nearestSSE2(origin, xs, ys, count, rangeSq);
+}
+
+#endif
+
+Level detectLevel() {
+#if defined(PL_SIMD_AVX2) && (defined(__GNUC__) || defined(__clang__))
+    if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+#elif defined(PL_SIMD_AVX2)
+    return Level::AVX2;
+#endif
+#ifdef PL_SIMD_SSE2
+    return Level::SSE2;
+#else
+    return Level::Scalar;
+#endif
+}
+
+const char* levelName(Level level) {
+    switch (level) {
+        case Level::AVX2: return "AVX2";
+        case Level::SSE2: return "SSE2";
+        default: return "Scalar";
+    }
+}
+
+} // namespace simd
+
+NearestResult nearestInRange(const Vec2& origin, const f32* xs, const f32* ys, u32 count, f32 rangeSq) {
+    using Kernel = NearestResult (*)(const Vec2&, const f32*, const f32*, u32, f32);
+
+    // 第一次呼叫時依 CPU 選定實作
+    static const Kernel kernel = [] {
+        switch (simd::detectLevel()) {
+            case simd::Level::AVX2: return (Kernel)&simd::nearestAVX2;
+            case simd::Level::SSE2: return (Kernel)&simd::nearestSSE2;
+            default: return (Kernel)&simd::nearestScalar;
+        }
+    }();
+
+    // 太短的陣列不值得進向量路徑
+    if (count < 8) {
+        return simd::nearestScalar(origin, xs, ys, count, rangeSq);
+    }
+    return kernel(origin, xs, ys, count, rangeSq);
+}
+
+} // namespace PL
@@ -0,0 +1,40 @@
+// ============================================
+// Plant Legends - 批次距離核心（SIMD）
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+
+namespace PL {
+
+// 最近點查詢結果；找不到時 index = kInvalidIndex
+struct NearestResult {
+    u32 index = kInvalidIndex;
+    f32 distSq = 0.0f;
+};
+
+// 一個原點對上緊密排列的 x / y 欄位，回傳距離平方 < rangeSq 的最近點。
+// 距離相同時取較小的索引，各實作結果逐位元一致。
+// x86 上依 CPU 在 AVX2 / SSE2 之間選擇，其他平台使用純量版本。
+NearestResult nearestInRange(const Vec2& origin, const f32* xs, const f32* ys, u32 count, f32 rangeSq);
+
+// 個別實作（基準測試與測試用；不支援的平台回退到純量）
+namespace simd {
+
+enum class Level : u8 {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+Level detectLevel();
+const char* levelName(Level level);
+
+NearestResult nearestScalar(const Vec2& origin, const f32* xs, const f32* ys, u32 count, f32 rangeSq);
+NearestResult nearestSSE2(const Vec2& origin, const f32* xs, const f32* ys, u32 count, f32 rangeSq);
+NearestResult nearestAVX2(const Vec2& origin, const f32* xs, const f32* ys, u32 count, f32 rangeSq);
+
+} // namespace simd
+
+} // namespace PL
@@ -0,0 +1,192 @@
+// ============================================
+// Plant Legends - Spatial Hash Implementation
+// ============================================
+
+#include "core/spatial_hash.hpp"
+#include "core/simd_distance.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace PL {
+
+void SpatialHash::configure(f32 ox, f32 oy, f32 width, f32 height, f32 size) {
+    originX = ox;
+    originY = oy;
+    cellSize = size;
+    invCellSize = 1.0f / size;
+    cols = std::max(1, (i32)std::ceil(width * invCellSize));
+    rows = std::max(1, (i32)std::ceil(height * invCellSize));
+
+    cellStart.assign(cols * rows + 1, 0);
+    ids.clear();
+    px.clear();
+    py.clear();
+}
+
+i32 SpatialHash::clampCol(f32 x) const {
+    i32 c = (i32)std::floor((x - originX) * invCellSize);
+    return std::clamp(c, 0, cols - 1);
+}
+
+i32 SpatialHash::clampRow(f32 y) const {
+    i32 r = (i32)std::floor((y - originY) * invCellSize);
+    return std::clamp(r, 0, rows - 1);
+}
+
+u32 SpatialHash::cellOf(f32 x, f32 y) const {
+    return (u32)(clampRow(y) * cols + clampCol(x));
+}
+
+void SpatialHash::cellBounds(f32 minX, f32 minY, f32 maxX, f32 maxY,
+                             i32& c0, i32& r0, i32& c1, i32& r1) const {
+    c0 = clampCol(minX);
+    r0 = clampRow(minY);
+    c1 = clampCol(maxX);
+    r1 = clampRow(maxY);
+}
+
+u32 SpatialHash::countInCells(f32 minX, f32 minY, f32 maxX, f32 maxY) const {
+    if (cols == 0) return 0;
+
+    i32 c0, r0, c1, r1;
+    cellBounds(minX, minY, maxX, maxY, c0, r0, c1, r1);
+
+    u32 total = 0;
+    for (i32 r = r0; r <= r1; r++) {
+        total += cellStart[r * cols + c1 + 1] - cellStart[r * cols + c0];
+    }
+    return total;
+}
+
+void SpatialHash::build(const f32* xs, const f32* ys, const u8* alive, u32 count) {
+    const u32 cellCount = (u32)(cols * rows);
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    if (itemCell.size() < count) {
+        itemCell.resize(count);
+    }
+
+    // 第一遍：計數
+    u32 total = 0;
+    for (u32 i = 0; i < count; i++) {
+        if (!alive[i]) {
+            itemCell[i] = kInvalidIndex;
+            continue;
+        }
+        u32 cell = cellOf(xs[i], ys[i]);
+        itemCell[i] = cell;
+        cellStart[cell + 1]++;
+        total++;
+    }
+
+    // 前綴和
+    for (u32 c = 0; c < cellCount; c++) {
+        cellStart[c + 1] += cellStart[c];
+    }
+
+    // 第二遍：分配（cellStart[c] 暫作寫入游標，之後再還原）
+    ids.resize(total);
+    px.resize(total);
+    py.resize(total);
+    for (u32 i = 0; i < count; i++) {
+        u32 cell = itemCell[i];
+        if (cell == kInvalidIndex) continue;
+        u32 slot = cellStart[cell]++;
+        ids[slot] = i;
+        px[slot] = xs[i];
+        py[slot] = ys[i];
+    }
+    for (u32 c = cellCount; c > 0; c--) {
+        cellStart[c] = cellStart[c - 1];
+    }
+    cellStart[0] = 0;
+}
+
+u32 SpatialHash::nearest(const Vec2& center, f32 maxRadius, f32* outDistSq) const {
+    if (cols == 0) return kInvalidIndex;
+
+    i32 c0, r0, c1, r1;
+    cellBounds(center.x - maxRadius, center.y - maxRadius, center.x + maxRadius, center.y + maxRadius, c0, r0, c1, r1);
+
+    u32 bestId = kInvalidIndex;
+    f32 bestSq = maxRadius * maxRadius;
+    for (i32 r = r0; r <= r1; r++) {
+        const u32 begin = cellStart[r * cols + c0];
+        const u32 end = cellStart[r * cols + c1 + 1];
+        if (begin == end) continue;
+
+        NearestResult hit = nearestInRange(center, px.data() + begin, py.data() + begin, end - begin, bestSq);
+        if (hit.index != kInvalidIndex) {
+            bestSq = hit.distSq;
+            bestId = ids[begin + hit.index];
+        }
+    }
+
+    if (outDistSq && bestId != kInvalidIndex) {
+        *outDistSq = bestSq;
+    }
+    return bestId;
+}
+
+u32 SpatialHash::kNearest(const Vec2& center, u32 k, f32 maxRadius, u32* outIds, f32* outDistSq) const {
+    if (cols == 0 || k == 0) return 0;
+
+    const i32 cc = clampCol(center.x);
+    const i32 cr = clampRow(center.y);
+    const i32 maxRing = std::max(std::max(cc, cols - 1 - cc), std::max(cr, rows - 1 - cr));
+    f32 limitSq = maxRadius * maxRadius;
+    u32 found = 0;
+
+    // 插入排序維持前 k 名
+    auto consider = [&](u32 slot) {
+        f32 dx = px[slot] - center.x;
+        f32 dy = py[slot] - center.y;
+        f32 distSq = dx * dx + dy * dy;
+        if (distSq > limitSq) return;
+        if (found == k && distSq >= outDistSq[k - 1]) return;
+
+        u32 pos = found < k ? found++ : k - 1;
+        while (pos > 0 && outDistSq[pos - 1] > distSq) {
+            outDistSq[pos] = outDistSq[pos - 1];
+            outIds[pos] = outIds[pos - 1];
+            pos--;
+        }
+        outDistSq[pos] = distSq;
+        outIds[pos] = ids[slot];
+    };
+
+    // 由內向外逐圈搜尋
+    for (i32 ring = 0; ring <= maxRing; ring++) {
+        const i32 c0 = cc - ring;
+        const i32 c1 = cc + ring;
+        const i32 r0 = cr - ring;
+        const i32 r1 = cr + ring;
+
+        for (i32 r = std::max(r0, 0); r <= std::min(r1, rows - 1); r++) {
+            const bool edgeRow = (r == r0 || r == r1);
+            for (i32 c = std::max(c0, 0); c <= std::min(c1, cols - 1); c++) {
+                // 只處理本圈外框上的桶
+                if (!edgeRow && c != c0 && c != c1) continue;
+                const u32 cell = (u32)(r * cols + c);
+                for (u32 i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                    consider(i);
+                }
+            }
+        }
+
+        // 尚未搜尋的桶與中心的最短距離
+        f32 left = center.x - (originX + c0 * cellSize);
+        f32 right = (originX + (c1 + 1) * cellSize) - center.x;
+        f32 top = center.y - (originY + r0 * cellSize);
+        f32 bottom = (originY + (r1 + 1) * cellSize) - center.y;
+        f32 bound = std::min(std::min(left, right), std::min(top, bottom));
+        if (bound <= 0.0f) continue;
+
+        f32 boundSq = bound * bound;
+        if (boundSq > limitSq) break;
+        if (found == k && outDistSq[k - 1] <= boundSq) break;
+    }
+
+    return found;
+}
+
+} // namespace PL
@@ -0,0 +1,121 @@
+// ============================================
+// Plant Legends - 均勻網格空間雜湊
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include <vector>
+
+namespace PL {
+
+// 覆蓋戰場的均勻桶狀網格，每 tick 以計數排序重建。
+// 每個桶內的 id 與座標連續存放，查詢時只讀相鄰記憶體；
+// 重建與查詢在容量足夠後都不會配置記憶體。
+// 超出範圍的點會被夾到邊界桶，查詢結果仍以精確距離過濾。
+class SpatialHash {
+public:
+    // 設定覆蓋區域與桶大小
+    void configure(f32 originX, f32 originY, f32 width, f32 height, f32 cellSize);
+
+    // 以 SoA 欄位重建（alive 為 0 的項目略過，id = 陣列索引）
+    void build(const f32* xs, const f32* ys, const u8* alive, u32 count);
+
+    u32 size() const { return (u32)ids.size(); }
+    i32 getCols() const { return cols; }
+    i32 getRows() const { return rows; }
+    f32 getCellSize() const { return cellSize; }
+    u32 getCellCount() const { return (u32)(cols * rows); }
+
+    // 點所在的桶（夾在範圍內）
+    u32 cellOf(f32 x, f32 y) const;
+
+    // 矩形覆蓋的桶範圍（含端點，夾在範圍內）
+    void cellBounds(f32 minX, f32 minY, f32 maxX, f32 maxY, i32& c0, i32& r0, i32& c1, i32& r1) const;
+
+    // 矩形覆蓋的桶內項目總數（只數桶，不檢查座標）
+    u32 countInCells(f32 minX, f32 minY, f32 maxX, f32 maxY) const;
+
+    // 對半徑內的每個 id 呼叫 fn(id, distSq)
+    template<typename Fn>
+    void forEachInRadius(const Vec2& center, f32 radius, Fn&& fn) const;
+
+    // 對矩形內的每個 id 呼叫 fn(id)
+    template<typename Fn>
+    void forEachInRect(f32 minX, f32 minY, f32 maxX, f32 maxY, Fn&& fn) const;
+
+    // 距離 < maxRadius 的最近一個，找不到回傳 kInvalidIndex
+    // 每一行覆蓋到的桶在記憶體中連續，整段交給 SIMD 距離核心
+    u32 nearest(const Vec2& center, f32 maxRadius, f32* outDistSq = nullptr) const;
+
+    // 半徑內最近的 k 個，依距離排序寫入 outIds / outDistSq，回傳數量
+    u32 kNearest(const Vec2& center, u32 k, f32 maxRadius, u32* outIds, f32* outDistSq) const;
+
+private:
+    f32 originX = 0.0f;
+    f32 originY = 0.0f;
+    f32 cellSize = 100.0f;
+    f32 invCellSize = 0.01f;
+    i32 cols = 0;
+    i32 rows = 0;
+
+    std::vector<u32> cellStart;  // 大小 cols * rows + 1
+    std::vector<u32> ids;        // 依桶排序
+    std::vector<f32> px;         // 與 ids 對齊的座標
+    std::vector<f32> py;
+    std::vector<u32> itemCell;   // 建置暫存
+
+    i32 clampCol(f32 x) const;
+    i32 clampRow(f32 y) const;
+};
+
+// ============================================
+// Template implementations
+// ============================================
+
+template<typename Fn>
+void SpatialHash::forEachInRadius(const Vec2& center, f32 radius, Fn&& fn) const {
+    if (cols == 0) return;
+
+    const f32 radiusSq = radius * radius;
+    const i32 c0 = clampCol(center.x - radius);
+    const i32 c1 = clampCol(center.x + radius);
+    const i32 r0 = clampRow(center.y - radius);
+    const i32 r1 = clampRow(center.y + radius);
+
+    for (i32 r = r0; r <= r1; r++) {
+        // 同一行的桶在 ids 中是連續的
+        const u32 begin = cellStart[r * cols + c0];
+        const u32 end = cellStart[r * cols + c1 + 1];
+        for (u32 i = begin; i < end; i++) {
+            f32 dx = px[i] - center.x;
+            f32 dy = py[i] - center.y;
+            f32 distSq = dx * dx + dy * dy;
+            if (distSq <= radiusSq) {
+                fn(ids[i], distSq);
+            }
+        }
+    }
+}
+
+template<typename Fn>
+void SpatialHash::forEachInRect(f32 minX, f32 minY, f32 maxX, f32 maxY, Fn&& fn) const {
+    if (cols == 0) return;
+
+    const i32 c0 = clampCol(minX);
+    const i32 c1 = clampCol(maxX);
+    const i32 r0 = clampRow(minY);
+    const i32 r1 = clampRow(maxY);
+
+    for (i32 r = r0; r <= r1; r++) {
+        const u32 begin = cellStart[r * cols + c0];
+        const u32 end = cellStart[r * cols + c1 + 1];
+        for (u32 i = begin; i < end; i++) {
+            if (px[i] >= minX && px[i] <= maxX && py[i] >= minY && py[i] <= maxY) {
+                fn(ids[i]);
+            }
+        }
+    }
+}
+
+} // namespace PL
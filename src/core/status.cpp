@@ -0,0 +1,72 @@
+// ============================================
+// Plant Legends - Status Set Implementation
+// ============================================
+
+#include "core/status.hpp"
+#include <algorithm>
+
+namespace PL {
+
+void StatusSet::add(const StatusEffect& effect, u8 maxStacks) {
+    if (effect.type == StatusType::None) return;
+    
+    StatusEffect& slot = slots[slotOf(effect.type)];
+    
+    if (!has(effect.type)) {
+        slot = effect;
+        slot.timer = 0.0f;
+        slot.stacks = 1;
+        mask |= bit(effect.type);
+        return;
+    }
+    
+    // 已存在：刷新持續時間，強度取較大者
+    slot.duration = std::max(slot.remaining(), effect.duration);
+    slot.timer = 0.0f;
+    slot.value = std::max(slot.value, effect.value);
+    
+    if (slot.stacks < maxStacks) {
+        slot.stacks++;
+    }
+}
+
+void StatusSet::update(f32 dt) {
+    u8 bits = mask;
+    while (bits) {
+        u32 index = 0;
+        while (!(bits & (1u << index))) index++;
+        bits &= (u8)~(1u << index);
+        
+        StatusEffect& slot = slots[index];
+        slot.timer += dt;
+        
+        // 移除已結束的效果
+        if (!slot.active()) {
+            mask &= (u8)~(1u << index);
+        }
+    }
+}
+
+f32 StatusSet::damagePerSecond() const {
+    f32 dps = 0.0f;
+    if (has(StatusType::Burn)) {
+        dps += get(StatusType::Burn).value;
+    }
+    if (has(StatusType::Poison)) {
+        const StatusEffect& poison = get(StatusType::Poison);
+        dps += poison.value * poison.stacks;
+    }
+    return dps;
+}
+
+f32 StatusSet::speedMultiplier() const {
+    if (has(StatusType::Freeze) || has(StatusType::Stun)) {
+        return 0.0f;
+    }
+    if (has(StatusType::Slow)) {
+        return std::clamp(1.0f - get(StatusType::Slow).value, 0.0f, 1.0f);
+    }
+    return 1.0f;
+}
+
+} // namespace PL
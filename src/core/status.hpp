@@ -0,0 +1,49 @@
+// ============================================
+// Plant Legends - 狀態效果集合
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+
+namespace PL {
+
+// 每種狀態一個固定槽位，加上一個啟用位元遮罩：
+// 查詢是 O(1) 的位元測試，沒有任何堆積配置。
+// 同類效果重複施加時刷新持續時間；中毒可疊加至 maxStacks 層。
+class StatusSet {
+public:
+    static constexpr u32 kSlotCount = 5;  // Burn, Slow, Freeze, Poison, Stun
+    
+    static constexpr u8 bit(StatusType type) {
+        return type == StatusType::None ? 0 : (u8)(1u << ((u32)type - 1));
+    }
+    
+    void add(const StatusEffect& effect, u8 maxStacks = 1);
+    void update(f32 dt);
+    void clear() { mask = 0; }
+    
+    bool has(StatusType type) const { return (mask & bit(type)) != 0; }
+    bool any() const { return mask != 0; }
+    u8 getMask() const { return mask; }
+    
+    // 僅在 has(type) 時有意義
+    const StatusEffect& get(StatusType type) const { return slots[slotOf(type)]; }
+    
+    // 燃燒 + 中毒（每層）的每秒傷害
+    f32 damagePerSecond() const;
+    
+    // 移動速度倍率：凍結/暈眩為 0，減速依 value 扣除
+    f32 speedMultiplier() const;
+    
+    // 暈眩時不能攻擊
+    bool canAct() const { return !has(StatusType::Stun); }
+    
+private:
+    static u32 slotOf(StatusType type) { return (u32)type - 1; }
+    
+    StatusEffect slots[kSlotCount];
+    u8 mask = 0;
+};
+
+} // namespace PL
@@ -0,0 +1,50 @@
+// ============================================
+// Plant Legends - Symbol Table Implementation
+// ============================================
+
+#include "core/symbol.hpp"
+
+namespace PL {
+
+SymbolTable& SymbolTable::instance() {
+    static SymbolTable table;
+    return table;
+}
+
+SymbolTable::SymbolTable() {
+    strings.emplace_back();  // kNoSymbol
+    index.emplace(strings.back(), kNoSymbol);
+}
+
+Symbol SymbolTable::intern(std::string_view str) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    auto it = index.find(str);
+    if (it != index.end()) {
+        return it->second;
+    }
+    
+    Symbol sym = (Symbol)strings.size();
+    strings.emplace_back(str);
+    index.emplace(strings.back(), sym);
+    return sym;
+}
+
+Symbol SymbolTable::find(std::string_view str) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    auto it = index.find(str);
+    return it != index.end() ? it->second : kNoSymbol;
+}
+
+const std::string& SymbolTable::str(Symbol sym) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sym < strings.size() ? strings[sym] : strings[kNoSymbol];
+}
+
+u32 SymbolTable::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (u32)strings.size();
+}
+
+} // namespace PL
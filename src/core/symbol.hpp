@@ -0,0 +1,50 @@
+// ============================================
+// Plant Legends - 字串符號表（interner）
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace PL {
+
+// 符號：植物/敵人/關卡等字串 ID 的整數代號。
+// 同一字串永遠得到同一符號，比較與查表都是整數運算。
+// 0 保留給空字串（kNoSymbol）。
+using Symbol = u32;
+constexpr Symbol kNoSymbol = 0;
+
+// 全域符號表。字串只在載入時 intern 一次，之後實體與設定只帶符號。
+// intern / find 會加鎖（載入可能在工作執行緒進行），熱路徑不應呼叫。
+class SymbolTable {
+public:
+    static SymbolTable& instance();
+    
+    // 取得字串的符號，第一次出現時登記
+    Symbol intern(std::string_view str);
+    
+    // 只查不登記，找不到回傳 kNoSymbol
+    Symbol find(std::string_view str) const;
+    
+    // 符號對應的字串（無效符號回傳空字串）
+    const std::string& str(Symbol sym) const;
+    
+    u32 size() const;
+    
+private:
+    SymbolTable();
+    
+    mutable std::mutex mutex;
+    std::deque<std::string> strings;                      // deque 擴充時元素不搬移，索引鍵可指向它
+    std::unordered_map<std::string_view, Symbol> index;
+};
+
+inline Symbol intern(std::string_view str) { return SymbolTable::instance().intern(str); }
+inline const char* symbolName(Symbol sym) { return SymbolTable::instance().str(sym).c_str(); }
+
+} // namespace PL
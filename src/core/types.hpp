@@ -71,8 +71,11 @@ struct GridCoord {
     }
 };
 
+// 無效索引
+constexpr u32 kInvalidIndex = 0xFFFFFFFFu;
+
 // 稀有度
-enum class Rarity {
+enum class Rarity : u8 {
     Common,
     Rare,
     Epic,
@@ -80,7 +83,7 @@ enum class Rarity {
 };
 
 // 元素類型
-enum class Element {
+enum class Element : u8 {
     None,
     Fire,
     Ice,
@@ -88,8 +91,24 @@ enum class Element {
     Poison
 };
 
+// 敵人行為類型
+enum class EnemyBehavior : u8 {
+    Walker,      // 直線前進
+    Flyer,       // 飛行
+    Phasing,     // 可穿透植物
+    Charger      // 衝鋒
+};
+
+// 格子圖層（同一格可同時有多株植物）
+enum class GridLayer : u8 {
+    Ground,      // 一般植物
+    Overlay,     // 南瓜罩 / 護甲，疊在地面植物上
+    Flyer,       // 空中格位
+    Count
+};
+
 // 狀態效果類型
-enum class StatusType {
+enum class StatusType : u8 {
     None,
     Burn,      // 燃燒
     Slow,      // 減速
@@ -102,8 +121,9 @@ enum class StatusType {
 struct StatusEffect {
     StatusType type = StatusType::None;
     f32 duration = 0.0f;
-    f32 value = 0.0f;  // 傷害/減速百分比等
+    f32 value = 0.0f;  // 每秒傷害（每層）/減速百分比等
     f32 timer = 0.0f;
+    u8 stacks = 1;     // 疊加層數（中毒）
     
     StatusEffect() = default;
     StatusEffect(StatusType type, f32 duration, f32 value)
@@ -142,14 +162,12 @@ enum class EntityType {
 class Entity;
 class Plant;
 class Enemy;
-class Projectile;
 class Game;
 
 // 實體指標
 using EntityPtr = std::shared_ptr<Entity>;
 using PlantPtr = std::shared_ptr<Plant>;
 using EnemyPtr = std::shared_ptr<Enemy>;
-using ProjectilePtr = std::shared_ptr<Projectile>;
 
 // 回調函數類型
 using OnDeathCallback = std::function<void()>;
@@ -0,0 +1,102 @@
+// ============================================
+// Plant Legends - 工作竊取執行緒池
+// ============================================
+
+#include "core/work_pool.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace PL {
+
+WorkStealingPool::WorkStealingPool(u32 count) {
+    threadCount = count > 0 ? count : std::max(1u, std::thread::hardware_concurrency());
+}
+
+u64 WorkStealingPool::run(u32 jobCount, const Job& job, const StartHook& onStart, const ExitHook& onExit) {
+    // 執行緒數不超過工作數
+    const u32 workers = std::max(1u, std::min(threadCount, jobCount));
+    queueCount = workers;
+    queues.reset(new Queue[workers]);
+    for (u32 w = 0; w < workers; w++) {
+        const u32 begin = (u32)((u64)jobCount * w / workers);
+        const u32 end = (u32)((u64)jobCount * (w + 1) / workers);
+        for (u32 j = begin; j < end; j++) {
+            queues[w].jobs.push_back(j);
+        }
+    }
+    executed.store(0, std::memory_order_relaxed);
+    steals.store(0, std::memory_order_relaxed);
+    failedWorkers.store(0, std::memory_order_relaxed);
+    
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+    for (u32 w = 0; w < workers; w++) {
+        threads.emplace_back([this, w, &job, &onStart, &onExit] { workerMain(w, job, onStart, onExit); });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    
+    stats.executed = executed.load(std::memory_order_relaxed);
+    stats.steals = steals.load(std::memory_order_relaxed);
+    stats.failedWorkers = failedWorkers.load(std::memory_order_relaxed);
+    queues.reset();
+    return stats.executed;
+}
+
+void WorkStealingPool::workerMain(u32 worker, const Job& job, const StartHook& onStart, const ExitHook& onExit) {
+    if (onStart && !onStart(worker)) {
+        failedWorkers.fetch_add(1, std::memory_order_relaxed);
+        if (onExit) onExit(worker);
+        return;
+    }
+    
+    // 工作在開始前就全部分配完，其他佇列也都空了就代表沒有工作
+    u32 index;
+    while (true) {
+        if (pop(worker, index)) {
+            job(worker, index);
+            executed.fetch_add(1, std::memory_order_relaxed);
+        } else if (!steal(worker)) {
+            break;
+        }
+    }
+    
+    if (onExit) onExit(worker);
+}
+
+bool WorkStealingPool::pop(u32 worker, u32& job) {
+    Queue& q = queues[worker];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.jobs.empty()) return false;
+    job = q.jobs.front();
+    q.jobs.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(u32 worker) {
+    // 一次只持有一把鎖：先從對方後端搬出，再放進自己的佇列
+    u32 taken[kMaxSteal];
+    for (u32 k = 1; k < queueCount; k++) {
+        Queue& victim = queues[(worker + k) % queueCount];
+        u32 count = 0;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            const size_t n = victim.jobs.size();
+            if (n == 0) continue;
+            count = (u32)std::min<size_t>((n + 1) / 2, kMaxSteal);
+            std::copy(victim.jobs.end() - count, victim.jobs.end(), taken);
+            victim.jobs.erase(victim.jobs.end() - count, victim.jobs.end());
+        }
+        
+        Queue& own = queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.jobs.insert(own.jobs.end(), taken, taken + count);
+        steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+} // namespace PL
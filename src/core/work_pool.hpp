@@ -0,0 +1,62 @@
+// ============================================
+// Plant Legends - 工作竊取執行緒池
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace PL {
+
+struct WorkPoolStats {
+    u64 executed = 0;       // 完成的工作數
+    u64 steals = 0;         // 成功竊取的次數（每次搬走對方一半）
+    u32 failedWorkers = 0;  // onStart 回傳 false 而退出的工作執行緒
+};
+
+// 固定數量的獨立工作 [0, jobCount)。
+// 工作先依序切成連續區段分給各執行緒，自己的佇列從前端取；
+// 做完後從其他執行緒的佇列後端搬走一半。耗時不均（例如有的模擬提早結束）時不會有執行緒閒置。
+// 每次 run() 都建立新的執行緒，onStart / onExit 在工作執行緒上呼叫，
+// 可用來建立每執行緒一份的狀態（Lua 狀態、遊戲實例）。
+class WorkStealingPool {
+public:
+    using Job = std::function<void(u32 worker, u32 job)>;
+    using StartHook = std::function<bool(u32 worker)>;  // 回傳 false：此執行緒不接工作，它的工作由其他執行緒竊取
+    using ExitHook = std::function<void(u32 worker)>;
+    
+    explicit WorkStealingPool(u32 threadCount = 0);  // 0 = 硬體執行緒數
+    
+    // 阻塞到所有工作完成（或所有執行緒都初始化失敗），回傳完成的工作數
+    u64 run(u32 jobCount, const Job& job, const StartHook& onStart = nullptr, const ExitHook& onExit = nullptr);
+    
+    u32 getThreadCount() const { return threadCount; }
+    const WorkPoolStats& getStats() const { return stats; }
+    
+private:
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<u32> jobs;
+    };
+    
+    bool pop(u32 worker, u32& job);
+    bool steal(u32 worker);
+    void workerMain(u32 worker, const Job& job, const StartHook& onStart, const ExitHook& onExit);
+    
+    static constexpr u32 kMaxSteal = 256;  // 單次竊取上限
+    
+    u32 threadCount = 1;
+    u32 queueCount = 0;
+    std::unique_ptr<Queue[]> queues;
+    std::atomic<u64> executed{0};
+    std::atomic<u64> steals{0};
+    std::atomic<u32> failedWorkers{0};
+    WorkPoolStats stats;
+};
+
+} // namespace PL
@@ -0,0 +1,365 @@
+// ============================================
+// Plant Legends - Archetype Registry Implementation
+// ============================================
+
+#include "game/archetype.hpp"
+#include "game/data_pack.hpp"
+#include "core/log.hpp"
+#include <algorithm>
+
+extern "C" {
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+
+namespace PL {
+
+namespace {
+
+// 讀取表（位於棧頂）中的數字欄位
+void readNumber(lua_State* L, const char* field, f32& out) {
+    lua_getfield(L, -1, field);
+    if (lua_isnumber(L, -1)) {
+        out = (f32)lua_tonumber(L, -1);
+    }
+    lua_pop(L, 1);
+}
+
+void readString(lua_State* L, const char* field, std::string& out) {
+    lua_getfield(L, -1, field);
+    if (lua_isstring(L, -1)) {
+        out = lua_tostring(L, -1);
+    }
+    lua_pop(L, 1);
+}
+
+void readSymbol(lua_State* L, const char* field, Symbol& out) {
+    lua_getfield(L, -1, field);
+    if (lua_isstring(L, -1)) {
+        out = intern(lua_tostring(L, -1));
+    }
+    lua_pop(L, 1);
+}
+
+// 全域表中所有以字串為鍵的子表，依鍵排序
+std::vector<std::string> sortedKeys(lua_State* L) {
+    std::vector<std::string> keys;
+    lua_pushnil(L);
+    while (lua_next(L, -2) != 0) {
+        if (lua_type(L, -2) == LUA_TSTRING && lua_istable(L, -1)) {
+            keys.emplace_back(lua_tostring(L, -2));
+        }
+        lua_pop(L, 1);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+Rarity parseRarity(const std::string& str) {
+    if (str == "rare") return Rarity::Rare;
+    if (str == "epic") return Rarity::Epic;
+    if (str == "legendary") return Rarity::Legendary;
+    return Rarity::Common;
+}
+
+Element parseElement(const std::string& str) {
+    if (str == "fire") return Element::Fire;
+    if (str == "ice") return Element::Ice;
+    if (str == "lightning") return Element::Lightning;
+    if (str == "poison") return Element::Poison;
+    return Element::None;
+}
+
+GridLayer parseLayer(const std::string& str) {
+    if (str == "overlay") return GridLayer::Overlay;
+    if (str == "flyer") return GridLayer::Flyer;
+    return GridLayer::Ground;
+}
+
+EnemyBehavior parseBehavior(const std::string& str) {
+    if (str == "flyer") return EnemyBehavior::Flyer;
+    if (str == "phasing") return EnemyBehavior::Phasing;
+    if (str == "charger") return EnemyBehavior::Charger;
+    return EnemyBehavior::Walker;
+}
+
+void readPlant(lua_State* L, PlantArchetype& plant, Symbol& evolvesTo) {
+    readSymbol(L, "name", plant.name);
+    
+    f32 cost = (f32)plant.cost;
+    readNumber(L, "cost", cost);
+    plant.cost = (i32)cost;
+    readNumber(L, "cooldown", plant.cooldown);
+    
+    std::string str;
+    readString(L, "rarity", str);
+    plant.rarity = parseRarity(str);
+    str.clear();
+    readString(L, "element", str);
+    plant.element = parseElement(str);
+    str.clear();
+    readString(L, "layer", str);
+    plant.layer = parseLayer(str);
+    
+    lua_getfield(L, -1, "stats");
+    if (lua_istable(L, -1)) {
+        readNumber(L, "hp", plant.stats.hp);
+        plant.stats.maxHp = plant.stats.hp;
+        readNumber(L, "damage", plant.stats.damage);
+        readNumber(L, "attack_speed", plant.stats.attackSpeed);
+        readNumber(L, "range", plant.stats.range);
+        readNumber(L, "crit_rate", plant.stats.critRate);
+        readNumber(L, "crit_mult", plant.stats.critMult);
+        readNumber(L, "armor", plant.stats.armor);
+    }
+    lua_pop(L, 1);  // pop stats
+    
+    lua_getfield(L, -1, "evolution");
+    if (lua_istable(L, -1)) {
+        readSymbol(L, "evolves_to", evolvesTo);
+    }
+    lua_pop(L, 1);  // pop evolution
+}
+
+void readEnemy(lua_State* L, EnemyArchetype& enemy) {
+    readSymbol(L, "name", enemy.name);
+    
+    lua_getfield(L, -1, "behavior");
+    if (lua_istable(L, -1)) {
+        std::string type;
+        readString(L, "type", type);
+        enemy.behavior = parseBehavior(type);
+    }
+    lua_pop(L, 1);  // pop behavior
+    
+    lua_getfield(L, -1, "stats");
+    if (lua_istable(L, -1)) {
+        readNumber(L, "hp", enemy.stats.hp);
+        enemy.stats.maxHp = enemy.stats.hp;
+        readNumber(L, "damage", enemy.stats.damage);
+        readNumber(L, "speed", enemy.stats.speed);
+        readNumber(L, "armor", enemy.stats.armor);
+    }
+    lua_pop(L, 1);  // pop stats
+}
+
+bool sameStats(const Stats& a, const Stats& b) {
+    return a.hp == b.hp && a.maxHp == b.maxHp && a.damage == b.damage &&
+           a.attackSpeed == b.attackSpeed && a.range == b.range && a.speed == b.speed &&
+           a.critRate == b.critRate && a.critMult == b.critMult && a.armor == b.armor;
+}
+
+// 進化目標另外解析，不列入比較
+bool samePlant(const PlantArchetype& a, const PlantArchetype& b) {
+    return sameStats(a.stats, b.stats) && a.cost == b.cost && a.cooldown == b.cooldown &&
+           a.rarity == b.rarity && a.element == b.element && a.layer == b.layer && a.name == b.name;
+}
+
+bool sameEnemy(const EnemyArchetype& a, const EnemyArchetype& b) {
+    return sameStats(a.stats, b.stats) && a.behavior == b.behavior && a.name == b.name;
+}
+
+} // namespace
+
+ArchetypeRegistry& ArchetypeRegistry::instance() {
+    thread_local ArchetypeRegistry registry;
+    return registry;
+}
+
+void ArchetypeRegistry::clear() {
+    plants.clear();
+    enemies.clear();
+    plantBySymbol.clear();
+    enemyBySymbol.clear();
+}
+
+void ArchetypeRegistry::indexBySymbol(std::vector<ArchetypeId>& table, Symbol sym, ArchetypeId id) {
+    if (sym >= table.size()) {
+        table.resize(sym + 1, kInvalidArchetype);
+    }
+    table[sym] = id;
+}
+
+bool ArchetypeRegistry::build(lua_State* L) {
+    clear();
+    bool ok = true;
+    
+    // 植物
+    lua_getglobal(L, "plants");
+    if (lua_istable(L, -1)) {
+        std::vector<std::string> keys = sortedKeys(L);
+        std::vector<Symbol> evolvesTo(keys.size(), kNoSymbol);
+        plants.resize(keys.size());
+        
+        for (u32 i = 0; i < keys.size(); i++) {
+            plants[i].id = intern(keys[i]);
+            indexBySymbol(plantBySymbol, plants[i].id, (ArchetypeId)i);
+            
+            lua_getfield(L, -1, keys[i].c_str());
+            readPlant(L, plants[i], evolvesTo[i]);
+            lua_pop(L, 1);
+        }
+        
+        // 進化目標在全部讀完後才能解析成 ID
+        for (u32 i = 0; i < keys.size(); i++) {
+            if (evolvesTo[i] != kNoSymbol) {
+                plants[i].evolvesTo = findPlant(evolvesTo[i]);
+            }
+        }
+    } else {
+        PL_LOG_ERROR(Lua, "plants table not found");
+        ok = false;
+    }
+    lua_pop(L, 1);  // pop plants
+    
+    // 敵人
+    lua_getglobal(L, "enemies");
+    if (lua_istable(L, -1)) {
+        std::vector<std::string> keys = sortedKeys(L);
+        enemies.resize(keys.size());
+        
+        for (u32 i = 0; i < keys.size(); i++) {
+            enemies[i].id = intern(keys[i]);
+            indexBySymbol(enemyBySymbol, enemies[i].id, (ArchetypeId)i);
+            
+            lua_getfield(L, -1, keys[i].c_str());
+            readEnemy(L, enemies[i]);
+            lua_pop(L, 1);
+        }
+    } else {
+        PL_LOG_ERROR(Lua, "enemies table not found");
+        ok = false;
+    }
+    lua_pop(L, 1);  // pop enemies
+    
+    PL_LOG_INFO(Lua, "Archetypes: %u plants, %u enemies", getPlantCount(), getEnemyCount());
+    return ok;
+}
+
+u32 ArchetypeRegistry::reloadPlants(lua_State* L, std::vector<ArchetypeId>& changed) {
+    lua_getglobal(L, "plants");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        return 0;
+    }
+    
+    std::vector<std::string> keys = sortedKeys(L);
+    std::vector<std::pair<ArchetypeId, Symbol>> evolvesTo;
+    u32 added = 0;
+    
+    for (const std::string& key : keys) {
+        PlantArchetype fresh;
+        fresh.id = intern(key);
+        Symbol evolves = kNoSymbol;
+        lua_getfield(L, -1, key.c_str());
+        readPlant(L, fresh, evolves);
+        lua_pop(L, 1);
+        
+        ArchetypeId id = findPlant(fresh.id);
+        if (id == kInvalidArchetype) {
+            if (plants.size() >= kInvalidArchetype) continue;
+            id = (ArchetypeId)plants.size();
+            plants.push_back(fresh);
+            indexBySymbol(plantBySymbol, fresh.id, id);
+            added++;
+        } else {
+            PlantArchetype& current = plants[id];
+            
+            // 圖層決定植物在網格中的位置，存活的植物無法搬移
+            if (fresh.layer != current.layer) {
+                PL_LOG_WARN(Lua, "%s: layer change needs a restart", key.c_str());
+                fresh.layer = current.layer;
+            }
+            if (!samePlant(current, fresh)) {
+                fresh.hooks = current.hooks;
+                fresh.evolvesTo = current.evolvesTo;
+                current = fresh;
+                changed.push_back(id);
+            }
+        }
+        evolvesTo.emplace_back(id, evolves);
+    }
+    lua_pop(L, 1);  // pop plants
+    
+    for (const auto& [id, target] : evolvesTo) {
+        plants[id].evolvesTo = target != kNoSymbol ? findPlant(target) : kInvalidArchetype;
+    }
+    return added;
+}
+
+u32 ArchetypeRegistry::reloadEnemies(lua_State* L, std::vector<ArchetypeId>& changed) {
+    lua_getglobal(L, "enemies");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        return 0;
+    }
+    
+    std::vector<std::string> keys = sortedKeys(L);
+    u32 added = 0;
+    
+    for (const std::string& key : keys) {
+        EnemyArchetype fresh;
+        fresh.id = intern(key);
+        lua_getfield(L, -1, key.c_str());
+        readEnemy(L, fresh);
+        lua_pop(L, 1);
+        
+        ArchetypeId id = findEnemy(fresh.id);
+        if (id == kInvalidArchetype) {
+            if (enemies.size() >= kInvalidArchetype) continue;
+            enemies.push_back(fresh);
+            indexBySymbol(enemyBySymbol, fresh.id, (ArchetypeId)(enemies.size() - 1));
+            added++;
+        } else if (!sameEnemy(enemies[id], fresh)) {
+            fresh.hooks = enemies[id].hooks;
+            enemies[id] = fresh;
+            changed.push_back(id);
+        }
+    }
+    lua_pop(L, 1);  // pop enemies
+    
+    return added;
+}
+
+bool ArchetypeRegistry::build(const DataPack& pack) {
+    clear();
+    if (!pack.isOpen()) return false;
+    
+    // 烘焙時已依 id 排序，ID 與從 Lua 建立時一致
+    const PackPlant* srcPlants = pack.plants();
+    plants.resize(pack.getPlantCount());
+    for (u32 i = 0; i < plants.size(); i++) {
+        PlantArchetype& plant = plants[i];
+        plant.id = intern(pack.string(srcPlants[i].id));
+        plant.name = intern(pack.string(srcPlants[i].name));
+        plant.stats = srcPlants[i].stats;
+        plant.cost = srcPlants[i].cost;
+        plant.cooldown = srcPlants[i].cooldown;
+        plant.rarity = (Rarity)srcPlants[i].rarity;
+        plant.element = (Element)srcPlants[i].element;
+        plant.layer = (GridLayer)srcPlants[i].layer;
+        indexBySymbol(plantBySymbol, plant.id, (ArchetypeId)i);
+    }
+    for (u32 i = 0; i < plants.size(); i++) {
+        if (srcPlants[i].evolvesTo != 0) {
+            plants[i].evolvesTo = findPlant(pack.string(srcPlants[i].evolvesTo));
+        }
+    }
+    
+    const PackEnemy* srcEnemies = pack.enemies();
+    enemies.resize(pack.getEnemyCount());
+    for (u32 i = 0; i < enemies.size(); i++) {
+        EnemyArchetype& enemy = enemies[i];
+        enemy.id = intern(pack.string(srcEnemies[i].id));
+        enemy.name = intern(pack.string(srcEnemies[i].name));
+        enemy.stats = srcEnemies[i].stats;
+        enemy.behavior = (EnemyBehavior)srcEnemies[i].behavior;
+        indexBySymbol(enemyBySymbol, enemy.id, (ArchetypeId)i);
+    }
+    
+    PL_LOG_INFO(Game, "Archetypes (pack): %u plants, %u enemies", getPlantCount(), getEnemyCount());
+    return true;
+}
+
+} // namespace PL
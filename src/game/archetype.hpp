@@ -0,0 +1,94 @@
+// ============================================
+// Plant Legends - 植物 / 敵人原型表
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include "core/symbol.hpp"
+#include "game/script_hooks.hpp"
+#include <string_view>
+#include <vector>
+
+struct lua_State;
+
+namespace PL {
+
+class DataPack;
+
+// 原型 ID：原型表中的索引（依 id 字母排序，每次載入都穩定）
+using ArchetypeId = u16;
+constexpr ArchetypeId kInvalidArchetype = 0xFFFF;
+
+// 植物原型
+// 腳本載入後一次建好，之後唯讀。生成時只複製 stats，不再碰 Lua。
+struct alignas(64) PlantArchetype {
+    // 熱資料
+    Stats stats;
+    i32 cost = 100;
+    f32 cooldown = 0.0f;
+    Rarity rarity = Rarity::Common;
+    Element element = Element::None;
+    GridLayer layer = GridLayer::Ground;
+    ArchetypeId evolvesTo = kInvalidArchetype;
+    HookSet hooks;
+    
+    // 冷資料
+    Symbol id = kNoSymbol;
+    Symbol name = kNoSymbol;
+};
+
+// 敵人原型
+struct alignas(64) EnemyArchetype {
+    Stats stats;
+    EnemyBehavior behavior = EnemyBehavior::Walker;
+    HookSet hooks;
+    
+    Symbol id = kNoSymbol;
+    Symbol name = kNoSymbol;
+};
+
+class ArchetypeRegistry {
+public:
+    static ArchetypeRegistry& instance();  // 每個執行緒一份（回呼引用屬於該執行緒的 Lua 狀態）
+    
+    // 從 plants / enemies 全域表建立（重複呼叫會整個重建）
+    bool build(lua_State* L);
+    bool build(const DataPack& pack);  // 從已烘焙的資料包建立，不需要 Lua
+    void clear();
+    
+    // 熱重載：重新讀取全域表並就地更新，既有原型的 ID 不變，新原型附加在後。
+    // 數值有變動的原型 ID 加入 changed，回傳新增的原型數
+    u32 reloadPlants(lua_State* L, std::vector<ArchetypeId>& changed);
+    u32 reloadEnemies(lua_State* L, std::vector<ArchetypeId>& changed);
+    
+    // 以符號查表是一次陣列索引；字串版本先查符號表
+    ArchetypeId findPlant(Symbol id) const { return id < plantBySymbol.size() ? plantBySymbol[id] : kInvalidArchetype; }
+    ArchetypeId findEnemy(Symbol id) const { return id < enemyBySymbol.size() ? enemyBySymbol[id] : kInvalidArchetype; }
+    ArchetypeId findPlant(std::string_view id) const { return findPlant(SymbolTable::instance().find(id)); }
+    ArchetypeId findEnemy(std::string_view id) const { return findEnemy(SymbolTable::instance().find(id)); }
+    ArchetypeId findPlant(const char* id) const { return findPlant(std::string_view(id)); }
+    ArchetypeId findEnemy(const char* id) const { return findEnemy(std::string_view(id)); }
+    
+    const PlantArchetype& plant(ArchetypeId id) const { return plants[id]; }
+    const EnemyArchetype& enemy(ArchetypeId id) const { return enemies[id]; }
+    
+    // 建立後只有熱重載與回呼引用（ScriptHooks::bind）會寫入
+    void setPlantHooks(ArchetypeId id, const HookSet& hooks) { plants[id].hooks = hooks; }
+    void setEnemyHooks(ArchetypeId id, const HookSet& hooks) { enemies[id].hooks = hooks; }
+    
+    u32 getPlantCount() const { return (u32)plants.size(); }
+    u32 getEnemyCount() const { return (u32)enemies.size(); }
+    
+private:
+    ArchetypeRegistry() = default;
+    
+    std::vector<PlantArchetype> plants;
+    std::vector<EnemyArchetype> enemies;
+    std::vector<ArchetypeId> plantBySymbol;   // 符號 -> 原型 ID
+    std::vector<ArchetypeId> enemyBySymbol;
+    
+    static void indexBySymbol(std::vector<ArchetypeId>& table, Symbol sym, ArchetypeId id);
+};
+
+} // namespace PL
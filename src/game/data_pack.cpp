@@ -0,0 +1,360 @@
+// ============================================
+// Plant Legends - Data Pack Implementation
+// ============================================
+
+#include "game/data_pack.hpp"
+#include "game/archetype.hpp"
+#include "core/log.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#define PL_PACK_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace PL {
+
+u32 packChecksum(const u8* bytes, u32 count) {
+    u32 hash = 2166136261u;
+    for (u32 i = 0; i < count; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// ============================================
+// DataPack
+// ============================================
+
+DataPack& DataPack::instance() {
+    static DataPack pack;
+    return pack;
+}
+
+bool DataPack::open(const std::string& path) {
+    close();
+    
+#ifdef PL_PACK_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(PackHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* ptr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<const u8*>(ptr);
+    size = (u32)st.st_size;
+    mapped = true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    std::streamsize length = file.tellg();
+    if (length < (std::streamsize)sizeof(PackHeader)) {
+        return false;
+    }
+    buffer.resize((size_t)length);
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), length)) {
+        buffer.clear();
+        return false;
+    }
+    data = buffer.data();
+    size = (u32)length;
+#endif
+    
+    if (!validate()) {
+        PL_LOG_WARN(Game, "Data pack %s is invalid or out of date", path.c_str());
+        close();
+        return false;
+    }
+    
+    strings = reinterpret_cast<const char*>(data + header()->sections[(u32)PackSection::Strings].offset);
+    PL_LOG_INFO(Game, "Data pack: %u bytes, %u plants, %u enemies, %u levels",
+                size, getPlantCount(), getEnemyCount(), getLevelCount());
+    return true;
+}
+
+void DataPack::close() {
+#ifdef PL_PACK_MMAP
+    if (mapped && data) {
+        munmap(const_cast<u8*>(data), size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    strings = nullptr;
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+bool DataPack::validate() {
+    const PackHeader* h = header();
+    if (std::memcmp(h->magic, kPackMagic, sizeof(kPackMagic)) != 0) return false;
+    if (h->version != kPackVersion || h->size != size) return false;
+    
+    // 各區段必須落在檔案內
+    static const u32 recordSize[(u32)PackSection::Count] = {
+        1, sizeof(PackConfig), sizeof(PackPlant), sizeof(PackEnemy),
+        sizeof(PackLevel), sizeof(PackWave), sizeof(PackWaveEnemy)
+    };
+    for (u32 s = 0; s < (u32)PackSection::Count; s++) {
+        const PackSectionEntry& entry = h->sections[s];
+        if (entry.offset % 4 != 0 || entry.offset < sizeof(PackHeader)) return false;
+        if ((u64)entry.offset + (u64)entry.count * recordSize[s] > size) return false;
+    }
+    const PackSectionEntry& str = h->sections[(u32)PackSection::Strings];
+    if (str.count == 0 || data[str.offset + str.count - 1] != 0) return false;
+    if (h->sections[(u32)PackSection::Config].count != 1) return false;
+    
+    if (packChecksum(data + sizeof(PackHeader), size - (u32)sizeof(PackHeader)) != h->checksum) return false;
+    
+    // 校驗和只防損毀；記錄內的索引與字串引用仍要逐一檢查，讀取時才不必再檢查邊界
+    auto inStrings = [&](u32 ref) { return ref < str.count; };
+    auto inRange = [](u32 first, u32 count, u32 total) { return (u64)first + count <= total; };
+    
+    const PackPlant* plantRecords = section<PackPlant>(PackSection::Plants);
+    for (u32 i = 0; i < h->sections[(u32)PackSection::Plants].count; i++) {
+        const PackPlant& plant = plantRecords[i];
+        if (!inStrings(plant.id) || !inStrings(plant.name) || !inStrings(plant.evolvesTo)) return false;
+    }
+    const PackEnemy* enemyRecords = section<PackEnemy>(PackSection::Enemies);
+    for (u32 i = 0; i < h->sections[(u32)PackSection::Enemies].count; i++) {
+        if (!inStrings(enemyRecords[i].id) || !inStrings(enemyRecords[i].name)) return false;
+    }
+    
+    const u32 waveTotal = h->sections[(u32)PackSection::Waves].count;
+    const u32 enemyTotal = h->sections[(u32)PackSection::WaveEnemies].count;
+    const PackLevel* levelRecords = section<PackLevel>(PackSection::Levels);
+    for (u32 i = 0; i < h->sections[(u32)PackSection::Levels].count; i++) {
+        const PackLevel& level = levelRecords[i];
+        if (!inStrings(level.id) || !inRange(level.firstWave, level.waveCount, waveTotal)) return false;
+    }
+    const PackWave* waveRecords = section<PackWave>(PackSection::Waves);
+    for (u32 i = 0; i < waveTotal; i++) {
+        if (!inRange(waveRecords[i].firstEnemy, waveRecords[i].enemyCount, enemyTotal)) return false;
+    }
+    const PackWaveEnemy* entryRecords = section<PackWaveEnemy>(PackSection::WaveEnemies);
+    for (u32 i = 0; i < enemyTotal; i++) {
+        if (!inStrings(entryRecords[i].enemy)) return false;
+    }
+    return true;
+}
+
+const PackLevel* DataPack::findLevel(const std::string& levelId) const {
+    const PackLevel* begin = levels();
+    const PackLevel* end = begin + getLevelCount();
+    const PackLevel* it = std::lower_bound(begin, end, levelId, [this](const PackLevel& level, const std::string& id) {
+        return std::strcmp(string(level.id), id.c_str()) < 0;
+    });
+    if (it != end && levelId == string(it->id)) {
+        return it;
+    }
+    return nullptr;
+}
+
+void DataPack::readConfig(GameConfig& out) const {
+    const PackConfig& cfg = config();
+    out.grid = cfg.grid;
+    out.elements = cfg.elements;
+    out.startingSun = cfg.startingSun;
+    out.sunInterval = cfg.sunInterval;
+    out.projectilePoolSize = cfg.projectilePoolSize;
+    out.luaGcMaxMs = cfg.luaGcMaxMs;
+    out.tickRate = cfg.tickRate;
+    out.maxStepsPerFrame = cfg.maxStepsPerFrame;
+}
+
+void DataPack::readLevel(const PackLevel& level, LevelData& out) const {
+    out = LevelData();
+    out.id = intern(string(level.id));
+    out.initialSun = level.initialSun;
+    out.projectilePool = level.projectilePool;
+    out.cols = level.cols;
+    out.rows = level.rows;
+    out.starTime = level.starTime;
+    
+    const PackWave* waves = section<PackWave>(PackSection::Waves) + level.firstWave;
+    const PackWaveEnemy* enemies = section<PackWaveEnemy>(PackSection::WaveEnemies);
+    out.waves.resize(level.waveCount);
+    for (u32 w = 0; w < level.waveCount; w++) {
+        WaveConfig& wave = out.waves[w];
+        wave.time = waves[w].time;
+        wave.enemies.reserve(waves[w].enemyCount);
+        for (u32 e = 0; e < waves[w].enemyCount; e++) {
+            const PackWaveEnemy& entry = enemies[waves[w].firstEnemy + e];
+            wave.enemies.push_back({intern(string(entry.enemy)), entry.count});
+        }
+    }
+}
+
+// ============================================
+// Writer
+// ============================================
+
+namespace {
+
+// 去重的字串區，偏移 0 為空字串
+class StringPool {
+public:
+    StringPool() { blob.push_back('\0'); }
+    
+    u32 add(const std::string& str) {
+        if (str.empty()) return 0;
+        auto it = offsets.find(str);
+        if (it != offsets.end()) return it->second;
+        u32 offset = (u32)blob.size();
+        blob.insert(blob.end(), str.begin(), str.end());
+        blob.push_back('\0');
+        offsets.emplace(str, offset);
+        return offset;
+    }
+    
+    u32 add(Symbol sym) { return add(SymbolTable::instance().str(sym)); }
+    
+    std::vector<char> blob;
+    
+private:
+    std::unordered_map<std::string, u32> offsets;
+};
+
+// 記錄先以零填滿，避免填充位元組把未初始化的內容寫進檔案（影響校驗和的可重現性）
+template<typename T>
+void zeroFill(T& record) {
+    std::memset(static_cast<void*>(&record), 0, sizeof(T));
+}
+
+template<typename T>
+void appendRecords(std::vector<u8>& out, PackSectionEntry& entry, const T* records, u32 count, u32 bytes) {
+    while (out.size() % 4 != 0) out.push_back(0);
+    entry.offset = (u32)out.size();
+    entry.count = count;
+    const u8* src = reinterpret_cast<const u8*>(records);
+    out.insert(out.end(), src, src + bytes);
+}
+
+} // namespace
+
+bool writePack(const std::string& path, const GameConfig& config,
+               const ArchetypeRegistry& archetypes, const std::vector<LevelData>& levels) {
+    StringPool strings;
+    
+    PackConfig cfg;
+    zeroFill(cfg);
+    cfg.grid = config.grid;
+    cfg.elements = config.elements;
+    cfg.startingSun = config.startingSun;
+    cfg.sunInterval = config.sunInterval;
+    cfg.projectilePoolSize = config.projectilePoolSize;
+    cfg.luaGcMaxMs = config.luaGcMaxMs;
+    cfg.tickRate = config.tickRate;
+    cfg.maxStepsPerFrame = config.maxStepsPerFrame;
+    
+    std::vector<PackPlant> plants(archetypes.getPlantCount());
+    for (u32 i = 0; i < plants.size(); i++) {
+        const PlantArchetype& src = archetypes.plant((ArchetypeId)i);
+        PackPlant& dst = plants[i];
+        zeroFill(dst);
+        dst.id = strings.add(src.id);
+        dst.name = strings.add(src.name);
+        dst.evolvesTo = src.evolvesTo != kInvalidArchetype ? strings.add(archetypes.plant(src.evolvesTo).id) : 0;
+        dst.stats = src.stats;
+        dst.cost = src.cost;
+        dst.cooldown = src.cooldown;
+        dst.rarity = (u8)src.rarity;
+        dst.element = (u8)src.element;
+        dst.layer = (u8)src.layer;
+    }
+    
+    std::vector<PackEnemy> enemies(archetypes.getEnemyCount());
+    for (u32 i = 0; i < enemies.size(); i++) {
+        const EnemyArchetype& src = archetypes.enemy((ArchetypeId)i);
+        PackEnemy& dst = enemies[i];
+        zeroFill(dst);
+        dst.id = strings.add(src.id);
+        dst.name = strings.add(src.name);
+        dst.stats = src.stats;
+        dst.behavior = (u8)src.behavior;
+    }
+    
+    // 關卡依 id 字串排序，讀取端才能二分搜尋
+    std::vector<const LevelData*> sorted;
+    for (const LevelData& level : levels) sorted.push_back(&level);
+    std::sort(sorted.begin(), sorted.end(), [](const LevelData* a, const LevelData* b) {
+        return SymbolTable::instance().str(a->id) < SymbolTable::instance().str(b->id);
+    });
+    
+    std::vector<PackLevel> packLevels;
+    std::vector<PackWave> packWaves;
+    std::vector<PackWaveEnemy> packEnemies;
+    for (const LevelData* level : sorted) {
+        PackLevel dst;
+        zeroFill(dst);
+        dst.id = strings.add(level->id);
+        dst.initialSun = level->initialSun;
+        dst.projectilePool = level->projectilePool;
+        dst.cols = level->cols;
+        dst.rows = level->rows;
+        dst.starTime = level->starTime;
+        dst.firstWave = (u32)packWaves.size();
+        dst.waveCount = (u32)level->waves.size();
+        packLevels.push_back(dst);
+        
+        for (const WaveConfig& wave : level->waves) {
+            PackWave w;
+            w.time = wave.time;
+            w.firstEnemy = (u32)packEnemies.size();
+            w.enemyCount = (u32)wave.enemies.size();
+            packWaves.push_back(w);
+            for (const auto& [enemyId, count] : wave.enemies) {
+                packEnemies.push_back({strings.add(enemyId), count});
+            }
+        }
+    }
+    
+    // 組合檔案
+    std::vector<u8> out(sizeof(PackHeader), 0);
+    PackHeader header;
+    zeroFill(header);
+    std::memcpy(header.magic, kPackMagic, sizeof(kPackMagic));
+    header.version = kPackVersion;
+    
+    auto& sec = header.sections;
+    appendRecords(out, sec[(u32)PackSection::Strings], strings.blob.data(), (u32)strings.blob.size(), (u32)strings.blob.size());
+    appendRecords(out, sec[(u32)PackSection::Config], &cfg, 1, (u32)sizeof(cfg));
+    appendRecords(out, sec[(u32)PackSection::Plants], plants.data(), (u32)plants.size(), (u32)(plants.size() * sizeof(PackPlant)));
+    appendRecords(out, sec[(u32)PackSection::Enemies], enemies.data(), (u32)enemies.size(), (u32)(enemies.size() * sizeof(PackEnemy)));
+    appendRecords(out, sec[(u32)PackSection::Levels], packLevels.data(), (u32)packLevels.size(), (u32)(packLevels.size() * sizeof(PackLevel)));
+    appendRecords(out, sec[(u32)PackSection::Waves], packWaves.data(), (u32)packWaves.size(), (u32)(packWaves.size() * sizeof(PackWave)));
+    appendRecords(out, sec[(u32)PackSection::WaveEnemies], packEnemies.data(), (u32)packEnemies.size(), (u32)(packEnemies.size() * sizeof(PackWaveEnemy)));
+    while (out.size() % 4 != 0) out.push_back(0);
+    
+    header.size = (u32)out.size();
+    header.checksum = packChecksum(out.data() + sizeof(PackHeader), header.size - (u32)sizeof(PackHeader));
+    std::memcpy(out.data(), &header, sizeof(header));
+    
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(reinterpret_cast<const char*>(out.data()), (std::streamsize)out.size())) {
+        PL_LOG_ERROR(Game, "Failed to write data pack %s", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace PL
@@ -0,0 +1,164 @@
+// ============================================
+// Plant Legends - 預先烘焙的二進位資料包
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include "game/game_data.hpp"
+#include <string>
+#include <vector>
+#include <type_traits>
+
+namespace PL {
+
+class ArchetypeRegistry;
+
+// 檔案格式（小端序，所有記錄 4 位元組對齊）：
+//   PackHeader | 字串區 | Config | Plants[] | Enemies[] | Levels[] | Waves[] | WaveEnemies[]
+// 字串以字串區內的位元組偏移引用，0 為空字串。
+// Levels 依 id 字串排序，可直接二分搜尋；載入時不解析任何內容。
+// 記錄直接內嵌 Stats / GridConfig / ElementConfig，改動這些結構時必須提升 kPackVersion。
+constexpr char kPackMagic[4] = {'P', 'L', 'P', 'K'};
+constexpr u32 kPackVersion = 4;
+
+enum class PackSection : u32 {
+    Strings,
+    Config,
+    Plants,
+    Enemies,
+    Levels,
+    Waves,
+    WaveEnemies,
+    Count
+};
+
+struct PackSectionEntry {
+    u32 offset = 0;   // 距檔案開頭
+    u32 count = 0;    // 記錄數（字串區為位元組數）
+};
+
+struct PackHeader {
+    char magic[4];
+    u32 version;
+    u32 size;         // 整個檔案大小
+    u32 checksum;     // 標頭之後所有位元組的 FNV-1a
+    PackSectionEntry sections[(u32)PackSection::Count];
+};
+
+struct PackConfig {
+    GridConfig grid;
+    ElementConfig elements;
+    i32 startingSun;
+    f32 sunInterval;
+    u32 projectilePoolSize;
+    f32 luaGcMaxMs;
+    f32 tickRate;
+    u32 maxStepsPerFrame;
+};
+
+struct PackPlant {
+    u32 id;
+    u32 name;
+    u32 evolvesTo;    // 字串引用，0 表示無
+    Stats stats;
+    i32 cost;
+    f32 cooldown;
+    u8 rarity;
+    u8 element;
+    u8 layer;
+    u8 pad;
+};
+
+struct PackEnemy {
+    u32 id;
+    u32 name;
+    Stats stats;
+    u8 behavior;
+    u8 pad[3];
+};
+
+struct PackLevel {
+    u32 id;
+    i32 initialSun;
+    u32 projectilePool;
+    i32 cols;
+    i32 rows;
+    f32 starTime;
+    u32 firstWave;
+    u32 waveCount;
+};
+
+struct PackWave {
+    f32 time;
+    u32 firstEnemy;
+    u32 enemyCount;
+};
+
+struct PackWaveEnemy {
+    u32 enemy;        // 字串引用
+    i32 count;
+};
+
+static_assert(std::is_trivially_copyable<PackConfig>::value, "pack records must be trivially copyable");
+static_assert(std::is_trivially_copyable<PackPlant>::value, "pack records must be trivially copyable");
+static_assert(std::is_trivially_copyable<PackEnemy>::value, "pack records must be trivially copyable");
+
+// 唯讀資料包。桌面平台以 mmap 對映，記錄就地使用；其他平台整檔讀入。
+class DataPack {
+public:
+    static DataPack& instance();
+    
+    DataPack() = default;
+    ~DataPack() { close(); }
+    DataPack(const DataPack&) = delete;
+    DataPack& operator=(const DataPack&) = delete;
+    
+    // 驗證魔數、版本、大小、校驗和與記錄內的索引/字串範圍；失敗時回傳 false 並保持關閉
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+    u32 getSize() const { return size; }
+    
+    const char* string(u32 ref) const { return strings + ref; }
+    const PackConfig& config() const { return *section<PackConfig>(PackSection::Config); }
+    
+    const PackPlant* plants() const { return section<PackPlant>(PackSection::Plants); }
+    const PackEnemy* enemies() const { return section<PackEnemy>(PackSection::Enemies); }
+    const PackLevel* levels() const { return section<PackLevel>(PackSection::Levels); }
+    u32 getPlantCount() const { return header()->sections[(u32)PackSection::Plants].count; }
+    u32 getEnemyCount() const { return header()->sections[(u32)PackSection::Enemies].count; }
+    u32 getLevelCount() const { return header()->sections[(u32)PackSection::Levels].count; }
+    
+    // 二分搜尋關卡，找不到回傳 nullptr
+    const PackLevel* findLevel(const std::string& levelId) const;
+    
+    // 展開成執行期結構（只複製這一關）
+    void readConfig(GameConfig& out) const;
+    void readLevel(const PackLevel& level, LevelData& out) const;
+    
+private:
+    const u8* data = nullptr;
+    u32 size = 0;
+    bool mapped = false;
+    std::vector<u8> buffer;    // 不支援 mmap 時的備援
+    const char* strings = nullptr;
+    
+    const PackHeader* header() const { return reinterpret_cast<const PackHeader*>(data); }
+    
+    template<typename T>
+    const T* section(PackSection s) const {
+        return reinterpret_cast<const T*>(data + header()->sections[(u32)s].offset);
+    }
+    
+    bool validate();
+};
+
+// 將設定、原型與關卡寫成資料包（離線烘焙工具使用）
+bool writePack(const std::string& path, const GameConfig& config,
+               const ArchetypeRegistry& archetypes, const std::vector<LevelData>& levels);
+
+// FNV-1a 32 位元
+u32 packChecksum(const u8* bytes, u32 count);
+
+} // namespace PL
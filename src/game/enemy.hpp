@@ -5,63 +5,40 @@
 #pragma once
 
 #include "core/entity.hpp"
+#include "game/archetype.hpp"
+#include <string>
 
 namespace PL {
 
+// 敵人冷資料；位置、血量、攻擊計時器、狀態與目標存放在 EnemyStore
 class Enemy : public Entity {
 public:
-    Enemy(const std::string& enemyId);
+    explicit Enemy(ArchetypeId archetype);
     ~Enemy() override = default;
     
-    void update(f32 dt) override;
     void render() override;
     
-    // 屬性
-    const std::string& getEnemyId() const { return enemyId; }
-    const Stats& getStats() const { return stats; }
-    
-    // 位置
-    i32 getRow() const { return row; }
-    void setRow(i32 r) { row = r; }
+    // 原型
+    ArchetypeId getArchetypeId() const { return archetype; }
+    const EnemyArchetype& getArchetype() const { return ArchetypeRegistry::instance().enemy(archetype); }
     
-    // 移動
-    void move(f32 dt);
-    f32 getProgress() const;  // 0.0 = 起點, 1.0 = 終點
-    
-    // 戰鬥
-    void takeDamage(f32 damage);
-    bool canAttack() const;
-    void attack();
+    // 屬性（基礎數值）
+    Symbol getEnemyId() const { return getArchetype().id; }
+    Symbol getName() const { return getArchetype().name; }
+    const Stats& getStats() const { return stats; }
+    Stats& getStats() { return stats; }  // 腳本可修改單一實例
     
-    // 目標
-    PlantPtr getTargetPlant() const { return targetPlant; }
-    void setTargetPlant(PlantPtr plant) { targetPlant = plant; }
+    // 護甲減傷後的實際傷害
+    f32 mitigate(f32 damage) const { return damage * (1.0f - stats.armor / 100.0f); }
     
     // 行為類型
-    enum class Behavior {
-        Walker,      // 直線前進
-        Flyer,       // 飛行
-        Phasing,     // 可穿透植物
-        Charger      // 衝鋒
-    };
+    using Behavior = EnemyBehavior;
     
-    Behavior getBehavior() const { return behavior; }
-    
-    // 狀態效果
-    bool isSlowed() const { return hasStatus(StatusType::Slow); }
-    bool isFrozen() const { return hasStatus(StatusType::Freeze); }
+    Behavior getBehavior() const { return getArchetype().behavior; }
     
 private:
-    std::string enemyId;
-    std::string name;
+    ArchetypeId archetype;
     Stats stats;
-    i32 row = 0;
-    Behavior behavior = Behavior::Walker;
-    
-    f32 attackTimer = 0.0f;
-    PlantPtr targetPlant = nullptr;
-    
-    void loadFromLua();
 };
 
 } // namespace PL
@@ -0,0 +1,248 @@
+// ============================================
+// Plant Legends - Entity Store Implementation
+// ============================================
+
+#include "game/entity_store.hpp"
+#include <algorithm>
+
+namespace PL {
+
+namespace {
+
+// 將最後一筆搬到 index 後縮短欄位
+template<typename T>
+void swapPop(std::vector<T>& column, u32 index) {
+    if (index + 1 < column.size()) {
+        column[index] = std::move(column.back());
+    }
+    column.pop_back();
+}
+
+} // namespace
+
+// ============================================
+// PlantStore
+// ============================================
+
+PlantHandle PlantStore::add(const Plant& plant, const Vec2& pos, i32 r) {
+    u32 index = size();
+    PlantHandle handle = slots.allocate<Plant>(index);
+    const Stats& stats = plant.getStats();
+
+    x.push_back(pos.x);
+    y.push_back(pos.y);
+    hp.push_back(stats.hp);
+    maxHp.push_back(stats.maxHp);
+    range.push_back(stats.range);
+    attackTimer.push_back(0.0f);
+    row.push_back(r);
+    element.push_back(plant.getElement());
+    status.emplace_back();
+    alive.push_back(1);
+    target.push_back({});
+    retarget.push_back(1);
+    slot.push_back(handle.index);
+    objects.push_back(plant);
+
+    return handle;
+}
+
+void PlantStore::removeAt(u32 index) {
+    slots.release(slot[index]);
+
+    swapPop(x, index);
+    swapPop(y, index);
+    swapPop(hp, index);
+    swapPop(maxHp, index);
+    swapPop(range, index);
+    swapPop(attackTimer, index);
+    swapPop(row, index);
+    swapPop(element, index);
+    swapPop(status, index);
+    swapPop(alive, index);
+    swapPop(target, index);
+    swapPop(retarget, index);
+    swapPop(slot, index);
+    swapPop(objects, index);
+
+    if (index < size()) {
+        slots.move(slot[index], index);
+    }
+}
+
+void PlantStore::clear() {
+    slots.releaseAll();
+    x.clear();
+    y.clear();
+    hp.clear();
+    maxHp.clear();
+    range.clear();
+    attackTimer.clear();
+    row.clear();
+    element.clear();
+    status.clear();
+    alive.clear();
+    target.clear();
+    retarget.clear();
+    slot.clear();
+    objects.clear();
+}
+
+// ============================================
+// EnemyStore
+// ============================================
+
+f32 EnemyStore::progress(u32 i) const {
+    // 起點 x=kEnemySpawnX, 終點 x=0
+    f32 start = kEnemySpawnX;
+    f32 end = 0.0f;
+    return 1.0f - (x[i] - end) / (start - end);
+}
+
+EnemyHandle EnemyStore::add(const Enemy& enemy, const Vec2& pos, i32 r) {
+    u32 index = size();
+    EnemyHandle handle = slots.allocate<Enemy>(index);
+    const Stats& stats = enemy.getStats();
+
+    x.push_back(pos.x);
+    y.push_back(pos.y);
+    hp.push_back(stats.hp);
+    maxHp.push_back(stats.maxHp);
+    speed.push_back(stats.speed);
+    prevX.push_back(pos.x);
+    attackTimer.push_back(0.0f);
+    row.push_back(r);
+    behavior.push_back(enemy.getBehavior());
+    status.emplace_back();
+    alive.push_back(1);
+    target.push_back({});
+    retarget.push_back(1);
+    cell.push_back(kInvalidIndex);
+    scanCol.push_back(0);
+    slot.push_back(handle.index);
+    objects.push_back(enemy);
+
+    return handle;
+}
+
+void EnemyStore::removeAt(u32 index) {
+    slots.release(slot[index]);
+
+    swapPop(x, index);
+    swapPop(y, index);
+    swapPop(hp, index);
+    swapPop(maxHp, index);
+    swapPop(speed, index);
+    swapPop(prevX, index);
+    swapPop(attackTimer, index);
+    swapPop(row, index);
+    swapPop(behavior, index);
+    swapPop(status, index);
+    swapPop(alive, index);
+    swapPop(target, index);
+    swapPop(retarget, index);
+    swapPop(cell, index);
+    swapPop(scanCol, index);
+    swapPop(slot, index);
+    swapPop(objects, index);
+
+    if (index < size()) {
+        slots.move(slot[index], index);
+    }
+}
+
+void EnemyStore::clear() {
+    slots.releaseAll();
+    x.clear();
+    y.clear();
+    hp.clear();
+    maxHp.clear();
+    speed.clear();
+    prevX.clear();
+    attackTimer.clear();
+    row.clear();
+    behavior.clear();
+    status.clear();
+    alive.clear();
+    target.clear();
+    retarget.clear();
+    cell.clear();
+    scanCol.clear();
+    slot.clear();
+    objects.clear();
+}
+
+// ============================================
+// ProjectilePool
+// ============================================
+
+void ProjectilePool::reset(u32 cap) {
+    if (cap != capacity()) {
+        x.assign(cap, 0.0f);
+        y.assign(cap, 0.0f);
+        prevX.assign(cap, 0.0f);
+        prevY.assign(cap, 0.0f);
+        damage.assign(cap, 0.0f);
+        element.assign(cap, Element::None);
+        alive.assign(cap, 0);
+        target.assign(cap, EnemyHandle());
+        source.assign(cap, PlantHandle());
+    }
+    count = 0;
+    stats = ProjectilePoolStats();
+    stats.capacity = cap;
+}
+
+u32 ProjectilePool::add(const Vec2& pos, EnemyHandle t, f32 dmg, Element elem, PlantHandle src) {
+    if (count >= capacity()) {
+        stats.dropped++;
+        return kInvalidIndex;
+    }
+
+    u32 index = count++;
+    x[index] = pos.x;
+    y[index] = pos.y;
+    prevX[index] = pos.x;
+    prevY[index] = pos.y;
+    damage[index] = dmg;
+    element[index] = elem;
+    alive[index] = 1;
+    target[index] = t;
+    source[index] = src;
+
+    stats.spawned++;
+    stats.live = count;
+    if (count > stats.highWater) {
+        stats.highWater = count;
+    }
+    return index;
+}
+
+void ProjectilePool::removeAt(u32 index) {
+    u32 last = --count;
+    if (index != last) {
+        x[index] = x[last];
+        y[index] = y[last];
+        prevX[index] = prevX[last];
+        prevY[index] = prevY[last];
+        damage[index] = damage[last];
+        element[index] = element[last];
+        alive[index] = alive[last];
+        target[index] = target[last];
+        source[index] = source[last];
+    }
+    stats.recycled++;
+    stats.live = count;
+}
+
+void ProjectilePool::clear() {
+    count = 0;
+    stats.live = 0;
+}
+
+void ProjectilePool::savePrevious() {
+    std::copy(x.begin(), x.begin() + count, prevX.begin());
+    std::copy(y.begin(), y.begin() + count, prevY.begin());
+}
+
+} // namespace PL
@@ -0,0 +1,147 @@
+// ============================================
+// Plant Legends - 實體 SoA 儲存
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include "core/handle.hpp"
+#include "core/status.hpp"
+#include "game/plant.hpp"
+#include "game/enemy.hpp"
+#include <vector>
+
+namespace PL {
+
+// 碰撞半寬（取代每個實體各自保存的碰撞盒）
+constexpr f32 kPlantHalfExtent = 30.0f;
+constexpr f32 kEnemyHalfExtent = 25.0f;
+constexpr f32 kProjectileHalfExtent = 5.0f;
+
+// 敵人生成的 x 座標（右側場外）
+constexpr f32 kEnemySpawnX = 1200.0f;
+
+// 植物熱資料
+// 每個欄位是一條連續陣列，同一個 dense index 對應同一株植物；
+// 原型 ID、基礎數值等冷資料以值存放在 objects 內，生成只是一次結構複製。
+// 跨實體引用一律使用 PlantHandle / EnemyHandle，經由 slots 解析。
+struct PlantStore {
+    std::vector<f32> x;
+    std::vector<f32> y;
+    std::vector<f32> hp;
+    std::vector<f32> maxHp;
+    std::vector<f32> range;
+    std::vector<f32> attackTimer;
+    std::vector<i32> row;
+    std::vector<Element> element;
+    std::vector<StatusSet> status;
+    std::vector<u8> alive;
+    std::vector<EnemyHandle> target;
+    std::vector<u8> retarget;        // 需要重新選目標
+    std::vector<u32> slot;
+
+    std::vector<Plant> objects;     // 冷資料
+    SlotTable slots;
+
+    u32 size() const { return (u32)x.size(); }
+    Vec2 position(u32 i) const { return Vec2(x[i], y[i]); }
+
+    PlantHandle handleAt(u32 i) const { return PlantHandle(slot[i], slots.generation(slot[i])); }
+    u32 resolve(PlantHandle handle) const { return slots.resolve(handle); }
+    bool isAlive(PlantHandle handle) const {
+        u32 i = resolve(handle);
+        return i != kInvalidIndex && alive[i];
+    }
+
+    PlantHandle add(const Plant& plant, const Vec2& pos, i32 row);
+    void removeAt(u32 index);  // 與最後一筆交換後移除
+    void clear();
+};
+
+// 敵人熱資料
+struct EnemyStore {
+    std::vector<f32> x;
+    std::vector<f32> y;
+    std::vector<f32> hp;
+    std::vector<f32> maxHp;
+    std::vector<f32> speed;
+    std::vector<f32> prevX;          // 上一個 tick 的 x（渲染插值；敵人只沿 x 移動）
+    std::vector<f32> attackTimer;
+    std::vector<i32> row;
+    std::vector<EnemyBehavior> behavior;
+    std::vector<StatusSet> status;
+    std::vector<u8> alive;
+    std::vector<PlantHandle> target;
+    std::vector<u8> retarget;
+    std::vector<u32> cell;           // 所在的空間桶（跨桶時喚醒觀察的植物）
+    std::vector<i32> scanCol;        // 上次選目標時攻擊範圍最左格
+    std::vector<u32> slot;
+
+    std::vector<Enemy> objects;     // 冷資料
+    SlotTable slots;
+
+    u32 size() const { return (u32)x.size(); }
+    Vec2 position(u32 i) const { return Vec2(x[i], y[i]); }
+    Vec2 interpolated(u32 i, f32 alpha) const { return Vec2(prevX[i] + (x[i] - prevX[i]) * alpha, y[i]); }
+    f32 progress(u32 i) const;  // 0.0 = 起點, 1.0 = 終點
+    void savePrevious() { prevX = x; }  // tick 開始時記錄
+
+    EnemyHandle handleAt(u32 i) const { return EnemyHandle(slot[i], slots.generation(slot[i])); }
+    u32 resolve(EnemyHandle handle) const { return slots.resolve(handle); }
+    bool isAlive(EnemyHandle handle) const {
+        u32 i = resolve(handle);
+        return i != kInvalidIndex && alive[i];
+    }
+
+    EnemyHandle add(const Enemy& enemy, const Vec2& pos, i32 row);
+    void removeAt(u32 index);
+    void clear();
+};
+
+// 投射物池統計
+struct ProjectilePoolStats {
+    u32 capacity = 0;
+    u32 live = 0;
+    u32 highWater = 0;   // 本關最高同時存活數
+    u64 spawned = 0;
+    u64 recycled = 0;
+    u64 dropped = 0;     // 池滿時捨棄的投射物
+};
+
+// 投射物池
+// 投射物沒有冷資料，整筆存在欄位中。欄位在 reset() 時一次配置到
+// 固定容量，之後生成/回收只移動 count，穩定狀態下不配置記憶體。
+struct ProjectilePool {
+    std::vector<f32> x;
+    std::vector<f32> y;
+    std::vector<f32> prevX;             // 上一個 tick 的位置（渲染插值）
+    std::vector<f32> prevY;
+    std::vector<f32> damage;
+    std::vector<Element> element;
+    std::vector<u8> alive;
+    std::vector<EnemyHandle> target;
+    std::vector<PlantHandle> source;    // 發射的植物（命中/擊殺回呼）
+
+    f32 speed = 500.0f;
+
+    u32 size() const { return count; }
+    u32 capacity() const { return (u32)x.size(); }
+    Vec2 position(u32 i) const { return Vec2(x[i], y[i]); }
+    Vec2 interpolated(u32 i, f32 alpha) const {
+        return Vec2(prevX[i] + (x[i] - prevX[i]) * alpha, prevY[i] + (y[i] - prevY[i]) * alpha);
+    }
+    const ProjectilePoolStats& getStats() const { return stats; }
+
+    void reset(u32 capacity);  // 清空並調整容量（只在載入關卡時呼叫）
+    u32 add(const Vec2& pos, EnemyHandle target, f32 damage, Element element,
+            PlantHandle source = PlantHandle());  // 池滿回傳 kInvalidIndex
+    void removeAt(u32 index);
+    void clear();
+    void savePrevious();  // tick 開始時記錄（只複製存活的前 count 筆）
+
+private:
+    u32 count = 0;
+    ProjectilePoolStats stats;
+};
+
+} // namespace PL
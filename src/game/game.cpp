@@ -3,22 +3,22 @@
 // ============================================
 
 #include "game/game.hpp"
-#include "game/projectile.hpp"
+#include "game/data_pack.hpp"
+#include "game/level_loader.hpp"
+#include "game/script_hooks.hpp"
 #include "lua/lua_manager.hpp"
-#include <iostream>
+#include "core/log.hpp"
 #include <algorithm>
+#include <cmath>
 #include <random>
 
-extern "C" {
-#include <lua.h>
-#include <lualib.h>
-#include <lauxlib.h>
-}
-
 namespace PL {
 
-// 全局遊戲實例
-static Game* s_game = nullptr;
+// 全局遊戲實例（每個執行緒一個）
+static thread_local Game* s_game = nullptr;
+
+// 敵人近戰攻擊範圍
+constexpr f32 kEnemyAttackRange = 100.0f;
 
 Game& getGame() {
     if (!s_game) {
@@ -36,97 +36,111 @@ Game::~Game() {
 }
 
 bool Game::initialize() {
-    std::cout << "[Game] Initializing..." << std::endl;
-    
-    // 載入配置
-    LuaManager& lua = LuaManager::instance();
-    lua_State* L = lua.getState();
-    
-    lua_getglobal(L, "config");
-    if (lua_istable(L, -1)) {
-        // 讀取網格配置
-        lua_getfield(L, -1, "global");
-        if (lua_istable(L, -1)) {
-            lua_getfield(L, -1, "grid_cols");
-            if (lua_isnumber(L, -1)) {
-                gridConfig.cols = (i32)lua_tointeger(L, -1);
-            }
-            lua_pop(L, 1);
-            
-            lua_getfield(L, -1, "grid_rows");
-            if (lua_isnumber(L, -1)) {
-                gridConfig.rows = (i32)lua_tointeger(L, -1);
-            }
-            lua_pop(L, 1);
-            
-            lua_getfield(L, -1, "cell_width");
-            if (lua_isnumber(L, -1)) {
-                gridConfig.cellWidth = (f32)lua_tonumber(L, -1);
-            }
-            lua_pop(L, 1);
-            
-            lua_getfield(L, -1, "cell_height");
-            if (lua_isnumber(L, -1)) {
-                gridConfig.cellHeight = (f32)lua_tonumber(L, -1);
-            }
-            lua_pop(L, 1);
-            
-            // 初始陽光
-            lua_getfield(L, -1, "starting_sun");
-            if (lua_isnumber(L, -1)) {
-                sun = (i32)lua_tointeger(L, -1);
-            }
-            lua_pop(L, 1);
-            
-            // 陽光生成間隔
-            lua_getfield(L, -1, "sun_generation_interval");
-            if (lua_isnumber(L, -1)) {
-                sunInterval = (f32)lua_tonumber(L, -1);
-            }
-            lua_pop(L, 1);
-        }
-        lua_pop(L, 1);  // pop global
+    PL_LOG_INFO(Game, "Initializing...");
+    
+    // 載入配置（資料包優先）
+    GameConfig config;
+    const DataPack& pack = DataPack::instance();
+    if (pack.isOpen()) {
+        pack.readConfig(config);
+    } else if (!readConfig(LuaManager::instance().getState(), config)) {
+        PL_LOG_WARN(Game, "config table not found, using defaults");
     }
-    lua_pop(L, 1);  // pop config
     
-    std::cout << "[Game] Grid: " << gridConfig.cols << "x" << gridConfig.rows << std::endl;
-    std::cout << "[Game] Cell size: " << gridConfig.cellWidth << "x" << gridConfig.cellHeight << std::endl;
-    std::cout << "[Game] Initial sun: " << sun << std::endl;
+    gridConfig = config.grid;
+    elementConfig = config.elements;
+    sun = config.startingSun;
+    sunInterval = config.sunInterval;
+    projectilePoolSize = config.projectilePoolSize;
+    LuaManager::instance().setGcBudget(config.luaGcMaxMs);
+    timestep.configure(config.tickRate, config.maxStepsPerFrame);
+    if (!seeded) {
+        std::random_device rd;
+        random.seed(((u64)rd() << 32) | rd());
+    }
+    
+    PL_LOG_INFO(Game, "Grid: %dx%d", gridConfig.cols, gridConfig.rows);
+    PL_LOG_INFO(Game, "Cell size: %gx%g", gridConfig.cellWidth, gridConfig.cellHeight);
+    PL_LOG_INFO(Game, "Initial sun: %d", sun);
+    PL_LOG_INFO(Game, "Tick rate: %g Hz (max %u steps/frame)", config.tickRate, timestep.getMaxSteps());
+    PL_LOG_INFO(Game, "Random seed: %llu", (unsigned long long)random.getSeed());
+    
+    projectiles.reset(projectilePoolSize);
+    resizeGrid(gridConfig.cols, gridConfig.rows);
+    ScriptHooks::instance().setGame(this);
     
     state = GameState::Menu;
     return true;
 }
 
 void Game::shutdown() {
-    std::cout << "[Game] Shutting down..." << std::endl;
+    PL_LOG_INFO(Game, "Shutting down...");
+    
+    logProjectileStats();
+    ScriptHooks::instance().logStats();
     
     plants.clear();
     enemies.clear();
     projectiles.clear();
     grid.clear();
+    lanes.clear();
     waves.clear();
     
     if (s_game == this) {
         s_game = nullptr;
+        ScriptHooks::instance().clearInstances();
+        ScriptHooks::instance().setGame(nullptr);
     }
 }
 
+u32 Game::advance(f32 frameDt) {
+    // 暫停或結束時不累積，恢復後不會一次補上整段時間
+    if (state != GameState::Playing) {
+        timestep.reset();
+        return 0;
+    }
+    
+    const u32 steps = timestep.advance(frameDt);
+    for (u32 i = 0; i < steps && state == GameState::Playing; i++) {
+        update(timestep.getStep());
+    }
+    return steps;
+}
+
 void Game::update(f32 dt) {
     if (state != GameState::Playing) return;
     
+    // 上一個 tick 的位置，渲染時在兩個 tick 之間插值
+    enemies.savePrevious();
+    projectiles.savePrevious();
+    
     levelTimer += dt;
+    levelTick++;
+    retargetStats = RetargetStats();
     
     updateSun(dt);
     updateWaves(dt);
+    lanes.refresh(enemies);
+    if (enemyHashDirty) {
+        rebuildSpatial();
+    }
     updatePlants(dt);
     updateEnemies(dt);
     updateProjectiles(dt);
     updateCombat(dt);
     
+    // 本 tick 的腳本事件：每種回呼一次批次呼叫
+    ScriptHooks::instance().flush();
+    
     cleanupDeadEntities();
+    rebuildSpatial();
     
-    // 檢查勝利/失敗條件
-    // TODO: 實現勝利/失敗檢測
+    // 檢查勝利條件：所有波次已生成且場上沒有敵人（失敗在敵人到達終點時判定）
+    if (state == GameState::Playing && levelStarted && !waves.empty() &&
+        currentWave >= (i32)waves.size() && enemies.size() == 0) {
+        state = GameState::Victory;
+        PL_LOG_INFO(Game, "All waves cleared! Victory!");
+    }
 }
 
 void Game::render() {
@@ -152,63 +166,120 @@ bool Game::isValidGridPosition(const GridCoord& coord) const {
            coord.row >= 0 && coord.row < gridConfig.rows;
 }
 
-bool Game::isGridOccupied(const GridCoord& coord) const {
-    return grid.find(gridToKey(coord)) != grid.end();
+bool Game::isGridOccupied(const GridCoord& coord, GridLayer layer) const {
+    return grid.isOccupied(coord, layer);
 }
 
 bool Game::placePlant(const std::string& plantId, const GridCoord& coord) {
-    if (!isValidGridPosition(coord) || isGridOccupied(coord)) {
+    ArchetypeId id = ArchetypeRegistry::instance().findPlant(plantId);
+    if (id == kInvalidArchetype) {
+        PL_LOG_ERROR(Game, "Unknown plant: %s", plantId.c_str());
+        return false;
+    }
+    return placePlant(id, coord);
+}
+
+bool Game::placePlant(ArchetypeId id, const GridCoord& coord) {
+    if (!isValidGridPosition(coord)) {
         return false;
     }
     
-    // 創建植物
-    auto plant = std::make_shared<Plant>(plantId);
+    const PlantArchetype& archetype = ArchetypeRegistry::instance().plant(id);
+    
+    // 同一格同一圖層只能有一株
+    if (grid.isOccupied(coord, archetype.layer)) {
+        return false;
+    }
     
     // 檢查陽光是否足夠
-    if (sun < plant->getCost()) {
-        std::cout << "[Game] Not enough sun! Need " << plant->getCost() << ", have " << sun << std::endl;
+    if (sun < archetype.cost) {
+        PL_LOG_INFO(Economy, "Not enough sun! Need %d, have %d", archetype.cost, sun);
         return false;
     }
     
     // 扣除陽光
-    sun -= plant->getCost();
+    sun -= archetype.cost;
     
-    // 設置位置
-    plant->setGridPosition(coord);
-    plant->setPosition(gridToWorld(coord));
+    // 創建植物（原型結構複製）
+    Plant plant(id);
+    plant.setGridPosition(coord);
     
     // 添加到容器
-    plants.push_back(plant);
-    grid[gridToKey(coord)] = plant;
+    grid.set(coord, archetype.layer, plants.add(plant, gridToWorld(coord), coord.row));
+    syncLaneOccupancy(coord);
+    plantHashDirty = true;
+    rebuildSpatial();
     
-    std::cout << "[Game] Placed " << plantId << " at (" << coord.col << ", " << coord.row << ")" << std::endl;
+    PL_LOG_INFO(Game, "Placed %s at (%d, %d)", symbolName(archetype.id), coord.col, coord.row);
+    record(ReplayCommand::PlacePlant, coord, archetype.id);
     return true;
 }
 
-void Game::removePlant(const GridCoord& coord) {
-    auto it = grid.find(gridToKey(coord));
-    if (it != grid.end()) {
-        it->second->destroy();
-        grid.erase(it);
+bool Game::removePlant(const GridCoord& coord) {
+    // 由上往下找第一個有植物的圖層
+    for (u32 layer = PlantGrid::kLayerCount; layer-- > 0; ) {
+        PlantHandle handle = grid.get(coord, (GridLayer)layer);
+        if (handle.isNull()) continue;
+        
+        u32 index = plants.resolve(handle);
+        if (index != kInvalidIndex) {
+            plants.alive[index] = 0;
+        }
+        grid.erase(coord, (GridLayer)layer, handle);
+        syncLaneOccupancy(coord);
+        record(ReplayCommand::RemovePlant, coord);
+        return true;
     }
+    return false;
+}
+
+PlantHandle Game::getPlantAt(const GridCoord& coord, GridLayer layer) const {
+    return grid.get(coord, layer);
 }
 
-PlantPtr Game::getPlantAt(const GridCoord& coord) const {
-    auto it = grid.find(gridToKey(coord));
-    return it != grid.end() ? it->second : nullptr;
+void Game::syncLaneOccupancy(const GridCoord& coord) {
+    // 地面行走的敵人只會碰到地面與覆蓋層
+    lanes.setOccupied(coord, grid.isOccupied(coord, GridLayer::Ground) ||
+                             grid.isOccupied(coord, GridLayer::Overlay));
 }
 
 void Game::spawnEnemy(const std::string& enemyId, i32 row) {
-    auto enemy = std::make_shared<Enemy>(enemyId);
-    
-    // 設置位置（從右邊開始）
-    Vec2 pos(1200.0f, gridConfig.offsetY + row * gridConfig.cellHeight + gridConfig.cellHeight / 2);
-    enemy->setPosition(pos);
-    enemy->setRow(row);
+    ArchetypeId id = ArchetypeRegistry::instance().findEnemy(enemyId);
+    if (id == kInvalidArchetype) {
+        PL_LOG_ERROR(Spawn, "Unknown enemy: %s", enemyId.c_str());
+        return;
+    }
+    spawnEnemy(id, row);
+}
+
+void Game::spawnEnemy(ArchetypeId id, i32 row, f32 x) {
+    Enemy enemy(id);
     
-    enemies.push_back(enemy);
+    // 設置位置（預設從右邊開始）
+    Vec2 pos(x, rowCenterY(row));
+    EnemyHandle handle = enemies.add(enemy, pos, row);
+    u32 index = enemies.resolve(handle);
+    lanes.insertEnemy(row, handle, index, pos.x);
+    touchEnemyCell(index);
+    enemyHashDirty = true;
     
-    std::cout << "[Game] Spawned " << enemyId << " at row " << row << std::endl;
+    PL_LOG_DEBUG(Spawn, "Spawned %s at row %d", symbolName(enemy.getEnemyId()), row);
+}
+
+void Game::collectSun(i32 amount) {
+    sun += amount;
+    record(ReplayCommand::CollectSun, GridCoord(), kNoSymbol, amount);
+}
+
+void Game::record(ReplayCommand command, const GridCoord& coord, Symbol plant, i32 amount) {
+    if (!recorder) return;
+    ReplayEvent event;
+    event.tick = levelTick;
+    event.command = command;
+    event.plant = plant;
+    event.coord = coord;
+    event.amount = amount;
+    recorder->events.push_back(event);
 }
 
 bool Game::spendSun(i32 amount) {
@@ -220,105 +291,78 @@ bool Game::spendSun(i32 amount) {
 }
 
 bool Game::loadLevel(const std::string& levelId) {
-    LuaManager& lua = LuaManager::instance();
-    lua_State* L = lua.getState();
-    
-    lua_getglobal(L, "levels");
-    if (!lua_istable(L, -1)) {
-        std::cerr << "[Game] levels table not found" << std::endl;
-        lua_pop(L, 1);
+    LevelLoader& loader = LevelLoader::instance();
+    LevelData level;
+    if (!loader.load(LuaManager::instance().getState(), levelId, level)) {
+        PL_LOG_ERROR(Game, "Level %s not found", levelId.c_str());
         return false;
     }
     
-    lua_getfield(L, -1, levelId.c_str());
-    if (!lua_istable(L, -1)) {
-        std::cerr << "[Game] Level " << levelId << " not found" << std::endl;
-        lua_pop(L, 2);
-        return false;
+    applyLevel(level);
+    
+    const LevelLoadStats& stats = loader.getLastLoad();
+    PL_LOG_INFO(Game, "Loaded level %s with %zu waves in %.2f ms (%u bytes)",
+                levelId.c_str(), waves.size(), stats.ms, stats.bytes);
+    return true;
+}
+
+void Game::unloadLevel() {
+    // 釋放波次資料（不保留容量），常駐記憶體不隨關卡數成長
+    std::vector<WaveConfig>().swap(waves);
+    currentLevel = kNoSymbol;
+    currentWave = 0;
+    starTime = 0.0f;
+    levelStarted = false;
+}
+
+void Game::applyLevel(LevelData& level) {
+    currentLevel = level.id;
+    
+    // 網格尺寸（關卡可覆寫，尺寸不同時重新配置）
+    i32 cols = level.cols > 0 ? level.cols : gridConfig.cols;
+    i32 rows = level.rows > 0 ? level.rows : gridConfig.rows;
+    if (cols != gridConfig.cols || rows != gridConfig.rows) {
+        resizeGrid(cols, rows);
     }
     
-    currentLevelId = levelId;
-    waves.clear();
+    // 投射物池容量（關卡可覆寫）
+    logProjectileStats();
+    projectiles.reset(level.projectilePool > 0 ? level.projectilePool : projectilePoolSize);
     
-    // 讀取初始陽光
-    lua_getfield(L, -1, "initial");
-    if (lua_istable(L, -1)) {
-        lua_getfield(L, -1, "sun");
-        if (lua_isnumber(L, -1)) {
-            sun = (i32)lua_tointeger(L, -1);
-        }
-        lua_pop(L, 1);
-    }
-    lua_pop(L, 1);
-    
-    // 讀取波次
-    lua_getfield(L, -1, "waves");
-    if (lua_istable(L, -1)) {
-        i32 waveIndex = 1;
-        while (true) {
-            lua_rawgeti(L, -1, waveIndex);
-            if (!lua_istable(L, -1)) {
-                lua_pop(L, 1);
-                break;
-            }
-            
-            WaveConfig wave;
-            
-            lua_getfield(L, -1, "time");
-            if (lua_isnumber(L, -1)) {
-                wave.time = (f32)lua_tonumber(L, -1);
-            }
-            lua_pop(L, 1);
-            
-            lua_getfield(L, -1, "enemies");
-            if (lua_istable(L, -1)) {
-                i32 enemyIndex = 1;
-                while (true) {
-                    lua_rawgeti(L, -1, enemyIndex);
-                    if (!lua_istable(L, -1)) {
-                        lua_pop(L, 1);
-                        break;
-                    }
-                    
-                    lua_getfield(L, -1, "type");
-                    std::string enemyType = lua_isstring(L, -1) ? lua_tostring(L, -1) : "";
-                    lua_pop(L, 1);
-                    
-                    lua_getfield(L, -1, "count");
-                    i32 count = lua_isnumber(L, -1) ? (i32)lua_tointeger(L, -1) : 1;
-                    lua_pop(L, 1);
-                    
-                    if (!enemyType.empty()) {
-                        wave.enemies.push_back({enemyType, count});
-                    }
-                    
-                    lua_pop(L, 1);
-                    enemyIndex++;
-                }
-            }
-            lua_pop(L, 1);  // pop enemies
-            
-            waves.push_back(wave);
-            
-            lua_pop(L, 1);  // pop wave
-            waveIndex++;
-        }
+    if (level.initialSun >= 0) {
+        sun = level.initialSun;
     }
-    lua_pop(L, 1);  // pop waves
     
-    lua_pop(L, 2);  // pop level and levels
+    starTime = level.starTime;
     
-    std::cout << "[Game] Loaded level " << levelId << " with " << waves.size() << " waves" << std::endl;
-    return true;
+    // 取走波次資料，上一關的一併釋放
+    waves = std::move(level.waves);
 }
 
 void Game::startLevel() {
     state = GameState::Playing;
     levelTimer = 0.0f;
+    sunTimer = 0.0f;
     currentWave = 0;
+    levelTick = 0;
+    plantsLost = 0;
     levelStarted = true;
+    random.seed(random.getSeed());
+    
+    if (recorder) {
+        recorder->clear();
+        recorder->seed = random.getSeed();
+        recorder->level = currentLevel;
+        recorder->step = timestep.getStep();
+        recorder->startSun = sun;
+    }
     
-    std::cout << "[Game] Level started!" << std::endl;
+    PL_LOG_INFO(Game, "Level started!");
+}
+
+void Game::setSeed(u64 seed) {
+    random.seed(seed);
+    seeded = true;
 }
 
 void Game::updateSun(f32 dt) {
@@ -327,7 +371,7 @@ void Game::updateSun(f32 dt) {
     if (sunTimer >= sunInterval) {
         sun += 25;
         sunTimer = 0.0f;
-        std::cout << "[Game] Generated 25 sun. Total: " << sun << std::endl;
+        PL_LOG_DEBUG(Economy, "Generated 25 sun. Total: %d", sun);
     }
 }
 
@@ -337,17 +381,21 @@ void Game::updateWaves(f32 dt) {
     auto& wave = waves[currentWave];
     
     if (levelTimer >= wave.time) {
-        std::cout << "[Game] Spawning wave " << (currentWave + 1) << std::endl;
+        PL_LOG_INFO(Spawn, "Spawning wave %d", currentWave + 1);
         
         // 生成敵人
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        std::uniform_int_distribution<i32> rowDist(0, gridConfig.rows - 1);
+        Pcg32& rng = random[RandomStream::Spawn];
         
+        const ArchetypeRegistry& registry = ArchetypeRegistry::instance();
         for (auto& [enemyId, count] : wave.enemies) {
+            ArchetypeId id = registry.findEnemy(enemyId);
+            if (id == kInvalidArchetype) {
+                PL_LOG_ERROR(Spawn, "Unknown enemy: %s", symbolName(enemyId));
+                continue;
+            }
             for (i32 i = 0; i < count; i++) {
-                i32 row = rowDist(gen);
-                spawnEnemy(enemyId, row);
+                i32 row = rng.range(0, gridConfig.rows - 1);
+                spawnEnemy(id, row);
             }
         }
         
@@ -358,9 +406,30 @@ void Game::updateWaves(f32 dt) {
 void Game::updatePlants(f32 dt) {
     findPlantTargets();
     
-    for (auto& plant : plants) {
-        if (plant->isAlive()) {
-            plant->update(dt);
+    ScriptHooks& scripts = ScriptHooks::instance();
+    const u32 count = plants.size();
+    for (u32 i = 0; i < count; i++) {
+        if (!plants.alive[i]) continue;
+        
+        // 更新攻擊計時器
+        if (plants.attackTimer[i] > 0) {
+            plants.attackTimer[i] -= dt;
+        }
+        
+        // 狀態效果（無效果時只測一個位元組）
+        StatusSet& status = plants.status[i];
+        if (status.any()) {
+            f32 dps = status.damagePerSecond();
+            status.update(dt);
+            if (dps > 0) {
+                damagePlant(i, dps * dt);
+            }
+        }
+        
+        // 沒有 on_update 的原型只測一次遮罩
+        const HookSet& hooks = plants.objects[i].getArchetype().hooks;
+        if (hooks.has(Hook::Update) && plants.alive[i]) {
+            scripts.post(Hook::Update, hooks, ScriptArg::plant(i), dt);
         }
     }
 }
@@ -368,129 +437,639 @@ void Game::updatePlants(f32 dt) {
 void Game::updateEnemies(f32 dt) {
     findEnemyTargets();
     
-    for (auto& enemy : enemies) {
-        if (enemy->isAlive()) {
-            enemy->update(dt);
-            
-            // 檢查是否到達終點
-            if (enemy->getPosition().x < 50.0f) {
-                std::cout << "[Game] Enemy reached the end! Game Over!" << std::endl;
-                state = GameState::GameOver;
+    const bool stepHooks = ScriptHooks::instance().isActive(Hook::EnemyStep);
+    const u32 count = enemies.size();
+    for (u32 i = 0; i < count; i++) {
+        if (!enemies.alive[i]) continue;
+        
+        // 更新攻擊計時器
+        if (enemies.attackTimer[i] > 0) {
+            enemies.attackTimer[i] -= dt;
+        }
+        
+        // 移動（凍結/暈眩停止，減速依狀態值扣除）
+        f32 speedMult = 1.0f;
+        StatusSet& status = enemies.status[i];
+        if (status.any()) {
+            speedMult = status.speedMultiplier();
+            f32 dps = status.damagePerSecond();
+            status.update(dt);
+            if (dps > 0) {
+                damageEnemy(i, dps * dt);
             }
         }
+        const f32 previousX = enemies.x[i];
+        enemies.x[i] -= enemies.speed[i] * speedMult * dt;
+        touchEnemyCell(i);
+        if (stepHooks) {
+            stepOnCell(i, previousX);
+        }
+        
+        // 檢查是否到達終點
+        if (enemies.x[i] < 50.0f) {
+            PL_LOG_INFO(Game, "Enemy reached the end! Game Over!");
+            state = GameState::GameOver;
+        }
     }
 }
 
 void Game::updateProjectiles(f32 dt) {
-    for (auto& proj : projectiles) {
-        if (proj->isAlive()) {
-            proj->update(dt);
+    const f32 step = projectiles.speed * dt;
+    const f32 hitExtent = kProjectileHalfExtent + kEnemyHalfExtent;
+    
+    const u32 count = projectiles.size();
+    for (u32 i = 0; i < count; i++) {
+        if (!projectiles.alive[i]) continue;
+        
+        u32 t = enemies.resolve(projectiles.target[i]);
+        if (t == kInvalidIndex || !enemies.alive[t]) {
+            projectiles.alive[i] = 0;
+            continue;
+        }
+        
+        // 朝目標移動
+        Vec2 pos = projectiles.position(i);
+        Vec2 direction = (enemies.position(t) - pos).normalized();
+        projectiles.x[i] = pos.x + direction.x * step;
+        projectiles.y[i] = pos.y + direction.y * step;
+        
+        // 檢查是否命中
+        if (std::abs(projectiles.x[i] - enemies.x[t]) < hitExtent &&
+            std::abs(projectiles.y[i] - enemies.y[t]) < hitExtent) {
+            const PlantHandle source = projectiles.source[i];
+            damageEnemy(t, projectiles.damage[i], source);
+            applyElement(t, projectiles.element[i], projectiles.damage[i], source);
+            
+            PL_LOG_DEBUG(Combat, "Projectile hit enemy for %g damage", projectiles.damage[i]);
+            
+            // 發射的植物已被移除時不呼叫
+            u32 s = plants.resolve(source);
+            if (s != kInvalidIndex) {
+                ScriptHooks::instance().post(Hook::Hit, plants.objects[s].getArchetype().hooks,
+                                             ScriptArg::plant(s), ScriptArg::enemy(t));
+            }
+            
+            projectiles.alive[i] = 0;
         }
     }
 }
 
 void Game::updateCombat(f32 dt) {
+    ScriptHooks& scripts = ScriptHooks::instance();
+    
     // 植物攻擊
-    for (auto& plant : plants) {
-        if (!plant->isAlive() || !plant->canAttack()) continue;
-        
-        auto target = plant->getTarget();
-        if (target && target->isAlive()) {
-            // 生成投射物
-            spawnProjectile(plant, target, plant->getStats().damage);
-            plant->attack();
+    for (u32 i = 0; i < plants.size(); i++) {
+        if (!plants.alive[i] || plants.attackTimer[i] > 0) continue;
+        if (!plants.status[i].canAct()) continue;
+        
+        EnemyHandle target = plants.target[i];
+        u32 t = enemies.resolve(target);
+        if (t != kInvalidIndex && enemies.alive[t]) {
+            // on_attack 取代預設的單發投射物；沒有或出錯時照常發射
+            const HookSet& hooks = plants.objects[i].getArchetype().hooks;
+            if (!scripts.call(Hook::Attack, hooks, ScriptArg::plant(i), ScriptArg::enemy(t))) {
+                spawnProjectile(plants.position(i), target, rollCrit(i, plants.objects[i].getStats().damage),
+                                plants.element[i], plants.handleAt(i));
+            }
+            plants.attackTimer[i] = plants.objects[i].getAttackInterval();
         }
     }
     
     // 敵人攻擊
-    for (auto& enemy : enemies) {
-        if (!enemy->isAlive() || !enemy->canAttack()) continue;
+    for (u32 i = 0; i < enemies.size(); i++) {
+        if (!enemies.alive[i] || enemies.attackTimer[i] > 0) continue;
+        if (!enemies.status[i].canAct()) continue;
+        
+        u32 target = plants.resolve(enemies.target[i]);
+        if (target == kInvalidIndex || !plants.alive[target]) continue;
+        
+        // 攻擊目標植物（回呼可能生成敵人，不保留 objects 的引用）
+        const f32 damage = enemies.objects[i].getStats().damage;
+        const Symbol enemyId = enemies.objects[i].getEnemyId();
+        damagePlant(target, damage);
         
-        enemy->attack();
+        // 重置攻擊計時器
+        enemies.attackTimer[i] = 1.0f;  // 1秒攻擊間隔
+        
+        PL_LOG_DEBUG(Combat, "%s attacks plant for %g damage", symbolName(enemyId), damage);
+    }
+}
+
+void Game::spawnProjectile(const Vec2& origin, EnemyHandle target, f32 damage, Element element, PlantHandle source) {
+    projectiles.add(origin, target, damage, element, source);
+}
+
+f32 Game::rollCrit(u32 plantIndex, f32 damage) {
+    // 發射時決定，投射物帶著最終傷害飛行
+    const Stats& stats = plants.objects[plantIndex].getStats();
+    if (stats.critRate > 0.0f && random[RandomStream::Combat].chance(stats.critRate)) {
+        return damage * stats.critMult;
     }
+    return damage;
+}
+
+void Game::addStatus(EnemyHandle enemy, const StatusEffect& effect) {
+    u32 index = enemies.resolve(enemy);
+    if (index == kInvalidIndex) return;
+    
+    u8 maxStacks = effect.type == StatusType::Poison ? elementConfig.poisonStackMax : 1;
+    enemies.status[index].add(effect, maxStacks);
 }
 
-void Game::spawnProjectile(PlantPtr source, EnemyPtr target, f32 damage) {
-    auto proj = std::make_shared<Projectile>(source->getPosition(), target, damage);
-    projectiles.push_back(proj);
+void Game::addStatus(PlantHandle plant, const StatusEffect& effect) {
+    u32 index = plants.resolve(plant);
+    if (index == kInvalidIndex) return;
+    
+    u8 maxStacks = effect.type == StatusType::Poison ? elementConfig.poisonStackMax : 1;
+    plants.status[index].add(effect, maxStacks);
+}
+
+void Game::applyElement(u32 enemyIndex, Element element, f32 damage, PlantHandle source) {
+    if (!enemies.alive[enemyIndex]) return;
+    
+    StatusSet& status = enemies.status[enemyIndex];
+    const ElementConfig& cfg = elementConfig;
+    
+    switch (element) {
+        case Element::Fire:
+            status.add(StatusEffect(StatusType::Burn, cfg.burnDuration, damage * cfg.burnDamage));
+            break;
+        case Element::Ice: {
+            status.add(StatusEffect(StatusType::Slow, cfg.slowDuration, cfg.slowAmount));
+            
+            if (random[RandomStream::Combat].chance(cfg.freezeChance)) {
+                status.add(StatusEffect(StatusType::Freeze, cfg.freezeDuration, 0.0f));
+            }
+            break;
+        }
+        case Element::Poison:
+            status.add(StatusEffect(StatusType::Poison, cfg.poisonDuration, damage * cfg.poisonDamage),
+                       cfg.poisonStackMax);
+            break;
+        case Element::Lightning:
+            chainLightning(enemyIndex, damage, source);
+            break;
+        default:
+            break;
+    }
+}
+
+void Game::chainLightning(u32 enemyIndex, f32 damage, PlantHandle source) {
+    const ElementConfig& cfg = elementConfig;
+    const u32 k = std::min(cfg.chainCount + 1, kMaxNearest);
+    
+    // 從被擊中的敵人跳向最近的鄰居，每跳傷害衰減
+    u32 ids[kMaxNearest];
+    f32 distSq[kMaxNearest];
+    u32 found = enemyHash.kNearest(enemies.position(enemyIndex), k, cfg.chainRange, ids, distSq);
+    
+    f32 chainDamage = damage;
+    u32 jumps = 0;
+    for (u32 n = 0; n < found && jumps < cfg.chainCount; n++) {
+        u32 e = ids[n];
+        if (e == enemyIndex || e >= enemies.size() || !enemies.alive[e]) continue;
+        chainDamage *= cfg.chainDecay;
+        damageEnemy(e, chainDamage, source);
+        jumps++;
+    }
+}
+
+void Game::logProjectileStats() const {
+    const auto& poolStats = projectiles.getStats();
+    if (poolStats.spawned == 0) return;
+    
+    PL_LOG_INFO(Game, "Projectile pool: high water %u / %u, dropped %llu",
+                poolStats.highWater, poolStats.capacity, (unsigned long long)poolStats.dropped);
+}
+
+void Game::damagePlant(u32 index, f32 damage) {
+    ScriptHooks& scripts = ScriptHooks::instance();
+    const Plant& plant = plants.objects[index];
+    const HookSet& hooks = plant.getArchetype().hooks;
+    
+    // on_damage 回傳實際傷害（取代護甲減傷）
+    if (!scripts.filter(Hook::Damage, hooks, ScriptArg::plant(index), damage)) {
+        damage *= 1.0f - plant.getStats().armor / 100.0f;
+    }
+    plants.hp[index] -= damage;
+    
+    if (plants.hp[index] <= 0) {
+        plants.hp[index] = 0;
+        if (!plants.alive[index]) return;
+        
+        // on_death 在標記死亡前同步呼叫：回傳 false 且補回血量時不死亡（鳳凰花復活）
+        if (!scripts.confirm(Hook::Death, hooks, ScriptArg::plant(index)) && plants.hp[index] > 0) {
+            PL_LOG_DEBUG(Combat, "%s death cancelled by script", symbolName(plants.objects[index].getPlantId()));
+            return;
+        }
+        plants.hp[index] = 0;
+        plants.alive[index] = 0;
+        plantsLost++;
+        PL_LOG_DEBUG(Combat, "%s destroyed", symbolName(plants.objects[index].getPlantId()));
+    }
+}
+
+void Game::damageEnemy(u32 index, f32 damage, PlantHandle source) {
+    enemies.hp[index] -= enemies.objects[index].mitigate(damage);
+    
+    if (enemies.hp[index] <= 0) {
+        enemies.hp[index] = 0;
+        if (!enemies.alive[index]) return;
+        enemies.alive[index] = 0;
+        
+        const EnemyArchetype& archetype = enemies.objects[index].getArchetype();
+        PL_LOG_DEBUG(Combat, "%s defeated", symbolName(archetype.id));
+        
+        ScriptHooks& scripts = ScriptHooks::instance();
+        scripts.post(Hook::Death, archetype.hooks, ScriptArg::enemy(index));
+        
+        u32 killer = plants.resolve(source);
+        if (killer != kInvalidIndex) {
+            scripts.post(Hook::Kill, plants.objects[killer].getArchetype().hooks,
+                         ScriptArg::plant(killer), ScriptArg::enemy(index));
+        }
+    }
+}
+
+void Game::stepOnCell(u32 e, f32 previousX) {
+    // 只在跨入新的一格時檢查；飛行敵人不會踩到地面
+    if (enemies.behavior[e] == EnemyBehavior::Flyer) return;
+    
+    const i32 col = (i32)std::floor((enemies.x[e] - gridConfig.offsetX) / gridConfig.cellWidth);
+    const i32 previousCol = (i32)std::floor((previousX - gridConfig.offsetX) / gridConfig.cellWidth);
+    if (col == previousCol) return;
+    
+    const GridCoord coord(col, enemies.row[e]);
+    if (!isValidGridPosition(coord)) return;
+    
+    u32 p = plants.resolve(grid.get(coord, GridLayer::Ground));
+    if (p == kInvalidIndex || !plants.alive[p]) return;
+    
+    ScriptHooks::instance().post(Hook::EnemyStep, plants.objects[p].getArchetype().hooks,
+                                 ScriptArg::plant(p), ScriptArg::enemy(e));
 }
 
 void Game::findPlantTargets() {
-    for (auto& plant : plants) {
-        if (!plant->isAlive()) continue;
+    for (u32 p = 0; p < plants.size(); p++) {
+        if (!plants.alive[p]) continue;
         
-        EnemyPtr closest = nullptr;
-        f32 closestDist = plant->getStats().range;
+        const f32 range = plants.range[p];
         
-        for (auto& enemy : enemies) {
-            if (!enemy->isAlive()) continue;
+        // 沒有被喚醒時：閒置植物直接略過，有目標的只檢查目標是否仍有效
+        if (!plants.retarget[p]) {
+            EnemyHandle current = plants.target[p];
+            if (current.isNull()) continue;
             
-            f32 dist = plant->getPosition().distanceSq(enemy->getPosition());
-            if (dist < closestDist * closestDist) {
-                closestDist = std::sqrt(dist);
-                closest = enemy;
+            u32 t = enemies.resolve(current);
+            if (t != kInvalidIndex && enemies.alive[t] &&
+                plants.position(p).distanceSq(enemies.position(t)) < range * range) {
+                continue;
             }
         }
         
-        plant->setTarget(closest);
+        u32 closest = findPlantTarget(p);
+        plants.target[p] = closest != kInvalidIndex ? enemies.handleAt(closest) : EnemyHandle();
+        retargetStats.plants++;
+        
+        // 沒有目標但射程附近的桶內仍有敵人：敵人可能在桶內走進射程，下一幀繼續檢查
+        const f32 px = plants.x[p];
+        const f32 py = plants.y[p];
+        plants.retarget[p] = closest == kInvalidIndex &&
+            enemyHash.countInCells(px - range, py - range, px + range, py + range) > 0;
     }
 }
 
+u32 Game::findPlantTarget(u32 p) const {
+    const i32 rows = lanes.getRows();
+    const Vec2 origin = plants.position(p);
+    const f32 range = plants.range[p];
+    u32 closest = kInvalidIndex;
+    f32 closestDistSq = range * range;
+    
+    // 只看與射程圓相交的行；行內從二分搜尋位置往左右找第一個存活者
+    for (i32 r = 0; r < rows; r++) {
+        f32 dy = rowCenterY(r) - origin.y;
+        f32 dySq = dy * dy;
+        if (dySq >= closestDistSq) continue;
+        
+        const auto& lane = lanes.lane(r);
+        u32 k = lanes.lowerBound(r, origin.x);
+        
+        for (u32 j = k; j < lane.size(); j++) {
+            f32 dx = lane[j].x - origin.x;
+            f32 distSq = dx * dx + dySq;
+            if (distSq >= closestDistSq) break;
+            if (!enemies.alive[lane[j].dense]) continue;
+            closestDistSq = distSq;
+            closest = lane[j].dense;
+            break;
+        }
+        
+        for (u32 j = k; j-- > 0; ) {
+            f32 dx = lane[j].x - origin.x;
+            f32 distSq = dx * dx + dySq;
+            if (distSq >= closestDistSq) break;
+            if (!enemies.alive[lane[j].dense]) continue;
+            closestDistSq = distSq;
+            closest = lane[j].dense;
+            break;
+        }
+    }
+    
+    return closest;
+}
+
 void Game::findEnemyTargets() {
-    for (auto& enemy : enemies) {
-        if (!enemy->isAlive()) continue;
+    const f32 firstColX = colCenterX(0);
+    
+    for (u32 e = 0; e < enemies.size(); e++) {
+        if (!enemies.alive[e]) continue;
         
-        // 找同一行的植物
-        PlantPtr target = nullptr;
-        f32 minDist = 100.0f;  // 攻擊範圍
+        const i32 row = enemies.row[e];
+        const bool validRow = row >= 0 && row < lanes.getRows();
+        const u64 mask = validRow ? lanes.rowMask(row) : 0;
         
-        for (auto& plant : plants) {
-            if (!plant->isAlive()) continue;
+        // 整行沒有植物：沒有可追蹤的對象
+        if (!mask) {
+            enemies.target[e] = PlantHandle();
+            continue;
+        }
+        
+        // 攻擊範圍最左格改變（往左走進新格）、該行佔用改變或目標失效時才重新選
+        const f32 ex = enemies.x[e];
+        const i32 firstCol = std::max(0, (i32)std::ceil((ex - kEnemyAttackRange - firstColX) / gridConfig.cellWidth));
+        bool dirty = enemies.retarget[e] || lanes.occupancyChanged(row) || firstCol != enemies.scanCol[e];
+        
+        if (!dirty) {
+            PlantHandle current = enemies.target[e];
+            if (current.isNull()) continue;
             
-            // 檢查是否同一行
-            if (plant->getGridPosition().row == enemy->getRow()) {
-                f32 dist = enemy->getPosition().distance(plant->getPosition());
-                if (dist < minDist) {
-                    minDist = dist;
-                    target = plant;
-                }
+            u32 t = plants.resolve(current);
+            if (t != kInvalidIndex && plants.alive[t] && std::abs(plants.x[t] - ex) < kEnemyAttackRange) {
+                continue;
             }
         }
         
-        enemy->setTargetPlant(target);
+        enemies.target[e] = findEnemyTarget(e, mask, firstCol);
+        enemies.scanCol[e] = firstCol;
+        enemies.retarget[e] = 0;
+        retargetStats.enemies++;
+    }
+    
+    lanes.clearOccupancyChanged();
+}
+
+PlantHandle Game::findEnemyTarget(u32 e, u64 mask, i32 firstCol) const {
+    const f32 firstColX = colCenterX(0);
+    const f32 ex = enemies.x[e];
+    const i32 row = enemies.row[e];
+    const i32 lastCol = std::min(gridConfig.cols - 1, (i32)std::floor((ex + kEnemyAttackRange - firstColX) / gridConfig.cellWidth));
+    
+    // 同一行、攻擊範圍內的格子
+    PlantHandle target;
+    f32 minDist = kEnemyAttackRange;
+    for (i32 c = firstCol; c <= lastCol; c++) {
+        if (!((mask >> c) & 1u)) continue;
+        
+        f32 dist = std::abs(colCenterX(c) - ex);
+        if (dist >= minDist) continue;
+        
+        // 覆蓋層（南瓜罩）擋在地面植物前面
+        const GridCoord coord(c, row);
+        PlantHandle handle = grid.get(coord, GridLayer::Overlay);
+        if (!plants.isAlive(handle)) {
+            handle = grid.get(coord, GridLayer::Ground);
+            if (!plants.isAlive(handle)) continue;
+        }
+        
+        minDist = dist;
+        target = handle;
     }
+    
+    return target;
+}
+
+void Game::touchEnemyCell(u32 e) {
+    u32 cell = enemyHash.cellOf(enemies.x[e], enemies.y[e]);
+    if (cell == enemies.cell[e]) return;
+    
+    // 跨入新桶：喚醒射程覆蓋這個桶的植物
+    enemies.cell[e] = cell;
+    retargetStats.cellEvents++;
+    plantWatchers.forEachWatcher(cell, [&](u32 p) {
+        if (p < plants.size()) {
+            plants.retarget[p] = 1;
+        }
+    });
 }
 
 void Game::cleanupDeadEntities() {
-    // 清理死亡的植物
-    plants.erase(
-        std::remove_if(plants.begin(), plants.end(),
-            [](const PlantPtr& p) { return !p->isAlive(); }),
-        plants.end()
-    );
+    ScriptHooks& scripts = ScriptHooks::instance();
+    
+    // 清理死亡的植物（同時移出網格）
+    for (u32 i = plants.size(); i-- > 0; ) {
+        if (plants.alive[i]) continue;
+        
+        GridCoord coord = plants.objects[i].getGridPosition();
+        if (grid.erase(coord, plants.objects[i].getLayer(), plants.handleAt(i))) {
+            syncLaneOccupancy(coord);
+        }
+        scripts.releaseInstance(plants.handleAt(i));
+        plants.removeAt(i);
+        plantHashDirty = true;
+    }
     
     // 清理死亡的敵人
-    enemies.erase(
-        std::remove_if(enemies.begin(), enemies.end(),
-            [](const EnemyPtr& e) { return !e->isAlive(); }),
-        enemies.end()
-    );
+    for (u32 i = enemies.size(); i-- > 0; ) {
+        if (!enemies.alive[i]) {
+            scripts.releaseInstance(enemies.handleAt(i));
+            enemies.removeAt(i);
+        }
+    }
     
     // 清理完成的投射物
-    projectiles.erase(
-        std::remove_if(projectiles.begin(), projectiles.end(),
-            [](const ProjectilePtr& p) { return !p->isAlive(); }),
-        projectiles.end()
-    );
+    for (u32 i = projectiles.size(); i-- > 0; ) {
+        if (!projectiles.alive[i]) {
+            projectiles.removeAt(i);
+        }
+    }
+}
+
+// ============================================
+// 空間查詢
+// ============================================
+
+namespace {
+
+// 索引中的 dense index 可能已被 swap-remove 搬動，需確認仍在範圍且存活
+template<typename Store, typename H>
+u32 collectHandles(const Store& store, const SpatialHash& hash, H* out, u32 maxOut,
+                   const Vec2& center, f32 radius) {
+    u32 n = 0;
+    hash.forEachInRadius(center, radius, [&](u32 i, f32) {
+        if (n < maxOut && i < store.size() && store.alive[i]) {
+            out[n++] = store.handleAt(i);
+        }
+    });
+    return n;
+}
+
+template<typename Store, typename H>
+u32 collectHandles(const Store& store, const SpatialHash& hash, H* out, u32 maxOut,
+                   const Vec2& min, const Vec2& max) {
+    u32 n = 0;
+    hash.forEachInRect(min.x, min.y, max.x, max.y, [&](u32 i) {
+        if (n < maxOut && i < store.size() && store.alive[i]) {
+            out[n++] = store.handleAt(i);
+        }
+    });
+    return n;
+}
+
+} // namespace
+
+void Game::resizeGrid(i32 cols, i32 rows) {
+    if (cols > LaneIndex::kMaxCols) {
+        PL_LOG_WARN(Game, "Grid has %d columns, clamping to %d", cols, LaneIndex::kMaxCols);
+        cols = LaneIndex::kMaxCols;
+    }
+    
+    // 舊網格上的實體位置已不適用（排隊中的腳本事件一併丟棄）
+    plants.clear();
+    enemies.clear();
+    projectiles.clear();
+    ScriptHooks::instance().discard();
+    ScriptHooks::instance().clearInstances();
+    
+    gridConfig.cols = cols;
+    gridConfig.rows = rows;
+    grid.reset(cols, rows);
+    lanes.reset(rows);
+    configureSpatial();
+    rebuildSpatial();
+}
+
+u32 Game::refreshArchetypes(const std::vector<ArchetypeId>& plantIds, const std::vector<ArchetypeId>& enemyIds) {
+    const ArchetypeRegistry& registry = ArchetypeRegistry::instance();
+    std::vector<u8> changed;
+    u32 patched = 0;
+    
+    changed.assign(registry.getPlantCount(), 0);
+    for (ArchetypeId id : plantIds) changed[id] = 1;
+    for (u32 i = 0; i < plants.size() && !plantIds.empty(); i++) {
+        Plant& plant = plants.objects[i];
+        if (!changed[plant.getArchetypeId()]) continue;
+        
+        const Stats& base = plant.getArchetype().stats;
+        const f32 ratio = plants.maxHp[i] > 0.0f ? plants.hp[i] / plants.maxHp[i] : 1.0f;
+        plant.getStats() = base;
+        plants.maxHp[i] = base.maxHp;
+        plants.hp[i] = ratio * base.maxHp;
+        if (plants.range[i] != base.range) {
+            plants.range[i] = base.range;
+            plantHashDirty = true;  // 射程變了，觀察的桶要重算
+        }
+        plants.element[i] = plant.getElement();
+        plants.retarget[i] = 1;
+        patched++;
+    }
+    
+    changed.assign(registry.getEnemyCount(), 0);
+    for (ArchetypeId id : enemyIds) changed[id] = 1;
+    for (u32 i = 0; i < enemies.size() && !enemyIds.empty(); i++) {
+        Enemy& enemy = enemies.objects[i];
+        if (!changed[enemy.getArchetypeId()]) continue;
+        
+        const Stats& base = enemy.getArchetype().stats;
+        const f32 ratio = enemies.maxHp[i] > 0.0f ? enemies.hp[i] / enemies.maxHp[i] : 1.0f;
+        enemy.getStats() = base;
+        enemies.maxHp[i] = base.maxHp;
+        enemies.hp[i] = ratio * base.maxHp;
+        enemies.speed[i] = base.speed;
+        enemies.behavior[i] = enemy.getBehavior();
+        enemies.retarget[i] = 1;
+        patched++;
+    }
+    
+    return patched;
+}
+
+void Game::configureSpatial() {
+    // 覆蓋整個戰場：網格加上右側的敵人生成區
+    const f32 cellSize = 100.0f;
+    const f32 width = kEnemySpawnX + cellSize;
+    const f32 height = gridConfig.offsetY * 2 + gridConfig.rows * gridConfig.cellHeight;
+    enemyHash.configure(0.0f, 0.0f, width, height, cellSize);
+    plantHash.configure(0.0f, 0.0f, width, height, cellSize);
+    plantHashDirty = true;
+}
+
+void Game::rebuildSpatial() {
+    enemyHash.build(enemies.x.data(), enemies.y.data(), enemies.alive.data(), enemies.size());
+    enemyHashDirty = false;
+    
+    // 植物不會移動，只在數量變化時重建
+    if (plantHashDirty) {
+        plantHash.build(plants.x.data(), plants.y.data(), plants.alive.data(), plants.size());
+        plantWatchers.build(plants, enemyHash);
+        plantHashDirty = false;
+    }
+}
+
+u32 Game::queryRadius(const Vec2& center, f32 radius, EnemyHandle* out, u32 maxOut) const {
+    return collectHandles(enemies, enemyHash, out, maxOut, center, radius);
+}
+
+u32 Game::queryRadius(const Vec2& center, f32 radius, PlantHandle* out, u32 maxOut) const {
+    return collectHandles(plants, plantHash, out, maxOut, center, radius);
+}
+
+u32 Game::queryRect(const Vec2& min, const Vec2& max, EnemyHandle* out, u32 maxOut) const {
+    return collectHandles(enemies, enemyHash, out, maxOut, min, max);
+}
+
+u32 Game::queryRect(const Vec2& min, const Vec2& max, PlantHandle* out, u32 maxOut) const {
+    return collectHandles(plants, plantHash, out, maxOut, min, max);
+}
+
+u32 Game::queryCone(const Vec2& origin, f32 angle, f32 range, EnemyHandle* out, u32 maxOut) const {
+    // 半徑內的敵人再以 |dy| <= dx * tan(半角) 過濾
+    const f32 slope = std::tan(std::clamp(angle, 0.0f, 179.0f) * 0.5f * 3.14159265f / 180.0f);
+    u32 n = 0;
+    enemyHash.forEachInRadius(origin, range, [&](u32 i, f32) {
+        if (n >= maxOut || i >= enemies.size() || !enemies.alive[i]) return;
+        const f32 dx = enemies.x[i] - origin.x;
+        const f32 dy = enemies.y[i] - origin.y;
+        if (dx > 0.0f && std::abs(dy) <= dx * slope) {
+            out[n++] = enemies.handleAt(i);
+        }
+    });
+    return n;
+}
+
+u32 Game::kNearest(const Vec2& center, u32 k, f32 maxRadius, EnemyHandle* out) const {
+    // 單一最近目標走 SIMD 路徑；tick 中途死亡的敵人仍在索引內，此時退回一般路徑
+    if (k == 1) {
+        u32 i = enemyHash.nearest(center, maxRadius);
+        if (i == kInvalidIndex) return 0;
+        if (i < enemies.size() && enemies.alive[i]) {
+            out[0] = enemies.handleAt(i);
+            return 1;
+        }
+    }
+    
+    u32 ids[kMaxNearest];
+    f32 distSq[kMaxNearest];
+    u32 found = enemyHash.kNearest(center, std::min(k, kMaxNearest), maxRadius, ids, distSq);
     
-    // 清理網格中的死亡植物
-    for (auto it = grid.begin(); it != grid.end(); ) {
-        if (!it->second->isAlive()) {
-            it = grid.erase(it);
-        } else {
-            ++it;
+    u32 n = 0;
+    for (u32 j = 0; j < found; j++) {
+        u32 i = ids[j];
+        if (i < enemies.size() && enemies.alive[i]) {
+            out[n++] = enemies.handleAt(i);
         }
     }
+    return n;
 }
 
 } // namespace PL
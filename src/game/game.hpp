@@ -7,22 +7,21 @@
 #include "core/types.hpp"
 #include "game/plant.hpp"
 #include "game/enemy.hpp"
+#include "game/archetype.hpp"
+#include "game/game_data.hpp"
+#include "game/entity_store.hpp"
+#include "game/lane_index.hpp"
+#include "game/retarget.hpp"
+#include "game/plant_grid.hpp"
+#include "core/spatial_hash.hpp"
+#include "core/fixed_timestep.hpp"
+#include "core/random.hpp"
+#include "game/replay.hpp"
 #include <vector>
 #include <memory>
-#include <unordered_map>
 
 namespace PL {
 
-// 網格配置
-struct GridConfig {
-    i32 cols = 9;
-    i32 rows = 5;
-    f32 cellWidth = 80.0f;
-    f32 cellHeight = 100.0f;
-    f32 offsetX = 100.0f;
-    f32 offsetY = 100.0f;
-};
-
 // 遊戲狀態
 enum class GameState {
     Menu,
@@ -32,12 +31,6 @@ enum class GameState {
     Victory
 };
 
-// 波次配置
-struct WaveConfig {
-    f32 time = 0.0f;
-    std::vector<std::pair<std::string, i32>> enemies;  // enemyId, count
-};
-
 class Game {
 public:
     Game();
@@ -48,67 +41,140 @@ public:
     void shutdown();
     
     // 遊戲循環
-    void update(f32 dt);
+    void update(f32 dt);   // 執行一個 tick
     void render();
     
+    // 以固定步長推進：累加幀時間並執行整數個 tick（每幀有上限），回傳執行的 tick 數
+    u32 advance(f32 frameDt);
+    const FixedTimestep& getTimestep() const { return timestep; }
+    f32 getInterpolationAlpha() const { return timestep.getAlpha(); }  // 渲染插值 0..1
+    
     // 狀態
     GameState getState() const { return state; }
     void setState(GameState s) { state = s; }
     
     // 網格
+    const GridConfig& getGridConfig() const { return gridConfig; }
     Vec2 gridToWorld(const GridCoord& coord) const;
     GridCoord worldToGrid(const Vec2& pos) const;
     bool isValidGridPosition(const GridCoord& coord) const;
-    bool isGridOccupied(const GridCoord& coord) const;
+    bool isGridOccupied(const GridCoord& coord, GridLayer layer = GridLayer::Ground) const;
     
     // 植物
     bool placePlant(const std::string& plantId, const GridCoord& coord);
-    void removePlant(const GridCoord& coord);
-    PlantPtr getPlantAt(const GridCoord& coord) const;
-    const std::vector<PlantPtr>& getPlants() const { return plants; }
+    bool placePlant(ArchetypeId plant, const GridCoord& coord);
+    bool removePlant(const GridCoord& coord);  // 移除最上層的植物，格子是空的回傳 false
+    PlantHandle getPlantAt(const GridCoord& coord, GridLayer layer = GridLayer::Ground) const;
+    const PlantStore& getPlants() const { return plants; }
     
     // 敵人
     void spawnEnemy(const std::string& enemyId, i32 row);
-    const std::vector<EnemyPtr>& getEnemies() const { return enemies; }
+    void spawnEnemy(ArchetypeId enemy, i32 row, f32 x = kEnemySpawnX);
+    const EnemyStore& getEnemies() const { return enemies; }
+    
+    // 句柄存活檢查（O(1)，不觸碰引用計數）
+    bool isAlive(PlantHandle handle) const { return plants.isAlive(handle); }
+    bool isAlive(EnemyHandle handle) const { return enemies.isAlive(handle); }
     
     // 投射物
-    const std::vector<ProjectilePtr>& getProjectiles() const { return projectiles; }
+    const ProjectilePool& getProjectiles() const { return projectiles; }
+    const ProjectilePoolStats& getProjectileStats() const { return projectiles.getStats(); }
     
     // 資源
     i32 getSun() const { return sun; }
     void addSun(i32 amount) { sun += amount; }
+    void collectSun(i32 amount);  // 玩家拾取陽光（會被錄製；addSun 是遊戲內部的增減）
     bool spendSun(i32 amount);
     
     // 關卡
-    bool loadLevel(const std::string& levelId);
-    void startLevel();
+    bool loadLevel(const std::string& levelId);  // 經 LevelLoader 按需載入單一關卡
+    void applyLevel(LevelData& level);           // 取走 level 的波次資料
+    void unloadLevel();                          // 釋放目前關卡資料
+    Symbol getCurrentLevel() const { return currentLevel; }
+    void startLevel();                           // 各亂數子串流從種子重新開始
+    f32 getLevelTime() const { return levelTimer; }
+    u64 getLevelTick() const { return levelTick; }      // 本關已執行的 tick 數
+    i32 getCurrentWave() const { return currentWave; }  // 已生成的波次數
+    i32 getWaveCount() const { return (i32)waves.size(); }
+    u32 getPlantsLost() const { return plantsLost; }    // 本關被摧毀的植物數（不含玩家移除）
+    f32 getStarTime() const { return starTime; }        // 限時星級的時限（0 = 無）
+    
+    // 重播錄製：startLevel 時寫入種子與關卡，之後的玩家輸入（放置、移除、拾取陽光）
+    // 以 tick 為時間戳附加到 replay。須在 startLevel 之前設定；nullptr 停止錄製
+    void setRecorder(Replay* replay) { recorder = replay; }
+    
+    // 亂數：同一種子 + 同一操作序列得到逐位元相同的結果
+    void setSeed(u64 seed);
+    u64 getSeed() const { return random.getSeed(); }
+    Pcg32& getRandom(RandomStream stream) { return random[stream]; }
     
     // 戰鬥
     void updateCombat(f32 dt);
     
     // 投射物
-    void spawnProjectile(PlantPtr source, EnemyPtr target, f32 damage);
+    void spawnProjectile(const Vec2& origin, EnemyHandle target, f32 damage, Element element = Element::None,
+                         PlantHandle source = PlantHandle());
+    
+    // 狀態效果
+    void addStatus(EnemyHandle enemy, const StatusEffect& effect);
+    void addStatus(PlantHandle plant, const StatusEffect& effect);
+    
+    // 空間查詢（範圍目標、AoE、光環）
+    // 結果寫入呼叫端的緩衝區，回傳寫入數量，不配置記憶體。
+    // 敵人索引每 tick 結束時重建；植物索引在放置/移除後重建。
+    static constexpr u32 kMaxNearest = 32;
+    u32 queryRadius(const Vec2& center, f32 radius, EnemyHandle* out, u32 maxOut) const;
+    u32 queryRadius(const Vec2& center, f32 radius, PlantHandle* out, u32 maxOut) const;
+    u32 queryRect(const Vec2& min, const Vec2& max, EnemyHandle* out, u32 maxOut) const;
+    u32 queryRect(const Vec2& min, const Vec2& max, PlantHandle* out, u32 maxOut) const;
+    u32 kNearest(const Vec2& center, u32 k, f32 maxRadius, EnemyHandle* out) const;  // k <= kMaxNearest，依距離排序
+    // 從 origin 朝 +x（敵人來向）張開 angle 度、長 range 的扇形
+    u32 queryCone(const Vec2& origin, f32 angle, f32 range, EnemyHandle* out, u32 maxOut) const;
+    
+    // 本幀重新選目標統計
+    const RetargetStats& getRetargetStats() const { return retargetStats; }
+    
+    // 熱重載後以原型的新基礎數值更新存活實體（血量依比例縮放），回傳更新的實體數
+    u32 refreshArchetypes(const std::vector<ArchetypeId>& plantIds, const std::vector<ArchetypeId>& enemyIds);
     
 private:
+    friend class ScriptHooks;  // 腳本回呼直接讀寫 SoA
+    
     GameState state = GameState::Menu;
+    FixedTimestep timestep;
+    GameRandom random;
+    bool seeded = false;                         // setSeed 呼叫過則不再以硬體亂數播種
+    Replay* recorder = nullptr;
     
     // 網格
     GridConfig gridConfig;
-    std::unordered_map<i32, PlantPtr> grid;  // key = row * cols + col
-    
-    // 實體
-    std::vector<PlantPtr> plants;
-    std::vector<EnemyPtr> enemies;
-    std::vector<ProjectilePtr> projectiles;
+    ElementConfig elementConfig;
+    PlantGrid grid;                              // 每格每圖層的植物句柄
+    LaneIndex lanes;                             // 每行敵人（依 x 排序）與植物佔用
+    SpatialHash enemyHash;                       // 敵人位置桶
+    SpatialHash plantHash;                       // 植物位置桶
+    bool plantHashDirty = true;
+    bool enemyHashDirty = true;                  // 上次重建後有新敵人
+    CellWatchers plantWatchers;                  // 桶 -> 觀察的植物
+    RetargetStats retargetStats;
+    
+    // 實體（SoA）
+    PlantStore plants;
+    EnemyStore enemies;
+    ProjectilePool projectiles;
+    u32 projectilePoolSize = 1024;  // config.global.projectile_pool_size，關卡可覆寫
     
     // 資源
     i32 sun = 50;
     
     // 關卡
-    std::string currentLevelId;
+    Symbol currentLevel = kNoSymbol;
     std::vector<WaveConfig> waves;
     i32 currentWave = 0;
     f32 levelTimer = 0.0f;
+    u64 levelTick = 0;
+    f32 starTime = 0.0f;
+    u32 plantsLost = 0;
     bool levelStarted = false;
     
     // 陽光生成
@@ -124,11 +190,33 @@ private:
     
     void findPlantTargets();
     void findEnemyTargets();
+    u32 findPlantTarget(u32 plantIndex) const;
+    PlantHandle findEnemyTarget(u32 enemyIndex, u64 rowMask, i32 firstCol) const;
+    void touchEnemyCell(u32 enemyIndex);
+    
+    void logProjectileStats() const;
+    f32 rollCrit(u32 plantIndex, f32 damage);    // 依植物爆擊率擲骰，回傳最終傷害
+    void record(ReplayCommand command, const GridCoord& coord, Symbol plant = kNoSymbol, i32 amount = 0);
+    
+    // source 為造成傷害的植物（擊殺回呼用，可為空）
+    void damagePlant(u32 index, f32 damage);
+    void damageEnemy(u32 index, f32 damage, PlantHandle source = PlantHandle());
+    void applyElement(u32 enemyIndex, Element element, f32 damage, PlantHandle source = PlantHandle());
     
     void cleanupDeadEntities();
+    void configureSpatial();
+    void resizeGrid(i32 cols, i32 rows);
+    void syncLaneOccupancy(const GridCoord& coord);
+    void rebuildSpatial();
+    void chainLightning(u32 enemyIndex, f32 damage, PlantHandle source);
+    void stepOnCell(u32 enemyIndex, f32 previousX);
+    
+    f32 rowCenterY(i32 row) const {
+        return gridConfig.offsetY + row * gridConfig.cellHeight + gridConfig.cellHeight / 2;
+    }
     
-    i32 gridToKey(const GridCoord& coord) const {
-        return coord.row * gridConfig.cols + coord.col;
+    f32 colCenterX(i32 col) const {
+        return gridConfig.offsetX + col * gridConfig.cellWidth + gridConfig.cellWidth / 2;
     }
 };
 
@@ -0,0 +1,304 @@
+// ============================================
+// Plant Legends - Game Data Implementation
+// ============================================
+
+#include "game/game_data.hpp"
+#include <algorithm>
+#include <cstring>
+
+extern "C" {
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+
+namespace PL {
+
+bool readConfig(lua_State* L, GameConfig& out) {
+    lua_getglobal(L, "config");
+    bool found = lua_istable(L, -1);
+    if (found) {
+        // 讀取網格配置
+        lua_getfield(L, -1, "global");
+        if (lua_istable(L, -1)) {
+            lua_getfield(L, -1, "grid_cols");
+            if (lua_isnumber(L, -1)) {
+                out.grid.cols = (i32)lua_tointeger(L, -1);
+            }
+            lua_pop(L, 1);
+            
+            lua_getfield(L, -1, "grid_rows");
+            if (lua_isnumber(L, -1)) {
+                out.grid.rows = (i32)lua_tointeger(L, -1);
+            }
+            lua_pop(L, 1);
+            
+            lua_getfield(L, -1, "cell_width");
+            if (lua_isnumber(L, -1)) {
+                out.grid.cellWidth = (f32)lua_tonumber(L, -1);
+            }
+            lua_pop(L, 1);
+            
+            lua_getfield(L, -1, "cell_height");
+            if (lua_isnumber(L, -1)) {
+                out.grid.cellHeight = (f32)lua_tonumber(L, -1);
+            }
+            lua_pop(L, 1);
+            
+            // 初始陽光
+            lua_getfield(L, -1, "starting_sun");
+            if (lua_isnumber(L, -1)) {
+                out.startingSun = (i32)lua_tointeger(L, -1);
+            }
+            lua_pop(L, 1);
+            
+            // 陽光生成間隔
+            lua_getfield(L, -1, "sun_generation_interval");
+            if (lua_isnumber(L, -1)) {
+                out.sunInterval = (f32)lua_tonumber(L, -1);
+            }
+            lua_pop(L, 1);
+            
+            // 投射物池容量
+            lua_getfield(L, -1, "projectile_pool_size");
+            if (lua_isnumber(L, -1)) {
+                out.projectilePoolSize = (u32)lua_tointeger(L, -1);
+            }
+            lua_pop(L, 1);
+            
+            // 每幀 Lua GC 上限
+            lua_getfield(L, -1, "lua_gc_max_ms");
+            if (lua_isnumber(L, -1)) {
+                out.luaGcMaxMs = (f32)lua_tonumber(L, -1);
+            }
+            lua_pop(L, 1);
+            
+            // 固定步長
+            lua_getfield(L, -1, "tick_rate");
+            if (lua_isnumber(L, -1)) {
+                out.tickRate = (f32)lua_tonumber(L, -1);
+            }
+            lua_pop(L, 1);
+            
+            lua_getfield(L, -1, "max_steps_per_frame");
+            if (lua_isnumber(L, -1)) {
+                out.maxStepsPerFrame = (u32)lua_tointeger(L, -1);
+            }
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 1);  // pop global
+        
+        // 讀取元素反應配置
+        lua_getfield(L, -1, "elements");
+        if (lua_istable(L, -1)) {
+            lua_getfield(L, -1, "fire");
+            if (lua_istable(L, -1)) {
+                lua_getfield(L, -1, "burn_damage");
+                if (lua_isnumber(L, -1)) out.elements.burnDamage = (f32)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+                lua_getfield(L, -1, "burn_duration");
+                if (lua_isnumber(L, -1)) out.elements.burnDuration = (f32)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+            }
+            lua_pop(L, 1);  // pop fire
+            
+            lua_getfield(L, -1, "ice");
+            if (lua_istable(L, -1)) {
+                lua_getfield(L, -1, "slow_amount");
+                if (lua_isnumber(L, -1)) out.elements.slowAmount = (f32)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+                lua_getfield(L, -1, "slow_duration");
+                if (lua_isnumber(L, -1)) out.elements.slowDuration = (f32)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+                lua_getfield(L, -1, "freeze_chance");
+                if (lua_isnumber(L, -1)) out.elements.freezeChance = (f32)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+                lua_getfield(L, -1, "freeze_duration");
+                if (lua_isnumber(L, -1)) out.elements.freezeDuration = (f32)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+            }
+            lua_pop(L, 1);  // pop ice
+            
+            lua_getfield(L, -1, "lightning");
+            if (lua_istable(L, -1)) {
+                lua_getfield(L, -1, "chain_count");
+                if (lua_isnumber(L, -1)) out.elements.chainCount = (u32)lua_tointeger(L, -1);
+                lua_pop(L, 1);
+                lua_getfield(L, -1, "chain_damage_decay");
+                if (lua_isnumber(L, -1)) out.elements.chainDecay = (f32)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+                lua_getfield(L, -1, "chain_range");
+                if (lua_isnumber(L, -1)) out.elements.chainRange = (f32)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+            }
+            lua_pop(L, 1);  // pop lightning
+            
+            lua_getfield(L, -1, "poison");
+            if (lua_istable(L, -1)) {
+                lua_getfield(L, -1, "dot_damage");
+                if (lua_isnumber(L, -1)) out.elements.poisonDamage = (f32)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+                lua_getfield(L, -1, "dot_duration");
+                if (lua_isnumber(L, -1)) out.elements.poisonDuration = (f32)lua_tonumber(L, -1);
+                lua_pop(L, 1);
+                lua_getfield(L, -1, "stack_max");
+                if (lua_isnumber(L, -1)) out.elements.poisonStackMax = (u8)lua_tointeger(L, -1);
+                lua_pop(L, 1);
+            }
+            lua_pop(L, 1);  // pop poison
+        }
+        lua_pop(L, 1);  // pop elements
+    }
+    lua_pop(L, 1);  // pop config
+    return found;
+}
+
+bool readLevel(lua_State* L, const std::string& levelId, LevelData& out) {
+    lua_getglobal(L, "levels");
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        return false;
+    }
+    
+    lua_getfield(L, -1, levelId.c_str());
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 2);
+        return false;
+    }
+    
+    readLevelTable(L, levelId, out);
+    
+    lua_pop(L, 2);  // pop level and levels
+    return true;
+}
+
+void readLevelTable(lua_State* L, const std::string& levelId, LevelData& out) {
+    out = LevelData();
+    out.id = intern(levelId);
+    
+    // 投射物池容量（關卡可覆寫）
+    lua_getfield(L, -1, "projectile_pool");
+    if (lua_isnumber(L, -1)) {
+        out.projectilePool = (u32)lua_tointeger(L, -1);
+    }
+    lua_pop(L, 1);
+    
+    // 網格尺寸（關卡可覆寫）
+    lua_getfield(L, -1, "grid");
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, "cols");
+        if (lua_isnumber(L, -1)) out.cols = (i32)lua_tointeger(L, -1);
+        lua_pop(L, 1);
+        lua_getfield(L, -1, "rows");
+        if (lua_isnumber(L, -1)) out.rows = (i32)lua_tointeger(L, -1);
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+    
+    // 讀取初始陽光
+    lua_getfield(L, -1, "initial");
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, "sun");
+        if (lua_isnumber(L, -1)) {
+            out.initialSun = (i32)lua_tointeger(L, -1);
+        }
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+    
+    // 限時星級
+    lua_getfield(L, -1, "stars");
+    if (lua_istable(L, -1)) {
+        const lua_Integer count = (lua_Integer)lua_rawlen(L, -1);
+        for (lua_Integer i = 1; i <= count; i++) {
+            lua_rawgeti(L, -1, i);
+            if (lua_istable(L, -1)) {
+                lua_getfield(L, -1, "id");
+                lua_getfield(L, -2, "time");
+                if (lua_isstring(L, -2) && std::strcmp(lua_tostring(L, -2), "under_time") == 0 &&
+                    lua_isnumber(L, -1)) {
+                    out.starTime = (f32)lua_tonumber(L, -1);
+                }
+                lua_pop(L, 2);
+            }
+            lua_pop(L, 1);
+        }
+    }
+    lua_pop(L, 1);
+    
+    // 讀取波次
+    lua_getfield(L, -1, "waves");
+    if (lua_istable(L, -1)) {
+        i32 waveIndex = 1;
+        while (true) {
+            lua_rawgeti(L, -1, waveIndex);
+            if (!lua_istable(L, -1)) {
+                lua_pop(L, 1);
+                break;
+            }
+            
+            WaveConfig wave;
+            
+            lua_getfield(L, -1, "time");
+            if (lua_isnumber(L, -1)) {
+                wave.time = (f32)lua_tonumber(L, -1);
+            }
+            lua_pop(L, 1);
+            
+            lua_getfield(L, -1, "enemies");
+            if (lua_istable(L, -1)) {
+                i32 enemyIndex = 1;
+                while (true) {
+                    lua_rawgeti(L, -1, enemyIndex);
+                    if (!lua_istable(L, -1)) {
+                        lua_pop(L, 1);
+                        break;
+                    }
+                    
+                    lua_getfield(L, -1, "type");
+                    Symbol enemyType = lua_isstring(L, -1) ? intern(lua_tostring(L, -1)) : kNoSymbol;
+                    lua_pop(L, 1);
+                    
+                    lua_getfield(L, -1, "count");
+                    i32 count = lua_isnumber(L, -1) ? (i32)lua_tointeger(L, -1) : 1;
+                    lua_pop(L, 1);
+                    
+                    if (enemyType != kNoSymbol) {
+                        wave.enemies.push_back({enemyType, count});
+                    }
+                    
+                    lua_pop(L, 1);
+                    enemyIndex++;
+                }
+            }
+            lua_pop(L, 1);  // pop enemies
+            
+            out.waves.push_back(wave);
+            
+            lua_pop(L, 1);  // pop wave
+            waveIndex++;
+        }
+    }
+    lua_pop(L, 1);  // pop waves
+}
+
+std::vector<std::string> listLevels(lua_State* L) {
+    std::vector<std::string> ids;
+    
+    lua_getglobal(L, "levels");
+    if (lua_istable(L, -1)) {
+        lua_pushnil(L);
+        while (lua_next(L, -2) != 0) {
+            if (lua_type(L, -2) == LUA_TSTRING && lua_istable(L, -1)) {
+                ids.emplace_back(lua_tostring(L, -2));
+            }
+            lua_pop(L, 1);
+        }
+    }
+    lua_pop(L, 1);  // pop levels
+    
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+} // namespace PL
@@ -0,0 +1,79 @@
+// ============================================
+// Plant Legends - 遊戲設定與關卡資料
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include "core/symbol.hpp"
+#include <string>
+#include <vector>
+
+struct lua_State;
+
+namespace PL {
+
+// 網格配置
+struct GridConfig {
+    i32 cols = 9;
+    i32 rows = 5;
+    f32 cellWidth = 80.0f;
+    f32 cellHeight = 100.0f;
+    f32 offsetX = 100.0f;
+    f32 offsetY = 100.0f;
+};
+
+// 元素反應配置（config.elements）
+struct ElementConfig {
+    f32 burnDamage = 0.1f;       // 每秒傷害 = 攻擊力 x burnDamage
+    f32 burnDuration = 3.0f;
+    f32 slowAmount = 0.5f;
+    f32 slowDuration = 2.0f;
+    f32 freezeChance = 0.1f;
+    f32 freezeDuration = 1.0f;
+    f32 poisonDamage = 0.05f;    // 每層每秒傷害 = 攻擊力 x poisonDamage
+    f32 poisonDuration = 5.0f;
+    u8 poisonStackMax = 5;
+    u32 chainCount = 3;          // 閃電連鎖跳躍次數
+    f32 chainDecay = 0.7f;       // 每跳傷害倍率
+    f32 chainRange = 150.0f;
+};
+
+// 全域設定（config.global + config.elements）
+struct GameConfig {
+    GridConfig grid;
+    ElementConfig elements;
+    i32 startingSun = 50;
+    f32 sunInterval = 5.0f;
+    u32 projectilePoolSize = 1024;
+    f32 luaGcMaxMs = 1.0f;        // 每幀 Lua GC 上限，<= 0 交回自動 GC
+    f32 tickRate = 60.0f;         // 固定步長（每秒 tick 數）
+    u32 maxStepsPerFrame = 5;     // 每幀最多執行的 tick
+};
+
+// 波次配置
+struct WaveConfig {
+    f32 time = 0.0f;
+    std::vector<std::pair<Symbol, i32>> enemies;  // enemyId, count
+};
+
+// 單一關卡；未設定的欄位沿用全域設定
+struct LevelData {
+    Symbol id = kNoSymbol;
+    i32 initialSun = -1;          // < 0：沿用目前陽光
+    u32 projectilePool = 0;       // 0：沿用 config.global.projectile_pool_size
+    i32 cols = 0;                 // 0：沿用目前網格
+    i32 rows = 0;
+    f32 starTime = 0.0f;          // stars 中 under_time 的時限（0：無此星級）
+    std::vector<WaveConfig> waves;
+};
+
+// 從 Lua 全域表讀取（config / levels 須已載入）
+bool readConfig(lua_State* L, GameConfig& out);
+bool readLevel(lua_State* L, const std::string& levelId, LevelData& out);
+void readLevelTable(lua_State* L, const std::string& levelId, LevelData& out);  // 關卡表位於棧頂，不彈出
+
+// levels 表中所有關卡 ID，依字串排序
+std::vector<std::string> listLevels(lua_State* L);
+
+} // namespace PL
@@ -0,0 +1,131 @@
+// ============================================
+// Plant Legends - Hot Reload Implementation
+// ============================================
+
+#include "game/hot_reload.hpp"
+#include "game/archetype.hpp"
+#include "game/game.hpp"
+#include "game/level_loader.hpp"
+#include "game/script_hooks.hpp"
+#include "lua/lua_manager.hpp"
+#include "core/log.hpp"
+#include <chrono>
+
+extern "C" {
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+
+namespace PL {
+
+namespace {
+
+bool endsWith(const std::string& s, const char* suffix) {
+    const size_t n = std::char_traits<char>::length(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+bool isUnder(const std::string& path, const std::string& dir) {
+    return path.size() > dir.size() && path.compare(0, dir.size(), dir) == 0 && path[dir.size()] == '/';
+}
+
+} // namespace
+
+bool HotReload::watch(const std::string& dir) {
+    root = dir;
+    bool ok = watcher.addDirectory(root);
+    watcher.addDirectory(root + "/plants");
+    watcher.addDirectory(root + "/enemies");
+    watcher.addDirectory(root + "/levels");
+    
+    if (ok) {
+        PL_LOG_INFO(Lua, "Hot reload: watching %u directories under %s (%s)",
+                    watcher.getDirectoryCount(), root.c_str(), watcher.usesInotify() ? "inotify" : "polling");
+    }
+    return ok;
+}
+
+u32 HotReload::update(Game& game) {
+    if (watcher.poll(changed) == 0) return 0;
+    
+    for (const std::string& path : changed) {
+        reloadFile(game, path);
+    }
+    return (u32)changed.size();
+}
+
+bool HotReload::reloadFile(Game& game, const std::string& path) {
+    auto start = std::chrono::steady_clock::now();
+    
+    lastReload = ReloadStats();
+    lastReload.file = path;
+    
+    if (endsWith(path, "config.lua")) {
+        // 設定在初始化時套用到各系統，執行中改寫無法一致地生效
+        PL_LOG_WARN(Lua, "%s changed: config changes need a restart", path.c_str());
+        return false;
+    }
+    
+    // 關卡在進關時才讀，重建索引即可
+    lastReload.ok = isUnder(path, root + "/levels") ? reloadLevels(path) : reloadArchetypes(game, path);
+    lastReload.ms = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (!lastReload.ok) return false;
+    
+    reloadCount++;
+    PL_LOG_INFO(Lua, "Reloaded %s in %.2f ms: %u plant / %u enemy archetypes changed, %u added, %u entities patched",
+                path.c_str(), lastReload.ms, lastReload.plantsChanged, lastReload.enemiesChanged,
+                lastReload.added, lastReload.entitiesPatched);
+    if (lastReload.ms > kFrameBudgetMs) {
+        PL_LOG_WARN(Lua, "Reload of %s took longer than a frame (%.2f ms)", path.c_str(), lastReload.ms);
+    }
+    return true;
+}
+
+bool HotReload::reloadLevels(const std::string& path) {
+    LevelIndex& index = LevelLoader::instance().getIndex();
+    index.clear();
+    if (index.addDirectory(root + "/levels") == 0) {
+        PL_LOG_WARN(Lua, "%s: no levels indexed after reload", path.c_str());
+    }
+    return true;
+}
+
+bool HotReload::reloadArchetypes(Game& game, const std::string& path) {
+    LuaManager& lua = LuaManager::instance();
+    lua_State* L = lua.getState();
+    if (!L) return false;
+    
+    // 腳本開頭通常是 plants = {}，中途出錯會留下不完整的表：先保留舊表以便還原
+    const int top = lua_gettop(L);
+    lua_getglobal(L, "plants");
+    lua_getglobal(L, "enemies");
+    
+    if (!lua.loadScript(path)) {
+        PL_LOG_ERROR(Lua, "Reload of %s failed, keeping previous data: %s", path.c_str(), lua.getLastError().c_str());
+        lua_settop(L, top + 2);
+        lua_setglobal(L, "enemies");
+        lua_setglobal(L, "plants");
+        return false;
+    }
+    lua_settop(L, top);
+    
+    // 兩張表都重新比對：只有數值變動的原型會被改寫
+    ArchetypeRegistry& registry = ArchetypeRegistry::instance();
+    std::vector<ArchetypeId> plantIds;
+    std::vector<ArchetypeId> enemyIds;
+    lastReload.added = registry.reloadPlants(L, plantIds) + registry.reloadEnemies(L, enemyIds);
+    lastReload.plantsChanged = (u32)plantIds.size();
+    lastReload.enemiesChanged = (u32)enemyIds.size();
+    
+    // 回呼函數都是新的閉包，引用整批重新解析
+    ScriptHooks& hooks = ScriptHooks::instance();
+    if (hooks.isBound()) {
+        hooks.bind(L);
+    }
+    
+    lastReload.entitiesPatched = game.refreshArchetypes(plantIds, enemyIds);
+    return true;
+}
+
+} // namespace PL
@@ -0,0 +1,59 @@
+// ============================================
+// Plant Legends - 腳本熱重載
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include "core/file_watcher.hpp"
+#include <string>
+#include <vector>
+
+namespace PL {
+
+class Game;
+
+// 單次重載結果
+struct ReloadStats {
+    std::string file;
+    f64 ms = 0.0;
+    u32 plantsChanged = 0;      // 數值有變動的原型
+    u32 enemiesChanged = 0;
+    u32 added = 0;              // 新增的原型
+    u32 entitiesPatched = 0;    // 更新基礎數值的存活實體
+    bool ok = false;
+};
+
+// 開發用的腳本熱重載（只在不使用資料包時啟用）
+// 監看 scripts 目錄，有檔案寫入時只重新執行該檔，
+// 以就地更新的方式比對並改寫有變動的原型（ID 不變），重新解析回呼引用，
+// 再把新的基礎數值套用到場上的實體。不重建 Game 也不重開 Lua state。
+// 腳本執行失敗時還原 plants / enemies 全域表，沿用原本的資料。
+class HotReload {
+public:
+    static constexpr f64 kFrameBudgetMs = 1000.0 / 60.0;
+    
+    // 監看 root 與其下的 plants / enemies / levels
+    bool watch(const std::string& root);
+    
+    // 每幀在 update 之間呼叫；回傳處理的檔案數
+    u32 update(Game& game);
+    
+    // 重新執行單一腳本並套用（也供測試直接呼叫）
+    bool reloadFile(Game& game, const std::string& path);
+    
+    const ReloadStats& getLastReload() const { return lastReload; }
+    u32 getReloadCount() const { return reloadCount; }
+    
+private:
+    FileWatcher watcher;
+    std::string root;
+    std::vector<std::string> changed;
+    ReloadStats lastReload;
+    u32 reloadCount = 0;
+    
+    bool reloadLevels(const std::string& path);
+    bool reloadArchetypes(Game& game, const std::string& path);
+};
+
+} // namespace PL
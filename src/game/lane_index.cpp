@@ -0,0 +1,79 @@
+// ============================================
+// Plant Legends - Lane Index Implementation
+// ============================================
+
+#include "game/lane_index.hpp"
+#include "game/entity_store.hpp"
+#include <algorithm>
+
+namespace PL {
+
+void LaneIndex::reset(i32 rows) {
+    enemyLanes.assign(rows, {});
+    plantMask.assign(rows, 0);
+    rowChanged.assign(rows, 1);
+}
+
+void LaneIndex::clear() {
+    for (auto& lane : enemyLanes) {
+        lane.clear();
+    }
+    std::fill(plantMask.begin(), plantMask.end(), 0);
+    std::fill(rowChanged.begin(), rowChanged.end(), 1);
+}
+
+void LaneIndex::insertEnemy(i32 row, EnemyHandle handle, u32 dense, f32 x) {
+    if (row < 0 || row >= getRows()) return;
+    
+    // 新敵人從右側生成，通常直接附加在尾端；refresh 會修正順序
+    enemyLanes[row].push_back({x, dense, handle});
+}
+
+void LaneIndex::refresh(const EnemyStore& enemies) {
+    for (auto& lane : enemyLanes) {
+        // 解析句柄，移除已清理的敵人
+        u32 write = 0;
+        for (u32 read = 0; read < lane.size(); read++) {
+            Entry entry = lane[read];
+            u32 dense = enemies.resolve(entry.handle);
+            if (dense == kInvalidIndex) continue;
+            
+            entry.dense = dense;
+            entry.x = enemies.x[dense];
+            lane[write++] = entry;
+        }
+        lane.resize(write);
+        
+        // 敵人每 tick 只移動一點，列表幾乎有序：插入排序接近 O(n)
+        for (u32 i = 1; i < lane.size(); i++) {
+            Entry entry = lane[i];
+            u32 j = i;
+            while (j > 0 && lane[j - 1].x > entry.x) {
+                lane[j] = lane[j - 1];
+                j--;
+            }
+            lane[j] = entry;
+        }
+    }
+}
+
+u32 LaneIndex::lowerBound(i32 row, f32 x) const {
+    const auto& lane = enemyLanes[row];
+    auto it = std::lower_bound(lane.begin(), lane.end(), x,
+        [](const Entry& e, f32 value) { return e.x < value; });
+    return (u32)(it - lane.begin());
+}
+
+void LaneIndex::setOccupied(const GridCoord& coord, bool occupied) {
+    if (coord.row < 0 || coord.row >= getRows() || coord.col < 0 || coord.col >= kMaxCols) return;
+    
+    u64 bit = u64(1) << coord.col;
+    if (occupied) {
+        plantMask[coord.row] |= bit;
+    } else {
+        plantMask[coord.row] &= ~bit;
+    }
+    rowChanged[coord.row] = 1;
+}
+
+} // namespace PL
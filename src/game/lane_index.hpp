@@ -0,0 +1,57 @@
+// ============================================
+// Plant Legends - 行（Lane）索引
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include "core/handle.hpp"
+#include <vector>
+#include <algorithm>
+
+namespace PL {
+
+struct EnemyStore;
+
+// 每行維護依 x 排序的敵人列表，以及植物佔用位元遮罩。
+// 敵人不會換行，同一行的敵人 y 座標相同，因此行內最近的敵人
+// 就是二分搜尋位置左右的第一個存活者。
+class LaneIndex {
+public:
+    static constexpr i32 kMaxCols = 64;  // 植物佔用以 u64 遮罩表示
+    
+    struct Entry {
+        f32 x;
+        u32 dense;          // 本 tick 在 EnemyStore 的索引（refresh 後有效）
+        EnemyHandle handle;
+    };
+    
+    void reset(i32 rows);
+    void clear();
+    
+    i32 getRows() const { return (i32)enemyLanes.size(); }
+    
+    // 敵人
+    void insertEnemy(i32 row, EnemyHandle handle, u32 dense, f32 x);
+    void refresh(const EnemyStore& enemies);  // 更新位置、移除失效句柄並維持排序
+    const std::vector<Entry>& lane(i32 row) const { return enemyLanes[row]; }
+    u32 lowerBound(i32 row, f32 x) const;     // 第一個 x >= 給定值的位置
+    
+    // 植物佔用
+    void setOccupied(const GridCoord& coord, bool occupied);
+    bool isOccupied(const GridCoord& coord) const {
+        return (plantMask[coord.row] >> coord.col) & 1u;
+    }
+    u64 rowMask(i32 row) const { return plantMask[row]; }
+    
+    // 佔用變化旗標（敵人據此重新選目標，每 tick 消費後清除）
+    bool occupancyChanged(i32 row) const { return rowChanged[row] != 0; }
+    void clearOccupancyChanged() { std::fill(rowChanged.begin(), rowChanged.end(), 0); }
+    
+private:
+    std::vector<std::vector<Entry>> enemyLanes;
+    std::vector<u64> plantMask;
+    std::vector<u8> rowChanged;
+};
+
+} // namespace PL
@@ -0,0 +1,224 @@
+// ============================================
+// Plant Legends - Level Loader Implementation
+// ============================================
+
+#include "game/level_loader.hpp"
+#include "game/data_pack.hpp"
+#include "core/log.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+extern "C" {
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+
+namespace PL {
+
+namespace {
+
+// 解析行首的 levels["id"] = / levels.id = ，回傳 id（不是關卡區塊則為空）
+std::string parseLevelHeader(const std::string& line) {
+    static const char kPrefix[] = "levels";
+    if (line.compare(0, sizeof(kPrefix) - 1, kPrefix) != 0) return "";
+    
+    size_t pos = sizeof(kPrefix) - 1;
+    std::string id;
+    if (pos < line.size() && line[pos] == '[') {
+        if (pos + 1 >= line.size() || (line[pos + 1] != '"' && line[pos + 1] != '\'')) return "";
+        char quote = line[pos + 1];
+        size_t end = line.find(quote, pos + 2);
+        if (end == std::string::npos || end + 1 >= line.size() || line[end + 1] != ']') return "";
+        id = line.substr(pos + 2, end - pos - 2);
+        pos = end + 2;
+    } else if (pos < line.size() && line[pos] == '.') {
+        size_t end = pos + 1;
+        while (end < line.size() && (std::isalnum((unsigned char)line[end]) || line[end] == '_')) end++;
+        id = line.substr(pos + 1, end - pos - 1);
+        pos = end;
+    } else {
+        return "";
+    }
+    
+    while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t')) pos++;
+    if (pos >= line.size() || line[pos] != '=' || (pos + 1 < line.size() && line[pos + 1] == '=')) return "";
+    return id;
+}
+
+// 頂層敘述（區塊結束的位置）：行首不是空白也不是註解
+bool isTopLevelStatement(const std::string& line) {
+    if (line.empty() || line[0] == ' ' || line[0] == '\t' || line[0] == '\r') return false;
+    if (line.compare(0, 2, "--") == 0) return false;
+    return line[0] != '}';
+}
+
+} // namespace
+
+// ============================================
+// LevelIndex
+// ============================================
+
+u32 LevelIndex::addFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return 0;
+    
+    const u32 fileId = (u32)files.size();
+    files.push_back(path);
+    
+    u32 added = 0;
+    Entry* open = nullptr;   // 尚未結束的區塊
+    std::string line;
+    u32 offset = 0;
+    u32 lineNo = 0;
+    while (std::getline(file, line)) {
+        lineNo++;
+        const u32 lineStart = offset;
+        offset += (u32)line.size() + 1;
+        
+        if (!isTopLevelStatement(line)) continue;
+        
+        // 任何頂層敘述都結束前一個區塊
+        if (open) {
+            open->length = lineStart - open->offset;
+            open = nullptr;
+        }
+        
+        std::string id = parseLevelHeader(line);
+        if (id.empty()) continue;
+        
+        Entry entry;
+        entry.id = intern(id);
+        entry.file = fileId;
+        entry.offset = lineStart;
+        entry.line = lineNo;
+        entries.push_back(entry);
+        open = &entries.back();
+        added++;
+    }
+    if (open) {
+        open->length = offset - open->offset;
+    }
+    
+    // 同 id 以後索引的為準
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.id < b.id; });
+    auto last = std::unique(entries.rbegin(), entries.rend(), [](const Entry& a, const Entry& b) { return a.id == b.id; });
+    entries.erase(entries.begin(), last.base());
+    
+    PL_LOG_INFO(Game, "Level index: %u levels in %s", added, path.c_str());
+    return added;
+}
+
+u32 LevelIndex::addDirectory(const std::string& dir) {
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".lua") {
+            paths.push_back(entry.path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    
+    u32 added = 0;
+    for (const std::string& path : paths) {
+        added += addFile(path);
+    }
+    return added;
+}
+
+void LevelIndex::clear() {
+    files.clear();
+    entries.clear();
+}
+
+const LevelIndex::Entry* LevelIndex::find(Symbol id) const {
+    auto it = std::lower_bound(entries.begin(), entries.end(), id, [](const Entry& e, Symbol s) { return e.id < s; });
+    return (it != entries.end() && it->id == id) ? &*it : nullptr;
+}
+
+// ============================================
+// LevelLoader
+// ============================================
+
+LevelLoader& LevelLoader::instance() {
+    thread_local LevelLoader loader;
+    return loader;
+}
+
+bool LevelLoader::load(lua_State* L, const std::string& levelId, LevelData& out) {
+    auto start = std::chrono::steady_clock::now();
+    LevelLoadStats stats;
+    stats.id = intern(levelId);
+    
+    bool found = false;
+    const DataPack& pack = DataPack::instance();
+    if (pack.isOpen()) {
+        if (const PackLevel* level = pack.findLevel(levelId)) {
+            pack.readLevel(*level, out);
+            stats.source = LevelSource::Pack;
+            found = true;
+        }
+    } else if (const LevelIndex::Entry* entry = index.find(stats.id)) {
+        stats.bytes = entry->length;
+        stats.source = LevelSource::Index;
+        found = loadFromIndex(L, *entry, levelId, out);
+    } else if (readLevel(L, levelId, out)) {
+        stats.source = LevelSource::Table;
+        found = true;
+    }
+    
+    if (!found) {
+        return false;
+    }
+    
+    stats.ms = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+    lastLoad = stats;
+    return true;
+}
+
+bool LevelLoader::loadFromIndex(lua_State* L, const LevelIndex::Entry& entry, const std::string& levelId, LevelData& out) {
+    const std::string& path = index.getFile(entry.file);
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        PL_LOG_ERROR(Game, "Cannot open %s", path.c_str());
+        return false;
+    }
+    
+    // 區塊前補上 local levels 與空行，行號與原檔對齊
+    std::string chunk = "local levels = {}";
+    chunk.append(entry.line - 1, '\n');
+    const size_t head = chunk.size();
+    chunk.resize(head + entry.length);
+    file.seekg(entry.offset);
+    if (!file.read(&chunk[head], entry.length)) {
+        PL_LOG_ERROR(Game, "Short read in %s", path.c_str());
+        return false;
+    }
+    chunk += "\nreturn levels";
+    
+    const std::string chunkName = "@" + path;
+    if (luaL_loadbufferx(L, chunk.data(), chunk.size(), chunkName.c_str(), "t") != LUA_OK ||
+        lua_pcall(L, 0, 1, 0) != LUA_OK) {
+        PL_LOG_ERROR(Lua, "Level %s: %s", levelId.c_str(), lua_tostring(L, -1));
+        lua_pop(L, 1);
+        return false;
+    }
+    
+    bool ok = false;
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, levelId.c_str());
+        if (lua_istable(L, -1)) {
+            readLevelTable(L, levelId, out);
+            ok = true;
+        }
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);  // pop 區域 levels 表（之後由 GC 回收）
+    return ok;
+}
+
+} // namespace PL
@@ -0,0 +1,80 @@
+// ============================================
+// Plant Legends - 關卡索引與按需載入
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include "core/symbol.hpp"
+#include "game/game_data.hpp"
+#include <string>
+#include <vector>
+
+struct lua_State;
+
+namespace PL {
+
+// 關卡來源
+enum class LevelSource : u8 {
+    None,
+    Pack,       // 烘焙資料包（就地二分搜尋）
+    Index,      // 關卡索引：只讀取並執行該關卡的原始碼區段
+    Table       // 已常駐的全域 levels 表（舊路徑）
+};
+
+// 最近一次載入的統計
+struct LevelLoadStats {
+    Symbol id = kNoSymbol;
+    LevelSource source = LevelSource::None;
+    f64 ms = 0.0;       // 讀檔 + 執行 + 轉換
+    u32 bytes = 0;      // 讀取的原始碼位元組（資料包為 0）
+};
+
+// 關卡索引：id -> 檔案 / 位元組偏移 / 長度。
+// 只掃描文字找出頂層的 levels["id"] = { ... } 區塊，不執行腳本。
+class LevelIndex {
+public:
+    struct Entry {
+        Symbol id = kNoSymbol;
+        u32 file = 0;
+        u32 offset = 0;
+        u32 length = 0;
+        u32 line = 1;   // 區塊起始行，讓錯誤訊息的行號與原檔一致
+    };
+    
+    // 索引單一檔案 / 目錄下所有 .lua，回傳新增的關卡數
+    u32 addFile(const std::string& path);
+    u32 addDirectory(const std::string& dir);
+    void clear();
+    
+    const Entry* find(Symbol id) const;
+    const std::string& getFile(u32 file) const { return files[file]; }
+    u32 size() const { return (u32)entries.size(); }
+    
+private:
+    std::vector<std::string> files;
+    std::vector<Entry> entries;       // 依 id 排序
+};
+
+// 按需載入單一關卡。Lua 堆中不保留整個 levels 表：
+// 區塊在一個區域 levels 表中執行，轉成 LevelData 後即成為垃圾。
+class LevelLoader {
+public:
+    static LevelLoader& instance();  // 每個執行緒一份
+    
+    LevelIndex& getIndex() { return index; }
+    const LevelIndex& getIndex() const { return index; }
+    
+    // 依序嘗試資料包、關卡索引、全域 levels 表
+    bool load(lua_State* L, const std::string& levelId, LevelData& out);
+    
+    const LevelLoadStats& getLastLoad() const { return lastLoad; }
+    
+private:
+    LevelIndex index;
+    LevelLoadStats lastLoad;
+    
+    bool loadFromIndex(lua_State* L, const LevelIndex::Entry& entry, const std::string& levelId, LevelData& out);
+};
+
+} // namespace PL
@@ -5,62 +5,56 @@
 #pragma once
 
 #include "core/entity.hpp"
+#include "game/archetype.hpp"
 #include <string>
 
 namespace PL {
 
+// 植物冷資料；血量、攻擊計時器、狀態與目標存放在 PlantStore。
+// 不變的定義資料留在原型表，實例只複製一份基礎數值。
 class Plant : public Entity {
 public:
-    Plant(const std::string& plantId);
+    explicit Plant(ArchetypeId archetype);
     ~Plant() override = default;
     
-    void update(f32 dt) override;
     void render() override;
     
-    // 屬性
-    const std::string& getPlantId() const { return plantId; }
+    // 原型
+    ArchetypeId getArchetypeId() const { return archetype; }
+    const PlantArchetype& getArchetype() const { return ArchetypeRegistry::instance().plant(archetype); }
+    
+    // 屬性（基礎數值）
+    Symbol getPlantId() const { return getArchetype().id; }
+    Symbol getName() const { return getArchetype().name; }
     const Stats& getStats() const { return stats; }
+    Stats& getStats() { return stats; }  // 腳本可修改單一實例
     
     // 網格位置
     GridCoord getGridPosition() const { return gridPos; }
     void setGridPosition(const GridCoord& pos) { gridPos = pos; }
     
     // 稀有度
-    Rarity getRarity() const { return rarity; }
+    Rarity getRarity() const { return getArchetype().rarity; }
     
     // 元素
-    Element getElement() const { return element; }
+    Element getElement() const { return getArchetype().element; }
     
-    // 攻擊
-    void setTarget(EnemyPtr target) { this->target = target; }
-    EnemyPtr getTarget() const { return target; }
-    bool canAttack() const;
-    void attack();
+    // 所在圖層
+    GridLayer getLayer() const { return getArchetype().layer; }
     
-    // 受傷
-    void takeDamage(f32 damage);
+    // 攻擊間隔（秒）
+    f32 getAttackInterval() const { return 1.0f / stats.attackSpeed; }
     
     // 成本
-    i32 getCost() const { return cost; }
+    i32 getCost() const { return getArchetype().cost; }
     
     // 進化
-    const std::string& getEvolvesTo() const { return evolvesTo; }
+    ArchetypeId getEvolvesTo() const { return getArchetype().evolvesTo; }
     
 private:
-    std::string plantId;
-    std::string name;
+    ArchetypeId archetype;
     Stats stats;
     GridCoord gridPos;
-    Rarity rarity = Rarity::Common;
-    Element element = Element::None;
-    
-    i32 cost = 100;
-    std::string evolvesTo;
-    
-    f32 attackTimer = 0.0f;
-    EnemyPtr target = nullptr;
-    
-    void loadFromLua();
 };
 
 } // namespace PL
@@ -0,0 +1,44 @@
+// ============================================
+// Plant Legends - Plant Grid Implementation
+// ============================================
+
+#include "game/plant_grid.hpp"
+#include <algorithm>
+
+namespace PL {
+
+void PlantGrid::reset(i32 c, i32 r) {
+    cols = std::max(0, c);
+    rows = std::max(0, r);
+    cells.assign((size_t)cols * rows * kLayerCount, PlantHandle());
+}
+
+void PlantGrid::clear() {
+    std::fill(cells.begin(), cells.end(), PlantHandle());
+}
+
+bool PlantGrid::isAnyOccupied(const GridCoord& coord) const {
+    if (!inBounds(coord)) return false;
+    
+    const u32 base = indexOf(coord, GridLayer::Ground);
+    for (u32 layer = 0; layer < kLayerCount; layer++) {
+        if (!cells[base + layer].isNull()) return true;
+    }
+    return false;
+}
+
+void PlantGrid::set(const GridCoord& coord, GridLayer layer, PlantHandle handle) {
+    if (!inBounds(coord)) return;
+    cells[indexOf(coord, layer)] = handle;
+}
+
+bool PlantGrid::erase(const GridCoord& coord, GridLayer layer, PlantHandle handle) {
+    if (!inBounds(coord)) return false;
+    
+    PlantHandle& cell = cells[indexOf(coord, layer)];
+    if (cell != handle) return false;
+    cell = PlantHandle();
+    return true;
+}
+
+} // namespace PL
@@ -0,0 +1,56 @@
+// ============================================
+// Plant Legends - 網格佔用
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include "core/handle.hpp"
+#include <vector>
+
+namespace PL {
+
+// 依格子連續排列的植物句柄，每格 kLayerCount 個圖層。
+// 索引 = (row * cols + col) * kLayerCount + layer，查詢與移除都是 O(1)。
+// 尺寸由關卡的 grid.cols / grid.rows 決定，只在換關時重新配置。
+class PlantGrid {
+public:
+    static constexpr u32 kLayerCount = (u32)GridLayer::Count;
+    
+    void reset(i32 cols, i32 rows);
+    void clear();
+    
+    i32 getCols() const { return cols; }
+    i32 getRows() const { return rows; }
+    
+    bool inBounds(const GridCoord& coord) const {
+        return coord.col >= 0 && coord.col < cols && coord.row >= 0 && coord.row < rows;
+    }
+    
+    PlantHandle get(const GridCoord& coord, GridLayer layer = GridLayer::Ground) const {
+        return inBounds(coord) ? cells[indexOf(coord, layer)] : PlantHandle();
+    }
+    
+    bool isOccupied(const GridCoord& coord, GridLayer layer = GridLayer::Ground) const {
+        return !get(coord, layer).isNull();
+    }
+    
+    // 任一圖層有植物
+    bool isAnyOccupied(const GridCoord& coord) const;
+    
+    void set(const GridCoord& coord, GridLayer layer, PlantHandle handle);
+    
+    // 只在該圖層仍是 handle 時移除（避免移除同格後來放的植物），回傳是否移除
+    bool erase(const GridCoord& coord, GridLayer layer, PlantHandle handle);
+    
+private:
+    i32 cols = 0;
+    i32 rows = 0;
+    std::vector<PlantHandle> cells;
+    
+    u32 indexOf(const GridCoord& coord, GridLayer layer) const {
+        return (u32)(coord.row * cols + coord.col) * kLayerCount + (u32)layer;
+    }
+};
+
+} // namespace PL
@@ -0,0 +1,274 @@
+// ============================================
+// Plant Legends - 重播錄製與播放
+// ============================================
+
+#include "game/replay.hpp"
+#include "game/game.hpp"
+#include "game/archetype.hpp"
+#include "game/data_pack.hpp"
+#include "core/log.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace PL {
+
+namespace {
+
+// ============================================
+// 編碼
+// ============================================
+
+void putVarint(std::vector<u8>& out, u64 v) {
+    while (v >= 0x80) {
+        out.push_back((u8)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((u8)v);
+}
+
+u64 zigzag(i64 v) { return ((u64)v << 1) ^ (u64)(v >> 63); }
+i64 unzigzag(u64 v) { return (i64)(v >> 1) ^ -(i64)(v & 1); }
+
+void putString(std::vector<u8>& out, const std::string& s) {
+    putVarint(out, s.size());
+    out.insert(out.end(), s.begin(), s.end());
+}
+
+// 讀取時每一步都檢查邊界，任何錯誤都讓 ok 變成 false
+struct Reader {
+    const u8* p;
+    const u8* end;
+    bool ok = true;
+    
+    u64 varint() {
+        u64 v = 0;
+        for (u32 shift = 0; shift < 64; shift += 7) {
+            if (p >= end) break;
+            u8 b = *p++;
+            v |= (u64)(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+    
+    u8 byte() {
+        if (p >= end) {
+            ok = false;
+            return 0;
+        }
+        return *p++;
+    }
+    
+    bool bytes(void* dst, size_t n) {
+        if ((size_t)(end - p) < n) return ok = false;
+        std::memcpy(dst, p, n);
+        p += n;
+        return true;
+    }
+    
+    std::string string() {
+        u64 n = varint();
+        if (!ok || (u64)(end - p) < n) {
+            ok = false;
+            return std::string();
+        }
+        std::string s((const char*)p, (size_t)n);
+        p += n;
+        return s;
+    }
+};
+
+} // namespace
+
+// ============================================
+// Replay
+// ============================================
+
+void Replay::encode(std::vector<u8>& out) const {
+    out.clear();
+    out.insert(out.end(), kReplayMagic, kReplayMagic + sizeof(kReplayMagic));
+    out.push_back(kReplayVersion);
+    putVarint(out, seed);
+    putString(out, SymbolTable::instance().str(level));
+    u8 stepBytes[sizeof(f32)];
+    std::memcpy(stepBytes, &step, sizeof(f32));
+    out.insert(out.end(), stepBytes, stepBytes + sizeof(f32));
+    putVarint(out, zigzag(startSun));
+    
+    // 植物 ID 只存一次，事件帶字串表索引
+    std::vector<Symbol> plants;
+    for (const ReplayEvent& e : events) {
+        if (e.command == ReplayCommand::PlacePlant &&
+            std::find(plants.begin(), plants.end(), e.plant) == plants.end()) {
+            plants.push_back(e.plant);
+        }
+    }
+    putVarint(out, plants.size());
+    for (Symbol plant : plants) {
+        putString(out, SymbolTable::instance().str(plant));
+    }
+    
+    putVarint(out, events.size());
+    u64 tick = 0;
+    for (const ReplayEvent& e : events) {
+        putVarint(out, e.tick - tick);
+        tick = e.tick;
+        out.push_back((u8)e.command);
+        switch (e.command) {
+            case ReplayCommand::PlacePlant:
+                putVarint(out, (u64)(std::find(plants.begin(), plants.end(), e.plant) - plants.begin()));
+                putVarint(out, zigzag(e.coord.col));
+                putVarint(out, zigzag(e.coord.row));
+                break;
+            case ReplayCommand::RemovePlant:
+                putVarint(out, zigzag(e.coord.col));
+                putVarint(out, zigzag(e.coord.row));
+                break;
+            case ReplayCommand::CollectSun:
+                putVarint(out, zigzag(e.amount));
+                break;
+            default:
+                break;
+        }
+    }
+    
+    u32 checksum = packChecksum(out.data(), (u32)out.size());
+    u8 sumBytes[sizeof(u32)];
+    std::memcpy(sumBytes, &checksum, sizeof(u32));
+    out.insert(out.end(), sumBytes, sumBytes + sizeof(u32));
+}
+
+bool Replay::decode(const u8* data, size_t size) {
+    clear();
+    if (size < sizeof(kReplayMagic) + 1 + sizeof(u32) ||
+        std::memcmp(data, kReplayMagic, sizeof(kReplayMagic)) != 0 || data[sizeof(kReplayMagic)] != kReplayVersion) {
+        return false;
+    }
+    const size_t body = size - sizeof(u32);
+    u32 checksum;
+    std::memcpy(&checksum, data + body, sizeof(u32));
+    if (packChecksum(data, (u32)body) != checksum) {
+        return false;
+    }
+    
+    Reader in{ data + sizeof(kReplayMagic) + 1, data + body };
+    seed = in.varint();
+    level = intern(in.string());
+    in.bytes(&step, sizeof(f32));
+    startSun = (i32)unzigzag(in.varint());
+    
+    u64 plantCount = in.varint();
+    if (!in.ok || plantCount > (u64)(in.end - in.p)) return false;
+    std::vector<Symbol> plants((size_t)plantCount);
+    for (Symbol& plant : plants) {
+        plant = intern(in.string());
+    }
+    
+    // 每筆事件至少 2 位元組，先檢查再配置
+    u64 eventCount = in.varint();
+    if (!in.ok || eventCount > (u64)(in.end - in.p) / 2) return false;
+    events.resize((size_t)eventCount);
+    u64 tick = 0;
+    for (ReplayEvent& e : events) {
+        tick += in.varint();
+        e.tick = tick;
+        u8 command = in.byte();
+        if (command >= (u8)ReplayCommand::Count) return false;
+        e.command = (ReplayCommand)command;
+        switch (e.command) {
+            case ReplayCommand::PlacePlant: {
+                u64 index = in.varint();
+                if (index >= plants.size()) return false;
+                e.plant = plants[(size_t)index];
+                e.coord.col = (i32)unzigzag(in.varint());
+                e.coord.row = (i32)unzigzag(in.varint());
+                break;
+            }
+            case ReplayCommand::RemovePlant:
+                e.coord.col = (i32)unzigzag(in.varint());
+                e.coord.row = (i32)unzigzag(in.varint());
+                break;
+            case ReplayCommand::CollectSun:
+                e.amount = (i32)unzigzag(in.varint());
+                break;
+            default:
+                break;
+        }
+    }
+    return in.ok && in.p == in.end && step > 0.0f;
+}
+
+bool Replay::save(const std::string& path) const {
+    std::vector<u8> bytes;
+    encode(bytes);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size())) {
+        PL_LOG_ERROR(Game, "Failed to write replay %s", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Replay::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<u8> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!decode(bytes.data(), bytes.size())) {
+        PL_LOG_ERROR(Game, "Invalid replay %s", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ============================================
+// ReplayPlayer
+// ============================================
+
+bool ReplayPlayer::start(Game& game) {
+    game.setSeed(replay.seed);
+    if (!game.loadLevel(symbolName(replay.level))) {
+        return false;
+    }
+    game.startLevel();
+    game.addSun(replay.startSun - game.getSun());
+    next = 0;
+    applied = 0;
+    desyncs = 0;
+    return true;
+}
+
+void ReplayPlayer::apply(Game& game) {
+    const ArchetypeRegistry& registry = ArchetypeRegistry::instance();
+    while (next < replay.events.size() && replay.events[next].tick <= game.getLevelTick()) {
+        const ReplayEvent& e = replay.events[next++];
+        bool ok = true;
+        switch (e.command) {
+            case ReplayCommand::PlacePlant: {
+                ArchetypeId id = registry.findPlant(e.plant);
+                ok = id != kInvalidArchetype && game.placePlant(id, e.coord);
+                break;
+            }
+            case ReplayCommand::RemovePlant:
+                ok = game.removePlant(e.coord);
+                break;
+            case ReplayCommand::CollectSun:
+                game.collectSun(e.amount);
+                break;
+            default:
+                break;
+        }
+        if (ok) {
+            applied++;
+        } else {
+            desyncs++;
+            PL_LOG_WARN(Game, "Replay desync at tick %llu (command %u)", (unsigned long long)e.tick, (u32)e.command);
+        }
+    }
+}
+
+} // namespace PL
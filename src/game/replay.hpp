@@ -0,0 +1,82 @@
+// ============================================
+// Plant Legends - 重播錄製與播放
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include "core/symbol.hpp"
+#include <string>
+#include <vector>
+
+namespace PL {
+
+class Game;
+
+// 檔案格式（小端序）：
+//   "PLRP" 版本(u8)
+//   seed(varint) 關卡(字串) 步長(f32) 開局陽光(zigzag)
+//   植物字串表：數量(varint)，每筆 長度(varint) + 位元組
+//   事件數(varint)，每筆 tick 差(varint) 指令(u8) 參數...
+//   校驗和(u32，FNV-1a，涵蓋前面所有位元組)
+// 典型的放置事件 5~6 位元組。
+constexpr char kReplayMagic[4] = {'P', 'L', 'R', 'P'};
+constexpr u8 kReplayVersion = 1;
+
+// 玩家輸入
+enum class ReplayCommand : u8 {
+    PlacePlant,    // plant, coord
+    RemovePlant,   // coord（移除最上層）
+    CollectSun,    // amount
+    Count
+};
+
+struct ReplayEvent {
+    u64 tick = 0;                 // 在第 tick 個 tick 執行前套用
+    ReplayCommand command = ReplayCommand::PlacePlant;
+    Symbol plant = kNoSymbol;
+    GridCoord coord;
+    i32 amount = 0;
+};
+
+// 一局的種子與輸入序列。只記錄輸入，模擬結果由確定性的 Game 重新算出
+struct Replay {
+    u64 seed = 0;
+    Symbol level = kNoSymbol;
+    f32 step = 1.0f / 60.0f;      // 錄製時的固定步長，播放必須相同
+    i32 startSun = 0;
+    std::vector<ReplayEvent> events;
+    
+    void clear() { *this = Replay(); }
+    
+    void encode(std::vector<u8>& out) const;
+    bool decode(const u8* data, size_t size);  // 格式錯誤時回傳 false，內容不保證
+    
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+};
+
+// 依 tick 把錄下的輸入送回 Game。
+// 播放端必須載入與錄製時相同的腳本；輸入無法套用（例如陽光對不上）時記為不同步。
+class ReplayPlayer {
+public:
+    explicit ReplayPlayer(const Replay& replay) : replay(replay) {}
+    
+    // 設定種子、載入並開始關卡（game 須已 initialize）
+    bool start(Game& game);
+    
+    // 每 tick 前呼叫：套用時間已到的輸入
+    void apply(Game& game);
+    
+    bool isFinished() const { return next >= replay.events.size(); }
+    u32 getApplied() const { return applied; }
+    u32 getDesyncs() const { return desyncs; }
+
+private:
+    const Replay& replay;
+    size_t next = 0;
+    u32 applied = 0;
+    u32 desyncs = 0;
+};
+
+} // namespace PL
@@ -0,0 +1,44 @@
+// ============================================
+// Plant Legends - Retarget Implementation
+// ============================================
+
+#include "game/retarget.hpp"
+#include "game/entity_store.hpp"
+#include "core/spatial_hash.hpp"
+#include <algorithm>
+
+namespace PL {
+
+void CellWatchers::build(const PlantStore& plants, const SpatialHash& hash) {
+    const u32 cellCount = hash.getCellCount();
+    start.assign(cellCount + 1, 0);
+    
+    // 對每株植物的射程外接矩形做兩遍計數排序
+    auto forEachCell = [&](u32 p, auto&& fn) {
+        const f32 r = plants.range[p];
+        i32 c0, r0, c1, r1;
+        hash.cellBounds(plants.x[p] - r, plants.y[p] - r, plants.x[p] + r, plants.y[p] + r, c0, r0, c1, r1);
+        for (i32 row = r0; row <= r1; row++) {
+            for (i32 col = c0; col <= c1; col++) {
+                fn((u32)(row * hash.getCols() + col));
+            }
+        }
+    };
+    
+    for (u32 p = 0; p < plants.size(); p++) {
+        if (!plants.alive[p]) continue;
+        forEachCell(p, [&](u32 cell) { start[cell + 1]++; });
+    }
+    for (u32 c = 0; c < cellCount; c++) {
+        start[c + 1] += start[c];
+    }
+    
+    watchers.resize(start[cellCount]);
+    std::vector<u32> cursor(start.begin(), start.end() - 1);
+    for (u32 p = 0; p < plants.size(); p++) {
+        if (!plants.alive[p]) continue;
+        forEachCell(p, [&](u32 cell) { watchers[cursor[cell]++] = p; });
+    }
+}
+
+} // namespace PL
@@ -0,0 +1,42 @@
+// ============================================
+// Plant Legends - 增量重新選目標
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include <vector>
+
+namespace PL {
+
+struct PlantStore;
+class SpatialHash;
+
+// 每幀重新選目標的次數
+struct RetargetStats {
+    u32 plants = 0;
+    u32 enemies = 0;
+    u32 cellEvents = 0;  // 敵人生成或跨桶
+};
+
+// 桶 -> 射程覆蓋該桶的植物（dense index）
+// 植物不會移動，只在植物增減後隨空間索引一起重建；
+// 敵人進入某個桶時，只喚醒觀察這個桶的植物。
+class CellWatchers {
+public:
+    void build(const PlantStore& plants, const SpatialHash& hash);
+    
+    template<typename Fn>
+    void forEachWatcher(u32 cell, Fn&& fn) const {
+        if (cell + 1 >= start.size()) return;
+        for (u32 i = start[cell]; i < start[cell + 1]; i++) {
+            fn(watchers[i]);
+        }
+    }
+    
+private:
+    std::vector<u32> start;     // 大小 cellCount + 1
+    std::vector<u32> watchers;
+};
+
+} // namespace PL
@@ -0,0 +1,980 @@
+// ============================================
+// Plant Legends - Script Hooks Implementation
+// ============================================
+
+#include "game/script_hooks.hpp"
+#include "game/game.hpp"
+#include "core/log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+extern "C" {
+#include <lua.h>
+#include <lualib.h>
+#include <lauxlib.h>
+}
+
+namespace PL {
+
+// 參數 userdata 的內容；每次分派前覆寫
+struct ScriptHooks::ArgSlot {
+    ScriptArg arg;
+    i32 table = kNoScriptRef;       // 原型定義表
+    i32 stats = kNoScriptRef;       // 對應的 stats userdata
+    ArgSlot* statsSlot = nullptr;
+};
+
+namespace {
+
+const char* kEntityMeta = "PL.ScriptEntity";
+const char* kStatsMeta = "PL.ScriptStats";
+
+// 範圍傷害一次最多處理的敵人數
+constexpr u32 kMaxAreaTargets = 64;
+
+const char* const kHookNames[kHookCount] = {
+    "on_attack",
+    "on_hit",
+    "on_kill",
+    "on_damage",
+    "on_update",
+    "on_produce",
+    "on_enemy_step",
+    "on_death",
+};
+
+// Lua 端批次分派：逐筆向 C 取出事件（回呼與已填好的參數）後呼叫，
+// 單筆出錯不會中斷整批；回傳錯誤數與第一個錯誤訊息
+const char* const kDispatcherSource = R"lua(
+local pcall = pcall
+return function(next_event, batch)
+    local errors, message = 0, nil
+    while true do
+        local fn, a, b = next_event(batch)
+        if fn == nil then break end
+        local ok, err = pcall(fn, a, b)
+        if not ok then
+            errors = errors + 1
+            message = message or err
+        end
+    end
+    return errors, message
+end
+)lua";
+
+// 把原型表（位於棧頂）中的回呼推上棧；頂層沒有時再看 special 子表
+bool pushHookFunction(lua_State* L, const char* name) {
+    lua_getfield(L, -1, name);
+    if (lua_isfunction(L, -1)) return true;
+    lua_pop(L, 1);
+
+    lua_getfield(L, -1, "special");
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, name);
+        if (lua_isfunction(L, -1)) {
+            lua_remove(L, -2);  // pop special
+            return true;
+        }
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);  // pop special
+    return false;
+}
+
+// 讀取選項表中的數字欄位
+f32 optNumber(lua_State* L, int index, const char* field, f32 fallback) {
+    if (!lua_istable(L, index)) return fallback;
+    lua_getfield(L, index, field);
+    f32 value = lua_isnumber(L, -1) ? (f32)lua_tonumber(L, -1) : fallback;
+    lua_pop(L, 1);
+    return value;
+}
+
+StatusType parseStatus(const char* str) {
+    if (!std::strcmp(str, "burn")) return StatusType::Burn;
+    if (!std::strcmp(str, "slow")) return StatusType::Slow;
+    if (!std::strcmp(str, "freeze")) return StatusType::Freeze;
+    if (!std::strcmp(str, "poison")) return StatusType::Poison;
+    if (!std::strcmp(str, "stun")) return StatusType::Stun;
+    return StatusType::None;
+}
+
+// 植物與敵人共有的數值欄位
+template<typename Store>
+f32* entityField(Store& store, u32 i, const char* key) {
+    if (!std::strcmp(key, "hp")) return &store.hp[i];
+    if (!std::strcmp(key, "max_hp")) return &store.maxHp[i];
+    if (!std::strcmp(key, "x")) return &store.x[i];
+    if (!std::strcmp(key, "y")) return &store.y[i];
+    return nullptr;
+}
+
+f32* statField(Stats& stats, const char* key) {
+    if (!std::strcmp(key, "hp") || !std::strcmp(key, "max_hp")) return &stats.maxHp;
+    if (!std::strcmp(key, "damage")) return &stats.damage;
+    if (!std::strcmp(key, "attack_speed")) return &stats.attackSpeed;
+    if (!std::strcmp(key, "range")) return &stats.range;
+    if (!std::strcmp(key, "speed")) return &stats.speed;
+    if (!std::strcmp(key, "crit_rate")) return &stats.critRate;
+    if (!std::strcmp(key, "crit_mult")) return &stats.critMult;
+    if (!std::strcmp(key, "armor")) return &stats.armor;
+    return nullptr;
+}
+
+// 實體腳本欄位表的鍵：句柄（含世代），移除後重用的槽位不會讀到舊值
+lua_Integer instanceKey(u32 index, u32 generation) {
+    return (lua_Integer)(((u64)generation << 32) | index);
+}
+
+// 原型定義表中的欄位（table 為 registry 引用，field 為 nullptr 時直接取表本身）
+int pushDefinition(lua_State* L, i32 table, const char* field, int key) {
+    lua_rawgeti(L, LUA_REGISTRYINDEX, table);
+    if (!lua_istable(L, -1)) {
+        lua_pushnil(L);
+        return 1;
+    }
+    if (field) {
+        lua_getfield(L, -1, field);
+        lua_remove(L, -2);
+        if (!lua_istable(L, -1)) {
+            lua_pushnil(L);
+            return 1;
+        }
+    }
+    lua_pushvalue(L, key);
+    lua_gettable(L, -2);
+    return 1;
+}
+
+} // namespace
+
+const char* hookName(Hook hook) {
+    return hook < Hook::Count ? kHookNames[(u32)hook] : "unknown";
+}
+
+ScriptHooks& ScriptHooks::instance() {
+    thread_local ScriptHooks hooks;
+    return hooks;
+}
+
+// ============================================
+// 綁定
+// ============================================
+
+bool ScriptHooks::bind(lua_State* state) {
+    // 熱重載在同一個 lua_State 上重新綁定：保留實體的腳本欄位
+    i32 kept[2] = { kNoScriptRef, kNoScriptRef };
+    u32 keptCount = 0;
+    if (state && state == L) {
+        std::swap(kept, instances);
+        keptCount = instanceCount;
+    }
+
+    unbind();
+    if (!state) return false;
+    L = state;
+
+    createFrames();
+    createGameObject();
+    createDispatcher();
+    if (kept[0] != kNoScriptRef) {
+        std::swap(kept, instances);
+        instanceCount = keptCount;
+    } else {
+        createInstances();
+    }
+
+    ArchetypeRegistry& registry = ArchetypeRegistry::instance();
+    u32 bound = 0;
+    for (u32 id = 0; id < registry.getPlantCount(); id++) {
+        HookSet hooks = resolve("plants", registry.plant((ArchetypeId)id).id);
+        registry.setPlantHooks((ArchetypeId)id, hooks);
+        activeMask |= hooks.mask;
+        bound += hooks.any() ? 1 : 0;
+    }
+    for (u32 id = 0; id < registry.getEnemyCount(); id++) {
+        HookSet hooks = resolve("enemies", registry.enemy((ArchetypeId)id).id);
+        registry.setEnemyHooks((ArchetypeId)id, hooks);
+        activeMask |= hooks.mask;
+        bound += hooks.any() ? 1 : 0;
+    }
+
+    PL_LOG_INFO(Lua, "Script hooks: %u archetypes, %zu refs", bound, ownedRefs.size());
+    return true;
+}
+
+void ScriptHooks::unbind() {
+    if (!L) return;
+
+    for (i32 ref : ownedRefs) {
+        luaL_unref(L, LUA_REGISTRYINDEX, ref);
+    }
+    ownedRefs.clear();
+    for (i32& table : instances) {
+        if (table != kNoScriptRef) {
+            luaL_unref(L, LUA_REGISTRYINDEX, table);
+            table = kNoScriptRef;
+        }
+    }
+    instanceCount = 0;
+
+    ArchetypeRegistry& registry = ArchetypeRegistry::instance();
+    for (u32 id = 0; id < registry.getPlantCount(); id++) {
+        registry.setPlantHooks((ArchetypeId)id, HookSet());
+    }
+    for (u32 id = 0; id < registry.getEnemyCount(); id++) {
+        registry.setEnemyHooks((ArchetypeId)id, HookSet());
+    }
+
+    for (Frame& frame : frames) {
+        frame = Frame();
+    }
+    results.clear();
+    resultRefs.clear();
+    discard();
+    dispatcher = kNoScriptRef;
+    activeMask = 0;
+    depth = 0;
+    L = nullptr;
+}
+
+HookSet ScriptHooks::resolve(const char* global, Symbol id) {
+    HookSet hooks;
+
+    lua_getglobal(L, global);
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, symbolName(id));
+        if (lua_istable(L, -1)) {
+            for (u32 h = 0; h < kHookCount; h++) {
+                if (!pushHookFunction(L, kHookNames[h])) continue;
+                hooks.refs[h] = luaL_ref(L, LUA_REGISTRYINDEX);
+                hooks.mask |= (u16)(1u << h);
+                ownedRefs.push_back(hooks.refs[h]);
+            }
+
+            // 有回呼的原型才保留定義表（self.production 等欄位的後備）
+            if (hooks.any()) {
+                lua_pushvalue(L, -1);
+                hooks.table = luaL_ref(L, LUA_REGISTRYINDEX);
+                ownedRefs.push_back(hooks.table);
+            }
+        }
+        lua_pop(L, 1);  // pop archetype
+    }
+    lua_pop(L, 1);  // pop global
+
+    return hooks;
+}
+
+void ScriptHooks::createFrames() {
+    // 實體參數：欄位直接讀寫 SoA，方法在 __index 的 upvalue 中
+    static const luaL_Reg entityMethods[] = {
+        { "shoot", entityShoot },
+        { "apply_status", entityApplyStatus },
+        { "take_damage", entityTakeDamage },
+        { "destroy", entityDestroy },
+        { "spawn_particle", noop },   // 渲染端尚無粒子系統
+        { nullptr, nullptr }
+    };
+
+    luaL_newmetatable(L, kEntityMeta);
+    lua_newtable(L);
+    luaL_setfuncs(L, entityMethods, 0);
+    lua_pushvalue(L, -1);
+    lua_pushcclosure(L, entityIndex, 1);
+    lua_setfield(L, -3, "__index");
+    lua_pushcclosure(L, entityNewIndex, 1);  // 方法名稱不可覆寫
+    lua_setfield(L, -2, "__newindex");
+    lua_pop(L, 1);
+
+    luaL_newmetatable(L, kStatsMeta);
+    lua_pushcfunction(L, statsIndex);
+    lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, statsNewIndex);
+    lua_setfield(L, -2, "__newindex");
+    lua_pop(L, 1);
+
+    // 每層兩個參數
+    for (Frame& frame : frames) {
+        for (u32 s = 0; s < 2; s++) {
+            frame.args[s] = createArg(frame.refs[s]);
+        }
+    }
+}
+
+// 實體參數 userdata，帶一個 stats 視圖；都以 registry 引用常駐
+ScriptHooks::ArgSlot* ScriptHooks::createArg(i32& ref) {
+    ArgSlot* slot = new (lua_newuserdata(L, sizeof(ArgSlot))) ArgSlot();
+    luaL_setmetatable(L, kEntityMeta);
+    ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    ownedRefs.push_back(ref);
+
+    slot->statsSlot = new (lua_newuserdata(L, sizeof(ArgSlot))) ArgSlot();
+    luaL_setmetatable(L, kStatsMeta);
+    slot->stats = luaL_ref(L, LUA_REGISTRYINDEX);
+    ownedRefs.push_back(slot->stats);
+    return slot;
+}
+
+// 第 n 個查詢結果的參數，不足時才建立
+ScriptHooks::ArgSlot* ScriptHooks::resultArg(u32 n, i32& ref) {
+    while (results.size() <= n) {
+        i32 created;
+        results.push_back(createArg(created));
+        resultRefs.push_back(created);
+    }
+    ref = resultRefs[n];
+    return results[n];
+}
+
+void ScriptHooks::createGameObject() {
+    static const luaL_Reg gameMethods[] = {
+        { "add_sun", gameAddSun },
+        { "add_combo", noop },        // 尚無連擊系統
+        { "area_damage", gameAreaDamage },
+        { "line_damage", gameLineDamage },
+        { "spawn_enemy", gameSpawnEnemy },
+        { "spawn_effect", noop },     // 特效由渲染端處理
+        { "show_text", noop },        // 尚無浮動文字 UI
+        { "cone_damage", gameConeDamage },
+        { "get_enemies_in_cone", gameEnemiesInCone },
+        { "random", gameRandom },
+        { nullptr, nullptr }
+    };
+
+    lua_newtable(L);
+    luaL_setfuncs(L, gameMethods, 0);
+    lua_setglobal(L, "game");
+}
+
+void ScriptHooks::createDispatcher() {
+    if (luaL_loadbuffer(L, kDispatcherSource, std::strlen(kDispatcherSource), "=script_hooks") != LUA_OK ||
+        lua_pcall(L, 0, 1, 0) != LUA_OK) {
+        PL_LOG_ERROR(Lua, "Hook dispatcher: %s", lua_tostring(L, -1));
+        lua_pop(L, 1);
+        return;
+    }
+    dispatcher = luaL_ref(L, LUA_REGISTRYINDEX);
+    ownedRefs.push_back(dispatcher);
+
+    for (auto& queue : queues) {
+        queue.reserve(kQueueReserve);
+    }
+}
+
+void ScriptHooks::createInstances() {
+    for (i32& table : instances) {
+        lua_newtable(L);
+        table = luaL_ref(L, LUA_REGISTRYINDEX);
+    }
+    instanceCount = 0;
+}
+
+void ScriptHooks::clearInstances() {
+    if (!L || instanceCount == 0) return;
+
+    // 換上空表，舊表交給 GC
+    for (i32 table : instances) {
+        lua_newtable(L);
+        lua_rawseti(L, LUA_REGISTRYINDEX, table);
+    }
+    instanceCount = 0;
+}
+
+bool ScriptHooks::pushInstance(lua_State* state, const ArgSlot& slot, bool create) {
+    const bool plant = slot.arg.kind == ScriptArg::Plant;
+    const i32 table = instances[plant ? 0 : 1];
+    if (table == kNoScriptRef) return false;
+
+    const u32 i = slot.arg.index;
+    lua_Integer key;
+    if (plant) {
+        PlantHandle handle = game->plants.handleAt(i);
+        key = instanceKey(handle.index, handle.generation);
+    } else {
+        EnemyHandle handle = game->enemies.handleAt(i);
+        key = instanceKey(handle.index, handle.generation);
+    }
+    lua_rawgeti(state, LUA_REGISTRYINDEX, table);
+    if (lua_rawgeti(state, -1, key) == LUA_TTABLE) {
+        lua_remove(state, -2);
+        return true;
+    }
+    lua_pop(state, 1);
+    if (!create) {
+        lua_pop(state, 1);
+        return false;
+    }
+
+    // 第一次寫入時才建立
+    lua_newtable(state);
+    lua_pushvalue(state, -1);
+    lua_rawseti(state, -3, key);
+    lua_remove(state, -2);
+    instanceCount++;
+    return true;
+}
+
+void ScriptHooks::dropInstance(ScriptArg::Kind kind, u32 index, u32 generation) {
+    if (!L) return;
+
+    const lua_Integer key = instanceKey(index, generation);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, instances[kind == ScriptArg::Plant ? 0 : 1]);
+    if (lua_rawgeti(L, -1, key) != LUA_TNIL) {
+        lua_pushnil(L);
+        lua_rawseti(L, -3, key);
+        instanceCount--;
+    }
+    lua_pop(L, 2);
+}
+
+// ============================================
+// 分派
+// ============================================
+
+i32 ScriptHooks::tableOf(ScriptArg arg) const {
+    switch (arg.kind) {
+        case ScriptArg::Plant: return game->plants.objects[arg.index].getArchetype().hooks.table;
+        case ScriptArg::Enemy: return game->enemies.objects[arg.index].getArchetype().hooks.table;
+        default: return kNoScriptRef;
+    }
+}
+
+void ScriptHooks::pushArg(Frame& frame, u32 s, ScriptArg arg) {
+    ArgSlot* slot = frame.args[s];
+    slot->arg = arg;
+    slot->table = tableOf(arg);
+    lua_rawgeti(L, LUA_REGISTRYINDEX, frame.refs[s]);
+}
+
+bool ScriptHooks::dispatch(Hook hook, const HookSet& hooks, ScriptArg self, ScriptArg other,
+                           const f32* number, f32* result, bool* verdict) {
+    if (!L || !game) return false;
+
+    HookStats& stat = stats[(u32)hook];
+    if (depth >= kMaxDepth) {
+        stat.dropped++;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Frame& frame = frames[depth++];
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, hooks.refs[(u32)hook]);
+    pushArg(frame, 0, self);
+    int nargs = 1;
+    if (other.kind != ScriptArg::None) {
+        pushArg(frame, 1, other);
+        nargs++;
+    } else if (number) {
+        lua_pushnumber(L, *number);
+        nargs++;
+    }
+
+    bool ok = lua_pcall(L, nargs, result || verdict ? 1 : 0, 0) == LUA_OK;
+    if (!ok) {
+        // 同一種回呼只記錄第一個錯誤，之後只計數
+        if (stat.errors++ == 0) {
+            PL_LOG_ERROR(Lua, "%s: %s", hookName(hook), lua_tostring(L, -1));
+        }
+        lua_pop(L, 1);
+    } else if (result) {
+        ok = lua_isnumber(L, -1) != 0;
+        if (ok) {
+            *result = (f32)lua_tonumber(L, -1);
+        }
+        lua_pop(L, 1);
+    } else if (verdict) {
+        *verdict = !lua_isboolean(L, -1) || lua_toboolean(L, -1);
+        lua_pop(L, 1);
+    }
+
+    depth--;
+    stat.calls++;
+    stat.ms += std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
+
+bool ScriptHooks::filter(Hook hook, const HookSet& hooks, ScriptArg self, f32& value) {
+    if (!hooks.has(hook)) return false;
+    return dispatch(hook, hooks, self, {}, &value, &value);
+}
+
+bool ScriptHooks::confirm(Hook hook, const HookSet& hooks, ScriptArg self) {
+    bool verdict = true;
+    if (hooks.has(hook)) {
+        dispatch(hook, hooks, self, {}, nullptr, nullptr, &verdict);
+    }
+    return verdict;
+}
+
+void ScriptHooks::flush() {
+    if (!L || !game || dispatcher == kNoScriptRef) {
+        discard();
+        return;
+    }
+
+    for (u32 round = 0; round < kMaxFlushRounds; round++) {
+        bool any = false;
+        for (u32 h = 0; h < kHookCount; h++) {
+            any |= flushQueue((Hook)h);
+        }
+        if (!any) return;
+    }
+
+    // 回呼連鎖產生事件超過輪數上限
+    for (u32 h = 0; h < kHookCount; h++) {
+        stats[h].dropped += queues[h].size();
+        queues[h].clear();
+    }
+}
+
+void ScriptHooks::discard() {
+    for (auto& queue : queues) {
+        queue.clear();
+    }
+}
+
+bool ScriptHooks::flushQueue(Hook hook) {
+    std::vector<ScriptEvent>& queue = queues[(u32)hook];
+    if (queue.empty()) return false;
+
+    HookStats& stat = stats[(u32)hook];
+    if (depth >= kMaxDepth) {
+        stat.dropped += queue.size();
+        queue.clear();
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // 只分派目前已排入的事件；回呼中新排入的留到下一輪
+    Batch batch;
+    batch.queue = &queue;
+    batch.frame = &frames[depth++];
+    batch.end = (u32)queue.size();
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, dispatcher);
+    lua_pushcfunction(L, batchNext);
+    lua_pushlightuserdata(L, &batch);
+    if (lua_pcall(L, 2, 2, 0) != LUA_OK) {
+        stat.errors++;
+        PL_LOG_ERROR(Lua, "%s batch: %s", hookName(hook), lua_tostring(L, -1));
+        lua_pop(L, 1);
+    } else {
+        u64 errors = (u64)lua_tointeger(L, -2);
+        if (errors > 0 && stat.errors == 0) {
+            PL_LOG_ERROR(Lua, "%s: %s", hookName(hook), lua_tostring(L, -1));
+        }
+        stat.errors += errors;
+        lua_pop(L, 2);
+    }
+    depth--;
+
+    queue.erase(queue.begin(), queue.begin() + batch.end);
+    stat.calls += batch.end;
+    stat.batches++;
+    stat.ms += std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+void ScriptHooks::resetStats() {
+    for (HookStats& stat : stats) {
+        stat = HookStats();
+    }
+}
+
+void ScriptHooks::logStats() const {
+    for (u32 h = 0; h < kHookCount; h++) {
+        const HookStats& stat = stats[h];
+        if (stat.calls == 0 && stat.dropped == 0) continue;
+
+        PL_LOG_INFO(Lua, "Hook %s: %llu calls in %llu batches, %.3f ms (%.2f us/call), %llu errors, %llu dropped",
+                    kHookNames[h], (unsigned long long)stat.calls, (unsigned long long)stat.batches, stat.ms,
+                    stat.calls ? stat.ms * 1000.0 / stat.calls : 0.0,
+                    (unsigned long long)stat.errors, (unsigned long long)stat.dropped);
+    }
+}
+
+// ============================================
+// Lua 端 API
+// ============================================
+
+ScriptHooks::ArgSlot* ScriptHooks::checkArg(lua_State* L, int index, const char* meta) {
+    ArgSlot* slot = (ArgSlot*)luaL_checkudata(L, index, meta);
+    const Game* game = instance().game;
+
+    // 參數只在回呼期間有效，保留到回呼外的引用可能已指向別的實體
+    u32 size = 0;
+    if (game) {
+        size = slot->arg.kind == ScriptArg::Plant ? game->plants.size() :
+               slot->arg.kind == ScriptArg::Enemy ? game->enemies.size() : 0;
+    }
+    if (slot->arg.index >= size) {
+        luaL_error(L, "entity is no longer valid");
+    }
+    return slot;
+}
+
+int ScriptHooks::entityIndex(lua_State* L) {
+    ArgSlot* slot = checkArg(L, 1, kEntityMeta);
+    Game& game = *instance().game;
+    const u32 i = slot->arg.index;
+    const bool plant = slot->arg.kind == ScriptArg::Plant;
+
+    if (const char* key = lua_type(L, 2) == LUA_TSTRING ? lua_tostring(L, 2) : nullptr) {
+        f32* field = plant ? entityField(game.plants, i, key) : entityField(game.enemies, i, key);
+        if (field) {
+            lua_pushnumber(L, *field);
+            return 1;
+        }
+        if (!std::strcmp(key, "row")) {
+            lua_pushinteger(L, plant ? game.plants.row[i] : game.enemies.row[i]);
+            return 1;
+        }
+        if (!std::strcmp(key, "stats")) {
+            slot->statsSlot->arg = slot->arg;
+            slot->statsSlot->table = slot->table;
+            lua_rawgeti(L, LUA_REGISTRYINDEX, slot->stats);
+            return 1;
+        }
+        if (!std::strcmp(key, "id")) {
+            Symbol id = plant ? game.plants.objects[i].getPlantId() : game.enemies.objects[i].getEnemyId();
+            lua_pushstring(L, symbolName(id));
+            return 1;
+        }
+    }
+
+    // 方法
+    lua_pushvalue(L, 2);
+    lua_rawget(L, lua_upvalueindex(1));
+    if (!lua_isnil(L, -1)) return 1;
+    lua_pop(L, 1);
+
+    // 實體自己的欄位
+    ScriptHooks& hooks = instance();
+    if (hooks.instanceCount > 0 && hooks.pushInstance(L, *slot, false)) {
+        lua_pushvalue(L, 2);
+        lua_rawget(L, -2);
+        if (!lua_isnil(L, -1)) return 1;
+        lua_pop(L, 2);
+    }
+
+    // 原型定義表（production、revive_count 的初始值等）
+    return pushDefinition(L, slot->table, nullptr, 2);
+}
+
+int ScriptHooks::entityNewIndex(lua_State* L) {
+    ArgSlot* slot = checkArg(L, 1, kEntityMeta);
+    Game& game = *instance().game;
+    const u32 i = slot->arg.index;
+    const char* key = luaL_checkstring(L, 2);
+    const bool plant = slot->arg.kind == ScriptArg::Plant;
+
+    // 血量寫回 SoA（夾在 0..max_hp）
+    if (!std::strcmp(key, "hp")) {
+        f32 value = (f32)luaL_checknumber(L, 3);
+        if (plant) {
+            game.plants.hp[i] = std::clamp(value, 0.0f, game.plants.maxHp[i]);
+        } else {
+            game.enemies.hp[i] = std::clamp(value, 0.0f, game.enemies.maxHp[i]);
+        }
+        return 0;
+    }
+
+    // 其他 SoA 欄位與方法唯讀
+    if ((plant ? entityField(game.plants, i, key) : entityField(game.enemies, i, key)) ||
+        !std::strcmp(key, "row") || !std::strcmp(key, "stats") || !std::strcmp(key, "id")) {
+        return luaL_error(L, "field '%s' is read-only", key);
+    }
+    lua_pushvalue(L, 2);
+    lua_rawget(L, lua_upvalueindex(1));
+    if (!lua_isnil(L, -1)) {
+        return luaL_error(L, "field '%s' is read-only", key);
+    }
+    lua_pop(L, 1);
+
+    // 其餘寫進實體自己的表，不影響原型與其他實體
+    instance().pushInstance(L, *slot, true);
+    lua_pushvalue(L, 2);
+    lua_pushvalue(L, 3);
+    lua_rawset(L, -3);
+    return 0;
+}
+
+int ScriptHooks::statsIndex(lua_State* L) {
+    ArgSlot* slot = checkArg(L, 1, kStatsMeta);
+    Game& game = *instance().game;
+    const u32 i = slot->arg.index;
+    const bool plant = slot->arg.kind == ScriptArg::Plant;
+
+    if (const char* key = lua_type(L, 2) == LUA_TSTRING ? lua_tostring(L, 2) : nullptr) {
+        Stats& stats = plant ? game.plants.objects[i].getStats() : game.enemies.objects[i].getStats();
+        if (f32* field = statField(stats, key)) {
+            // 敵人移動速度以欄位為準（減速等效果不改基礎值）
+            lua_pushnumber(L, !plant && field == &stats.speed ? game.enemies.speed[i] : *field);
+            return 1;
+        }
+    }
+
+    // 定義表 stats 中的其他欄位（regen 等）
+    return pushDefinition(L, slot->table, "stats", 2);
+}
+
+int ScriptHooks::statsNewIndex(lua_State* L) {
+    ArgSlot* slot = checkArg(L, 1, kStatsMeta);
+    Game& game = *instance().game;
+    const u32 i = slot->arg.index;
+    const bool plant = slot->arg.kind == ScriptArg::Plant;
+    const char* key = luaL_checkstring(L, 2);
+
+    Stats& stats = plant ? game.plants.objects[i].getStats() : game.enemies.objects[i].getStats();
+    f32* field = statField(stats, key);
+    if (!field) {
+        return luaL_error(L, "unknown stat '%s'", key);
+    }
+    *field = (f32)luaL_checknumber(L, 3);
+
+    // 同步熱資料欄位
+    if (field == &stats.speed && !plant) {
+        game.enemies.speed[i] = stats.speed;
+    } else if (field == &stats.range && plant) {
+        game.plants.range[i] = stats.range;
+        game.plants.retarget[i] = 1;
+        game.plantHashDirty = true;   // 觀察的桶跟著射程變
+    } else if (field == &stats.maxHp) {
+        (plant ? game.plants.maxHp[i] : game.enemies.maxHp[i]) = stats.maxHp;
+    }
+    return 0;
+}
+
+int ScriptHooks::entityShoot(lua_State* L) {
+    ArgSlot* slot = checkArg(L, 1, kEntityMeta);
+    if (slot->arg.kind != ScriptArg::Plant) {
+        return luaL_error(L, "shoot: self is not a plant");
+    }
+
+    Game& game = *instance().game;
+    const u32 i = slot->arg.index;
+    EnemyHandle target = game.plants.target[i];
+    if (!game.enemies.isAlive(target)) return 0;
+
+    f32 damage = optNumber(L, 2, "damage", game.plants.objects[i].getStats().damage);
+    i32 count = (i32)optNumber(L, 2, "count", 1.0f);
+    for (i32 n = 0; n < count; n++) {
+        game.spawnProjectile(game.plants.position(i), target, game.rollCrit(i, damage), game.plants.element[i],
+                             game.plants.handleAt(i));
+    }
+    return 0;
+}
+
+int ScriptHooks::entityApplyStatus(lua_State* L) {
+    ArgSlot* slot = checkArg(L, 1, kEntityMeta);
+    const char* name = luaL_checkstring(L, 2);
+    StatusType type = parseStatus(name);
+    if (type == StatusType::None) {
+        return luaL_error(L, "unknown status '%s'", name);
+    }
+
+    // 燃燒/中毒取 damage（每秒），減速取 amount
+    f32 value = optNumber(L, 3, type == StatusType::Slow ? "amount" : "damage", 0.0f);
+    StatusEffect effect(type, optNumber(L, 3, "duration", 1.0f), value);
+
+    Game& game = *instance().game;
+    if (slot->arg.kind == ScriptArg::Plant) {
+        game.addStatus(game.plants.handleAt(slot->arg.index), effect);
+    } else {
+        game.addStatus(game.enemies.handleAt(slot->arg.index), effect);
+    }
+    return 0;
+}
+
+int ScriptHooks::entityTakeDamage(lua_State* L) {
+    ArgSlot* slot = checkArg(L, 1, kEntityMeta);
+    f32 damage = (f32)luaL_checknumber(L, 2);
+
+    Game& game = *instance().game;
+    if (slot->arg.kind == ScriptArg::Plant) {
+        game.damagePlant(slot->arg.index, damage);
+    } else {
+        game.damageEnemy(slot->arg.index, damage);
+    }
+    return 0;
+}
+
+int ScriptHooks::entityDestroy(lua_State* L) {
+    ArgSlot* slot = checkArg(L, 1, kEntityMeta);
+
+    // 標記死亡，tick 結束時統一移除（植物一併移出網格）
+    Game& game = *instance().game;
+    if (slot->arg.kind == ScriptArg::Plant) {
+        game.plants.alive[slot->arg.index] = 0;
+    } else {
+        game.enemies.alive[slot->arg.index] = 0;
+    }
+    return 0;
+}
+
+int ScriptHooks::gameAddSun(lua_State* L) {
+    if (Game* game = instance().game) {
+        game->addSun((i32)luaL_checknumber(L, 2));
+    }
+    return 0;
+}
+
+int ScriptHooks::gameRandom(lua_State* L) {
+    // 同 math.random 的參數形式，但取自遊戲的 Script 子串流，可隨種子重現
+    Game* game = instance().game;
+    if (!game) return luaL_error(L, "random: no game");
+
+    Pcg32& rng = game->getRandom(RandomStream::Script);
+    switch (lua_gettop(L)) {
+        case 1:
+            lua_pushnumber(L, rng.nextFloat());
+            return 1;
+        case 2: {
+            lua_Integer m = luaL_checkinteger(L, 2);
+            luaL_argcheck(L, m >= 1 && m <= INT32_MAX, 2, "interval is empty");
+            lua_pushinteger(L, rng.range(1, (i32)m));
+            return 1;
+        }
+        default: {
+            lua_Integer m = luaL_checkinteger(L, 2);
+            lua_Integer n = luaL_checkinteger(L, 3);
+            luaL_argcheck(L, m <= n && m >= INT32_MIN && n <= INT32_MAX, 3, "interval is empty");
+            lua_pushinteger(L, rng.range((i32)m, (i32)n));
+            return 1;
+        }
+    }
+}
+
+int ScriptHooks::gameAreaDamage(lua_State* L) {
+    Vec2 center((f32)luaL_checknumber(L, 2), (f32)luaL_checknumber(L, 3));
+    f32 radius = (f32)luaL_checknumber(L, 4);
+    f32 damage = (f32)luaL_checknumber(L, 5);
+
+    Game* game = instance().game;
+    if (!game) return 0;
+
+    EnemyHandle hits[kMaxAreaTargets];
+    u32 count = game->queryRadius(center, radius, hits, kMaxAreaTargets);
+    for (u32 n = 0; n < count; n++) {
+        u32 e = game->enemies.resolve(hits[n]);
+        if (e != kInvalidIndex && game->enemies.alive[e]) {
+            game->damageEnemy(e, damage);
+        }
+    }
+    return 0;
+}
+
+int ScriptHooks::gameLineDamage(lua_State* L) {
+    i32 row = (i32)luaL_checkinteger(L, 2);
+    f32 damage = (f32)luaL_checknumber(L, 3);
+
+    Game* game = instance().game;
+    if (!game) return 0;
+
+    EnemyStore& enemies = game->enemies;
+    for (u32 e = 0; e < enemies.size(); e++) {
+        if (enemies.alive[e] && enemies.row[e] == row) {
+            game->damageEnemy(e, damage);
+        }
+    }
+    return 0;
+}
+
+int ScriptHooks::gameConeDamage(lua_State* L) {
+    Vec2 origin((f32)luaL_checknumber(L, 2), (f32)luaL_checknumber(L, 3));
+    f32 angle = (f32)luaL_checknumber(L, 4);
+    f32 range = (f32)luaL_checknumber(L, 5);
+    f32 damage = (f32)luaL_checknumber(L, 6);
+
+    Game* game = instance().game;
+    if (!game) return 0;
+
+    EnemyHandle hits[kMaxAreaTargets];
+    u32 count = game->queryCone(origin, angle, range, hits, kMaxAreaTargets);
+    for (u32 n = 0; n < count; n++) {
+        u32 e = game->enemies.resolve(hits[n]);
+        if (e != kInvalidIndex && game->enemies.alive[e]) {
+            game->damageEnemy(e, damage);
+        }
+    }
+    return 0;
+}
+
+int ScriptHooks::gameEnemiesInCone(lua_State* L) {
+    Vec2 origin((f32)luaL_checknumber(L, 2), (f32)luaL_checknumber(L, 3));
+    f32 angle = (f32)luaL_checknumber(L, 4);
+    f32 range = (f32)luaL_checknumber(L, 5);
+
+    ScriptHooks& hooks = instance();
+    Game* game = hooks.game;
+    if (!game) {
+        lua_newtable(L);
+        return 1;
+    }
+
+    // 回傳的實體與回呼參數一樣只在回呼期間有效，下一次查詢會重用
+    EnemyHandle hits[kMaxAreaTargets];
+    u32 count = game->queryCone(origin, angle, range, hits, kMaxAreaTargets);
+    lua_createtable(L, (int)count, 0);
+    u32 n = 0;
+    for (u32 h = 0; h < count; h++) {
+        u32 e = game->enemies.resolve(hits[h]);
+        if (e == kInvalidIndex || !game->enemies.alive[e]) continue;
+
+        i32 ref;
+        ArgSlot* slot = hooks.resultArg(n, ref);
+        slot->arg = ScriptArg::enemy(e);
+        slot->table = hooks.tableOf(slot->arg);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+        lua_rawseti(L, -2, ++n);
+    }
+    return 1;
+}
+
+int ScriptHooks::gameSpawnEnemy(lua_State* L) {
+    const char* id = luaL_checkstring(L, 2);
+    Game* game = instance().game;
+    if (!game) return 0;
+
+    ArchetypeId archetype = ArchetypeRegistry::instance().findEnemy(id);
+    if (archetype == kInvalidArchetype) {
+        PL_LOG_ERROR(Spawn, "Unknown enemy: %s", id);
+        return 0;
+    }
+
+    // 位置選填：y 換算成行，x 預設為場外生成點
+    const GridConfig& grid = game->getGridConfig();
+    f32 y = optNumber(L, 3, "y", game->rowCenterY(0));
+    i32 row = (i32)optNumber(L, 3, "row", (f32)game->worldToGrid(Vec2(0.0f, y)).row);
+    row = std::clamp(row, 0, grid.rows - 1);
+    game->spawnEnemy(archetype, row, optNumber(L, 3, "x", kEnemySpawnX));
+    return 0;
+}
+
+int ScriptHooks::batchNext(lua_State* L) {
+    Batch* batch = (Batch*)lua_touserdata(L, 1);
+    if (!batch || batch->next >= batch->end) return 0;
+
+    // 依索引讀取：回呼排入新事件可能使佇列重新配置
+    const ScriptEvent event = (*batch->queue)[batch->next++];
+    ScriptHooks& hooks = instance();
+    lua_rawgeti(L, LUA_REGISTRYINDEX, event.fn);
+    hooks.pushArg(*batch->frame, 0, event.self);
+    if (event.other.kind != ScriptArg::None) {
+        hooks.pushArg(*batch->frame, 1, event.other);
+    } else {
+        lua_pushnumber(L, event.number);
+    }
+    return 3;
+}
+
+int ScriptHooks::noop(lua_State*) {
+    return 0;
+}
+
+} // namespace PL
@@ -0,0 +1,221 @@
+// ============================================
+// Plant Legends - 腳本回呼分派
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include "core/symbol.hpp"
+#include "core/handle.hpp"
+#include <vector>
+
+struct lua_State;
+
+namespace PL {
+
+class Game;
+
+// 腳本可定義的回呼
+enum class Hook : u8 {
+    Attack,      // on_attack(self, target)：取代預設的單發投射物
+    Hit,         // on_hit(self, target)：本植物的投射物命中
+    Kill,        // on_kill(self, enemy)：本植物造成擊殺
+    Damage,      // on_damage(self, damage)：回傳實際承受的傷害
+    Update,      // on_update(self, dt)
+    Produce,     // on_produce(self)
+    EnemyStep,   // on_enemy_step(self, enemy)：敵人走進本格
+    Death,       // on_death(self)：植物回傳 false 時取消死亡
+    Count
+};
+
+constexpr u32 kHookCount = (u32)Hook::Count;
+
+const char* hookName(Hook hook);
+
+// 同 LUA_NOREF，header 不引入 Lua
+constexpr i32 kNoScriptRef = -2;
+
+// 每個原型的回呼 registry 引用，載入時解析一次。
+// mask 為 0 的原型在分派時只測一個整數就略過。
+struct HookSet {
+    i32 refs[kHookCount] = { kNoScriptRef, kNoScriptRef, kNoScriptRef, kNoScriptRef,
+                             kNoScriptRef, kNoScriptRef, kNoScriptRef, kNoScriptRef };
+    i32 table = kNoScriptRef;   // 原型定義表（self 欄位查不到時的後備）
+    u16 mask = 0;
+
+    bool has(Hook hook) const { return (mask >> (u32)hook) & 1u; }
+    bool any() const { return mask != 0; }
+};
+
+// 回呼參數：SoA 中的 dense index（tick 內不會因移除而搬動）
+struct ScriptArg {
+    enum Kind : u8 { None, Plant, Enemy };
+
+    Kind kind = None;
+    u32 index = kInvalidIndex;
+
+    static ScriptArg plant(u32 index) { return { Plant, index }; }
+    static ScriptArg enemy(u32 index) { return { Enemy, index }; }
+};
+
+// 排入批次的事件
+struct ScriptEvent {
+    i32 fn = kNoScriptRef;
+    ScriptArg self;
+    ScriptArg other;
+    f32 number = 0.0f;  // other 為空時的第二個參數（on_update 的 dt）
+};
+
+// 每種回呼的統計
+struct HookStats {
+    u64 calls = 0;
+    u64 batches = 0;    // 批次呼叫（C -> Lua 的 pcall 次數）
+    u64 errors = 0;
+    u64 dropped = 0;    // 巢狀過深或批次輪數用盡而略過
+    f64 ms = 0.0;
+};
+
+// 回呼分派層
+// bind() 時把每個原型的 on_* 函數存成 luaL_ref，並預先配置參數 userdata；
+// 分派只有 lua_rawgeti + 覆寫 userdata 內容 + lua_pcall，不查表也不配置記憶體。
+//
+// 只通知、不影響當下結果的回呼（命中、擊殺、敵人死亡、踩踏、更新）以 post() 排入
+// 各自的佇列，tick 結束時 flush() 每種回呼只 pcall 一次 Lua 端的分派函數，
+// 由它在 Lua 內逐筆取出事件呼叫。C -> Lua 的切換次數與回呼種類數成正比，
+// 不隨事件數成長。on_attack / on_damage / 植物 on_death 的結果當下就要用到，仍同步呼叫。
+class ScriptHooks {
+public:
+    static ScriptHooks& instance();  // 每個執行緒一份，對應該執行緒的 LuaManager
+
+    // 從 plants / enemies 全域表解析原型表中每個原型的回呼（重複呼叫會先釋放舊引用）
+    bool bind(lua_State* L);
+    void unbind();
+    bool isBound() const { return L != nullptr; }
+
+    // 回呼操作的遊戲實例
+    void setGame(Game* g) { game = g; }
+
+    // 任一原型定義了該回呼
+    bool isActive(Hook hook) const { return (activeMask >> (u32)hook) & 1u; }
+
+    // 呼叫回呼；原型沒有該回呼、未綁定或出錯時回傳 false
+    bool call(Hook hook, const HookSet& hooks, ScriptArg self, ScriptArg other = {}) {
+        if (!hooks.has(hook)) return false;
+        return dispatch(hook, hooks, self, other, nullptr, nullptr);
+    }
+
+    bool call(Hook hook, const HookSet& hooks, ScriptArg self, f32 number) {
+        if (!hooks.has(hook)) return false;
+        return dispatch(hook, hooks, self, {}, &number, nullptr);
+    }
+
+    // 回呼回傳數字時取代 value（on_damage）
+    bool filter(Hook hook, const HookSet& hooks, ScriptArg self, f32& value);
+
+    // 回呼明確回傳 false 時回傳 false（植物 on_death 取消死亡）；沒有回呼或出錯時回傳 true
+    bool confirm(Hook hook, const HookSet& hooks, ScriptArg self);
+
+    // 排入本 tick 的批次；原型沒有該回呼時不排入
+    void post(Hook hook, const HookSet& hooks, ScriptArg self, ScriptArg other = {}) {
+        if (!hooks.has(hook)) return;
+        queues[(u32)hook].push_back({ hooks.refs[(u32)hook], self, other, 0.0f });
+    }
+
+    void post(Hook hook, const HookSet& hooks, ScriptArg self, f32 number) {
+        if (!hooks.has(hook)) return;
+        queues[(u32)hook].push_back({ hooks.refs[(u32)hook], self, {}, number });
+    }
+
+    // 分派所有佇列中的事件（實體移除前呼叫，dense index 仍有效）
+    // 回呼中產生的新事件在下一輪分派，最多 kMaxFlushRounds 輪
+    void flush();
+    void discard();  // 丟棄未分派的事件
+    u32 getPending(Hook hook) const { return (u32)queues[(u32)hook].size(); }
+
+    // 實體自己的腳本欄位（self.revive_count = ... 這類寫入）。
+    // 讀取時先查實體的表再查原型定義表；實體移除時由 Game 釋放。
+    void releaseInstance(PlantHandle plant) {
+        if (instanceCount > 0) dropInstance(ScriptArg::Plant, plant.index, plant.generation);
+    }
+    void releaseInstance(EnemyHandle enemy) {
+        if (instanceCount > 0) dropInstance(ScriptArg::Enemy, enemy.index, enemy.generation);
+    }
+    void clearInstances();
+
+    const HookStats& getStats(Hook hook) const { return stats[(u32)hook]; }
+    void resetStats();
+    void logStats() const;
+
+private:
+    ScriptHooks() = default;
+
+    // 巢狀呼叫（回呼內造成擊殺等）每層各用一組參數 userdata
+    static constexpr u32 kMaxDepth = 4;
+    static constexpr u32 kMaxFlushRounds = 4;
+    static constexpr u32 kQueueReserve = 256;
+
+    struct ArgSlot;
+    struct Frame {
+        ArgSlot* args[2] = {};
+        i32 refs[2] = { kNoScriptRef, kNoScriptRef };
+    };
+
+    // Lua 端分派函數以 light userdata 取得的游標
+    struct Batch {
+        const std::vector<ScriptEvent>* queue = nullptr;
+        Frame* frame = nullptr;
+        u32 next = 0;
+        u32 end = 0;
+    };
+
+    lua_State* L = nullptr;
+    Game* game = nullptr;
+    Frame frames[kMaxDepth];
+    u32 depth = 0;
+    u16 activeMask = 0;
+    i32 dispatcher = kNoScriptRef;  // Lua 端批次分派函數
+    std::vector<i32> ownedRefs;     // unbind 時釋放
+    std::vector<ArgSlot*> results;  // 查詢結果用的實體參數（每次查詢重用）
+    std::vector<i32> resultRefs;
+    std::vector<ScriptEvent> queues[kHookCount];
+    i32 instances[2] = { kNoScriptRef, kNoScriptRef };  // 植物 / 敵人：句柄 -> 欄位表
+    u32 instanceCount = 0;
+    HookStats stats[kHookCount];
+
+    bool dispatch(Hook hook, const HookSet& hooks, ScriptArg self, ScriptArg other,
+                  const f32* number, f32* result, bool* verdict = nullptr);
+    bool flushQueue(Hook hook);
+    void pushArg(Frame& frame, u32 slot, ScriptArg arg);
+    i32 tableOf(ScriptArg arg) const;
+    HookSet resolve(const char* global, Symbol id);
+    void createFrames();
+    ArgSlot* createArg(i32& ref);
+    ArgSlot* resultArg(u32 n, i32& ref);
+    void createGameObject();
+    void createDispatcher();
+    void createInstances();
+    bool pushInstance(lua_State* state, const ArgSlot& slot, bool create);  // 推入實體的欄位表
+    void dropInstance(ScriptArg::Kind kind, u32 index, u32 generation);
+    static ArgSlot* checkArg(lua_State* L, int index, const char* meta);
+
+    // Lua 端 API（Game 的 friend，直接操作 SoA）
+    static int entityIndex(lua_State* L);
+    static int entityNewIndex(lua_State* L);
+    static int statsIndex(lua_State* L);
+    static int statsNewIndex(lua_State* L);
+    static int entityShoot(lua_State* L);
+    static int entityApplyStatus(lua_State* L);
+    static int entityTakeDamage(lua_State* L);
+    static int entityDestroy(lua_State* L);
+    static int gameAddSun(lua_State* L);
+    static int gameRandom(lua_State* L);
+    static int gameAreaDamage(lua_State* L);
+    static int gameLineDamage(lua_State* L);
+    static int gameConeDamage(lua_State* L);
+    static int gameEnemiesInCone(lua_State* L);
+    static int gameSpawnEnemy(lua_State* L);
+    static int batchNext(lua_State* L);
+    static int noop(lua_State* L);
+};
+
+} // namespace PL
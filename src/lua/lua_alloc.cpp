@@ -0,0 +1,137 @@
+// ============================================
+// Plant Legends - Lua Allocator Implementation
+// ============================================
+
+#include "lua_alloc.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace PL {
+
+namespace {
+
+// 分級大小（16 的倍數，維持 malloc 的對齊）
+constexpr size_t kClassSizes[LuaAllocator::kClassCount] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+// (size + 15) / 16 -> 分級
+constexpr uint8_t kClassBySlot[17] = { 0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7 };
+
+} // namespace
+
+uint32_t LuaAllocator::classOf(size_t size) {
+    if (size > kMaxPooled) return kClassCount;
+    return kClassBySlot[(size + 15) / 16];
+}
+
+size_t LuaAllocator::classSize(uint32_t sizeClass) {
+    return kClassSizes[sizeClass];
+}
+
+void* LuaAllocator::alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+    LuaAllocator* self = static_cast<LuaAllocator*>(ud);
+
+    // ptr 為空時 osize 是物件型別而非大小
+    if (nsize == 0) {
+        if (ptr) self->deallocate(ptr, osize);
+        return nullptr;
+    }
+    if (!ptr) {
+        return self->allocate(nsize);
+    }
+    return self->reallocate(ptr, osize, nsize);
+}
+
+bool LuaAllocator::refill(uint32_t sizeClass) {
+    char* slab = static_cast<char*>(std::malloc(kSlabSize));
+    if (!slab) return false;
+    slabs.push_back(slab);
+    stats.reservedBytes += kSlabSize;
+
+    // 由後往前串起，讓配置順序與位址順序一致
+    const size_t blockSize = kClassSizes[sizeClass];
+    const size_t count = kSlabSize / blockSize;
+    FreeBlock* head = freeLists[sizeClass];
+    for (size_t i = count; i-- > 0; ) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + i * blockSize);
+        block->next = head;
+        head = block;
+    }
+    freeLists[sizeClass] = head;
+    return true;
+}
+
+void* LuaAllocator::allocate(size_t size) {
+    void* ptr;
+    uint32_t c = classOf(size);
+    if (c == kClassCount) {
+        ptr = std::malloc(size);
+        if (!ptr) return nullptr;
+        stats.largeAllocs++;
+    } else {
+        if (!freeLists[c] && !refill(c)) return nullptr;
+        FreeBlock* block = freeLists[c];
+        freeLists[c] = block->next;
+        ptr = block;
+    }
+
+    stats.allocs++;
+    stats.bytes += size;
+    stats.peakBytes = std::max(stats.peakBytes, stats.bytes);
+    return ptr;
+}
+
+void LuaAllocator::deallocate(void* ptr, size_t size) {
+    uint32_t c = classOf(size);
+    if (c == kClassCount) {
+        std::free(ptr);
+    } else {
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next = freeLists[c];
+        freeLists[c] = block;
+    }
+
+    stats.frees++;
+    stats.bytes -= size;
+}
+
+void* LuaAllocator::reallocate(void* ptr, size_t oldSize, size_t newSize) {
+    const uint32_t oldClass = classOf(oldSize);
+    const uint32_t newClass = classOf(newSize);
+
+    // 同一級的區塊已經夠大
+    if (oldClass == newClass && oldClass != kClassCount) {
+        stats.bytes = stats.bytes - oldSize + newSize;
+        stats.peakBytes = std::max(stats.peakBytes, stats.bytes);
+        return ptr;
+    }
+
+    // 兩邊都在池外
+    if (oldClass == kClassCount && newClass == kClassCount) {
+        void* moved = std::realloc(ptr, newSize);
+        if (!moved) return nullptr;
+        stats.bytes = stats.bytes - oldSize + newSize;
+        stats.peakBytes = std::max(stats.peakBytes, stats.bytes);
+        return moved;
+    }
+
+    // 跨級：配置失敗時原區塊保持不變（Lua 要求）
+    void* moved = allocate(newSize);
+    if (!moved) return nullptr;
+    std::memcpy(moved, ptr, std::min(oldSize, newSize));
+    deallocate(ptr, oldSize);
+    return moved;
+}
+
+void LuaAllocator::release() {
+    for (void* slab : slabs) {
+        std::free(slab);
+    }
+    slabs.clear();
+    for (FreeBlock*& head : freeLists) {
+        head = nullptr;
+    }
+    stats = LuaHeapStats();
+}
+
+} // namespace PL
@@ -0,0 +1,67 @@
+// ============================================
+// Plant Legends - Lua 記憶體配置器
+// ============================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PL {
+
+// Lua 堆統計
+struct LuaHeapStats {
+    size_t bytes = 0;           // Lua 目前使用中
+    size_t peakBytes = 0;
+    size_t reservedBytes = 0;   // 池向系統取得的 slab 總量
+    uint64_t allocs = 0;
+    uint64_t frees = 0;
+    uint64_t largeAllocs = 0;   // 超過最大分級，直接交給 malloc
+};
+
+// 分級池配置器（lua_Alloc）
+// Lua 的字串、表、閉包幾乎都是數十位元組的小物件：依大小分成 8 級，
+// 每級從 64KB slab 切出固定大小的區塊，以單向鏈結串列回收。
+// 配置/釋放是 O(1) 的串列操作；同一級內的 realloc 直接原地返回。
+// Lua state 是單執行緒的，不需要鎖。slab 在 release() 時才歸還系統。
+class LuaAllocator {
+public:
+    static constexpr uint32_t kClassCount = 8;
+    static constexpr size_t kMaxPooled = 256;
+    static constexpr size_t kSlabSize = 64 * 1024;
+
+    LuaAllocator() = default;
+    ~LuaAllocator() { release(); }
+    LuaAllocator(const LuaAllocator&) = delete;
+    LuaAllocator& operator=(const LuaAllocator&) = delete;
+
+    // lua_newstate 的配置函數，ud 為 LuaAllocator*
+    static void* alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+    void* allocate(size_t size);
+    void deallocate(void* ptr, size_t size);
+    void* reallocate(void* ptr, size_t oldSize, size_t newSize);
+
+    // 歸還所有 slab（必須在 lua_close 之後）
+    void release();
+
+    const LuaHeapStats& getStats() const { return stats; }
+
+    // 大小所屬的分級，超過 kMaxPooled 回傳 kClassCount
+    static uint32_t classOf(size_t size);
+    static size_t classSize(uint32_t sizeClass);
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    FreeBlock* freeLists[kClassCount] = {};
+    std::vector<void*> slabs;
+    LuaHeapStats stats;
+
+    bool refill(uint32_t sizeClass);
+};
+
+} // namespace PL
@@ -6,20 +6,73 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 
 namespace PL {
 
+namespace {
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+// 原始碼 FNV-1a 64，再混入 Lua 版本與數值型別大小（位元組碼格式依賴這些）
+uint64_t sourceHash(const std::string& source) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](unsigned char byte) {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    };
+    for (unsigned char c : source) mix(c);
+    mix((unsigned char)LUA_VERSION_NUM);
+    mix((unsigned char)sizeof(lua_Integer));
+    mix((unsigned char)sizeof(lua_Number));
+    return hash;
+}
+
+int writeChunk(lua_State*, const void* p, size_t size, void* ud) {
+    static_cast<std::string*>(ud)->append(static_cast<const char*>(p), size);
+    return 0;
+}
+
+// 同 luaL_newstate 設定的 panic 函數
+int panic(lua_State* L) {
+    const char* msg = lua_tostring(L, -1);
+    std::cerr << "[Lua] PANIC: unprotected error: " << (msg ? msg : "?") << std::endl;
+    return 0;
+}
+
+// 每次 LUA_GCSTEP 相當於配置了多少 KB（越大單步越久）
+constexpr int kGcStepKb = 16;
+
+// 強制推進 GC 的門檻：上一輪結束時堆大小的兩倍，至少 4MB
+constexpr size_t kMinGcThreshold = 4u << 20;
+
+} // namespace
+
 LuaManager& LuaManager::instance() {
-    static LuaManager inst;
+    thread_local LuaManager inst;
     return inst;
 }
 
 bool LuaManager::initialize() {
-    L = luaL_newstate();
+    // 小物件走分級池，大區塊交給 malloc
+    L = lua_newstate(LuaAllocator::alloc, &allocator);
     if (!L) {
         lastError = "Failed to create Lua state";
         return false;
     }
+    lua_atpanic(L, panic);
     
     // 載入標準庫
     luaL_openlibs(L);
@@ -32,12 +85,56 @@ void LuaManager::shutdown() {
     if (L) {
         lua_close(L);
         L = nullptr;
+        allocator.release();
+        gcMaxMs = 0.0;
         std::cout << "[Lua] Shutdown" << std::endl;
     }
 }
 
+void LuaManager::setGcBudget(double maxMs) {
+    gcMaxMs = maxMs;
+    if (!L) return;
+    
+    if (maxMs > 0.0) {
+        // 停用自動 GC；LUA_GCSTEP 仍可手動推進
+        lua_gc(L, LUA_GCSTOP, 0);
+        gcThreshold = std::max(allocator.getStats().bytes * 2, kMinGcThreshold);
+    } else {
+        lua_gc(L, LUA_GCRESTART, 0);
+    }
+}
+
+void LuaManager::stepGc(double slackMs) {
+    if (!L || gcMaxMs <= 0.0) return;
+    
+    // 平常只用本幀的空閒時間；堆超過門檻時（長時間沒有空閒）至少用滿上限，避免無限成長
+    double budget = std::min(slackMs, gcMaxMs);
+    if (allocator.getStats().bytes > gcThreshold) {
+        budget = gcMaxMs;
+        gcStats.forced++;
+    }
+    if (budget <= 0.0) return;
+    
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        gcStats.steps++;
+        if (lua_gc(L, LUA_GCSTEP, kGcStepKb)) {
+            // 完成一輪：依存活的堆大小重設門檻，本幀不再開始新的一輪
+            gcStats.cycles++;
+            gcThreshold = std::max(allocator.getStats().bytes * 2, kMinGcThreshold);
+            elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            break;
+        }
+        elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < budget);
+    
+    gcStats.ms += elapsed;
+    gcStats.maxFrameMs = std::max(gcStats.maxFrameMs, elapsed);
+}
+
 bool LuaManager::loadScript(const std::string& path) {
-    if (luaL_dofile(L, path.c_str()) != LUA_OK) {
+    if (!loadChunk(path) || lua_pcall(L, 0, LUA_MULTRET, 0) != LUA_OK) {
         handleError();
         return false;
     }
@@ -45,6 +142,68 @@ bool LuaManager::loadScript(const std::string& path) {
     return true;
 }
 
+bool LuaManager::loadChunk(const std::string& path) {
+    const std::string chunkName = "@" + path;
+    
+    std::string source;
+    if (!readFile(path, source)) {
+        // 只有預編譯位元組碼（Web 打包）
+        std::string compiled = path;
+        if (compiled.size() > 4 && compiled.compare(compiled.size() - 4, 4, ".lua") == 0) {
+            compiled += "c";
+        }
+        std::string bytecode;
+        if (compiled == path || !readFile(compiled, bytecode)) {
+            lua_pushfstring(L, "cannot open %s", path.c_str());
+            return false;
+        }
+        cacheStats.precompiled++;
+        return luaL_loadbufferx(L, bytecode.data(), bytecode.size(), chunkName.c_str(), "b") == LUA_OK;
+    }
+    
+    if (cacheDir.empty()) {
+        return luaL_loadbufferx(L, source.data(), source.size(), chunkName.c_str(), "t") == LUA_OK;
+    }
+    
+    char key[32];
+    std::snprintf(key, sizeof(key), "%016llx.luac", (unsigned long long)sourceHash(source));
+    const std::filesystem::path cachePath = std::filesystem::path(cacheDir) / key;
+    
+    std::string bytecode;
+    if (readFile(cachePath.string(), bytecode)) {
+        if (luaL_loadbufferx(L, bytecode.data(), bytecode.size(), chunkName.c_str(), "b") == LUA_OK) {
+            cacheStats.hits++;
+            return true;
+        }
+        lua_pop(L, 1);  // 快取檔損毀，改從原始碼編譯
+    }
+    
+    cacheStats.misses++;
+    if (luaL_loadbufferx(L, source.data(), source.size(), chunkName.c_str(), "t") != LUA_OK) {
+        return false;
+    }
+    
+    // 保留除錯資訊，錯誤訊息仍有行號。先寫暫存檔再改名，避免讀到寫一半的檔案
+    bytecode.clear();
+    if (dumpChunk(L, bytecode, false)) {
+        std::error_code ec;
+        std::filesystem::create_directories(cacheDir, ec);
+        std::filesystem::path tmp = cachePath;
+        tmp += ".tmp";
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (file && file.write(bytecode.data(), (std::streamsize)bytecode.size())) {
+            file.close();
+            std::filesystem::rename(tmp, cachePath, ec);
+            if (!ec) cacheStats.writes++;
+        }
+    }
+    return true;
+}
+
+bool LuaManager::dumpChunk(lua_State* L, std::string& out, bool strip) {
+    return lua_dump(L, writeChunk, &out, strip ? 1 : 0) == 0;
+}
+
 bool LuaManager::executeString(const std::string& code) {
     if (luaL_dostring(L, code.c_str()) != LUA_OK) {
         handleError();
@@ -58,6 +217,54 @@ void LuaManager::registerFunction(const std::string& name, lua_CFunction func) {
     std::cout << "[Lua] Registered function: " << name << std::endl;
 }
 
+LuaFunction LuaManager::findFunction(const char* name) {
+    LuaFunction fn;
+    if (lua_getglobal(L, name) == LUA_TFUNCTION) {
+        fn.ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    } else {
+        lua_pop(L, 1);
+    }
+    return fn;
+}
+
+void LuaManager::releaseFunction(LuaFunction& fn) {
+    if (L && fn.isValid()) {
+        luaL_unref(L, LUA_REGISTRYINDEX, fn.ref);
+    }
+    fn.ref = LUA_NOREF;
+}
+
+void LuaManager::failCall(LuaCallStatus status) {
+    callStatus = status;
+    callStats.errors++;
+    
+    switch (status) {
+        case LuaCallStatus::RuntimeError: {
+            // 錯誤物件在棧頂：只複製進固定緩衝區，不經過 std::string
+            size_t len = 0;
+            const char* msg = lua_type(L, -1) == LUA_TSTRING ? lua_tolstring(L, -1, &len) : nullptr;
+            if (msg) {
+                len = std::min(len, kCallErrorSize - 1);
+                std::memcpy(callError, msg, len);
+                callError[len] = '\0';
+            } else {
+                std::snprintf(callError, kCallErrorSize, "%s", "error object is not a string");
+            }
+            lua_pop(L, 1);
+            break;
+        }
+        case LuaCallStatus::NotFound:
+            std::snprintf(callError, kCallErrorSize, "%s", "function not found");
+            break;
+        case LuaCallStatus::BadResult:
+            std::snprintf(callError, kCallErrorSize, "%s", "unexpected result type");
+            break;
+        case LuaCallStatus::Ok:
+            callError[0] = '\0';
+            break;
+    }
+}
+
 bool LuaManager::loadConfig(const std::string& path) {
     if (!loadScript(path)) {
         return false;
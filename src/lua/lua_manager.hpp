@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "lua/lua_alloc.hpp"
+#include "lua/lua_value.hpp"
 #include <string>
 #include <memory>
 #include <unordered_map>
@@ -18,31 +20,90 @@ extern "C" {
 
 namespace PL {
 
+// 位元組碼快取統計
+struct BytecodeCacheStats {
+    unsigned hits = 0;        // 雜湊相符，直接載入位元組碼
+    unsigned misses = 0;      // 重新編譯原始碼
+    unsigned writes = 0;      // 寫入快取檔
+    unsigned precompiled = 0; // 找不到原始碼時載入預編譯的 .luac
+};
+
+// 增量 GC 統計
+struct LuaGcStats {
+    uint64_t steps = 0;       // LUA_GCSTEP 次數
+    uint64_t cycles = 0;      // 完成的回收輪數
+    uint64_t forced = 0;      // 堆超過門檻、沒有空閒也照樣推進的幀
+    double ms = 0.0;          // 累計 GC 時間
+    double maxFrameMs = 0.0;  // 單幀最長 GC 時間
+};
+
+// 預先解析的 Lua 函數（registry 引用），呼叫時不再以名稱查表
+struct LuaFunction {
+    int ref = LUA_NOREF;
+    bool isValid() const { return ref != LUA_NOREF && ref != LUA_REFNIL; }
+};
+
+// 最近一次 callFunction 的結果
+enum class LuaCallStatus : uint8_t {
+    Ok,
+    NotFound,       // 無效引用或全域不是函數
+    RuntimeError,   // lua_pcall 失敗，訊息在 getCallError()
+    BadResult       // 回傳值型別不符
+};
+
+struct LuaCallStats {
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+};
+
 class LuaManager {
 public:
+    // 每個執行緒一個 Lua 狀態：平行模擬的工作執行緒各自載入腳本，互不共享。
+    // 依附 Lua 狀態的單例（ScriptHooks、ArchetypeRegistry、LevelLoader）同樣以執行緒區分。
     static LuaManager& instance();
     
     // 初始化 Lua 環境
     bool initialize();
     void shutdown();
     
-    // 執行腳本
+    // 執行腳本（回傳值留在棧上，同 luaL_dofile）
+    // 啟用快取時以原始碼雜湊為鍵，相符就從記憶體 lua_load 位元組碼；
+    // 原始碼不存在時改載入同名的預編譯 .luac（Web 版只打包位元組碼）
     bool loadScript(const std::string& path);
+    
+    // 位元組碼快取目錄（空字串關閉）
+    void setBytecodeCache(const std::string& dir) { cacheDir = dir; }
+    const BytecodeCacheStats& getCacheStats() const { return cacheStats; }
+    
+    // 將已載入棧頂的函數寫成位元組碼（strip 去掉除錯資訊）
+    static bool dumpChunk(lua_State* L, std::string& out, bool strip);
     bool executeString(const std::string& code);
     
     // 取得 Lua state
     lua_State* getState() { return L; }
     
+    // Lua 堆（分級池配置器）
+    const LuaHeapStats& getHeapStats() const { return allocator.getStats(); }
+    
+    // 每幀 GC 上限（毫秒）；> 0 時停用 Lua 自動 GC，改由 stepGc 推進，<= 0 交回自動 GC
+    void setGcBudget(double maxMs);
+    double getGcBudget() const { return gcMaxMs; }
+    
+    // 在幀的空閒時間內推進增量 GC（slackMs = 目標幀時間 - 本幀已用時間）
+    void stepGc(double slackMs);
+    const LuaGcStats& getGcStats() const { return gcStats; }
+    
     // 註冊 C++ 函數給 Lua 調用
     void registerFunction(const std::string& name, lua_CFunction func);
     
-    // 從 Lua 取得數值
+    // 從 Lua 取得數值（型別不符時回傳 T()）
+    // 字串用 std::string_view 不配置記憶體；std::string 會複製
     template<typename T>
-    T getGlobal(const std::string& name);
+    T getGlobal(const char* name);
     
     // 設定 Lua 全局變數
     template<typename T>
-    void setGlobal(const std::string& name, T value);
+    void setGlobal(const char* name, const T& value);
     
     // 讀取配置檔
     bool loadConfig(const std::string& path);
@@ -56,9 +117,23 @@ public:
     // 讀取關卡定義
     bool loadLevels(const std::string& path);
     
-    // 呼叫 Lua 函數
-    template<typename R, typename... Args>
-    R callFunction(const std::string& name, Args... args);
+    // 解析全域函數為 registry 引用（不是函數時回傳無效引用）
+    LuaFunction findFunction(const char* name);
+    void releaseFunction(LuaFunction& fn);
+    
+    // 呼叫 Lua 函數：參數與回傳值依型別在編譯期決定 push / get（見 LuaValue），
+    // 不經過 std::string、容器或變長參數。失敗時回傳 R()，狀態與訊息另外查詢；
+    // 錯誤路徑只把訊息複製進固定緩衝區，不配置記憶體。
+    // 名稱版本每次呼叫都要查全域表，熱路徑用 LuaFunction 版本。
+    // 回傳值出棧後就可能被回收，字串結果必須用 std::string。
+    template<typename R = void, typename... Args>
+    R callFunction(const LuaFunction& fn, Args... args);
+    template<typename R = void, typename... Args>
+    R callFunction(const char* name, Args... args);
+    
+    LuaCallStatus getCallStatus() const { return callStatus; }
+    const char* getCallError() const { return callError; }
+    const LuaCallStats& getCallStats() const { return callStats; }
     
     // 錯誤處理
     std::string getLastError() const { return lastError; }
@@ -68,9 +143,28 @@ private:
     ~LuaManager() { shutdown(); }
     
     lua_State* L;
+    LuaAllocator allocator;
     std::string lastError;
+    std::string cacheDir;
+    BytecodeCacheStats cacheStats;
+    
+    // 增量 GC
+    double gcMaxMs = 0.0;
+    size_t gcThreshold = 0;   // 堆超過此值時即使沒有空閒也推進 GC
+    LuaGcStats gcStats;
+    
+    // callFunction
+    static constexpr size_t kCallErrorSize = 256;
+    LuaCallStatus callStatus = LuaCallStatus::Ok;
+    LuaCallStats callStats;
+    char callError[kCallErrorSize] = {};
+    
+    template<typename R, typename... Args>
+    R invoke(Args... args);
+    void failCall(LuaCallStatus status);
     
     // 輔助函數
+    bool loadChunk(const std::string& path);
     void handleError();
     void dumpStack();
 };
@@ -79,46 +173,79 @@ private:
 // Template implementations
 // ============================================
 
-template<>
-inline int LuaManager::getGlobal<int>(const std::string& name) {
-    lua_getglobal(L, name.c_str());
-    int value = static_cast<int>(lua_tointeger(L, -1));
+template<typename T>
+T LuaManager::getGlobal(const char* name) {
+    static_assert(LuaValue<T>::kSlots == 1, "globals hold a single value");
+    lua_getglobal(L, name);
+    T value = LuaValue<T>::check(L, -1) ? LuaValue<T>::get(L, -1) : T();
     lua_pop(L, 1);
     return value;
 }
 
-template<>
-inline float LuaManager::getGlobal<float>(const std::string& name) {
-    lua_getglobal(L, name.c_str());
-    float value = static_cast<float>(lua_tonumber(L, -1));
-    lua_pop(L, 1);
-    return value;
+template<typename T>
+void LuaManager::setGlobal(const char* name, const T& value) {
+    static_assert(LuaValue<T>::kSlots == 1, "globals hold a single value");
+    LuaValue<T>::push(L, value);
+    lua_setglobal(L, name);
 }
 
-template<>
-inline std::string LuaManager::getGlobal<std::string>(const std::string& name) {
-    lua_getglobal(L, name.c_str());
-    std::string value = lua_tostring(L, -1);
-    lua_pop(L, 1);
-    return value;
-}
-
-template<>
-inline void LuaManager::setGlobal<int>(const std::string& name, int value) {
-    lua_pushinteger(L, value);
-    lua_setglobal(L, name.c_str());
+template<typename R, typename... Args>
+R LuaManager::callFunction(const LuaFunction& fn, Args... args) {
+    if (!fn.isValid()) {
+        failCall(LuaCallStatus::NotFound);
+        return R();
+    }
+    lua_rawgeti(L, LUA_REGISTRYINDEX, fn.ref);
+    return invoke<R>(args...);
 }
 
-template<>
-inline void LuaManager::setGlobal<float>(const std::string& name, float value) {
-    lua_pushnumber(L, value);
-    lua_setglobal(L, name.c_str());
+template<typename R, typename... Args>
+R LuaManager::callFunction(const char* name, Args... args) {
+    if (lua_getglobal(L, name) != LUA_TFUNCTION) {
+        lua_pop(L, 1);
+        failCall(LuaCallStatus::NotFound);
+        return R();
+    }
+    return invoke<R>(args...);
 }
 
-template<>
-inline void LuaManager::setGlobal<std::string>(const std::string& name, std::string value) {
-    lua_pushstring(L, value.c_str());
-    lua_setglobal(L, name.c_str());
+// 函數已在棧頂
+template<typename R, typename... Args>
+R LuaManager::invoke(Args... args) {
+    static_assert(!std::is_same_v<R, std::string_view> && !std::is_same_v<R, const char*>,
+                  "results are popped before returning; use std::string");
+    constexpr int nargs = luaSlots<Args...>();
+    constexpr int nresults = luaSlots<R>();
+    
+    // 空間足夠時只是比較，不會配置
+    if (!lua_checkstack(L, nargs + nresults)) {
+        lua_pop(L, 1);
+        lua_pushliteral(L, "stack overflow");
+        failCall(LuaCallStatus::RuntimeError);
+        return R();
+    }
+    (LuaValue<std::decay_t<Args>>::push(L, args), ...);
+    
+    callStats.calls++;
+    if (lua_pcall(L, nargs, nresults, 0) != LUA_OK) {
+        failCall(LuaCallStatus::RuntimeError);
+        return R();
+    }
+    
+    if constexpr (std::is_void_v<R>) {
+        callStatus = LuaCallStatus::Ok;
+    } else {
+        const int first = lua_gettop(L) - nresults + 1;
+        if (!LuaValue<R>::check(L, first)) {
+            lua_pop(L, nresults);
+            failCall(LuaCallStatus::BadResult);
+            return R();
+        }
+        R value = LuaValue<R>::get(L, first);
+        lua_pop(L, nresults);
+        callStatus = LuaCallStatus::Ok;
+        return value;
+    }
 }
 
 } // namespace PL
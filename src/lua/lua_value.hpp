@@ -0,0 +1,131 @@
+// ============================================
+// Plant Legends - Lua 值的型別對應
+// ============================================
+
+#pragma once
+
+#include "core/types.hpp"
+#include "core/handle.hpp"
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+extern "C" {
+#include <lua.h>
+}
+
+namespace PL {
+
+// C++ 型別 <-> Lua 棧的對應，編譯期依型別選擇 push / get，不經過字串或容器。
+//   kSlots            佔用的棧位數（Vec2 以 x, y 兩個數字傳遞）
+//   push(L, v)        推入棧頂
+//   check(L, idx)     idx 起的值可轉成 T（不會就地轉換字串）
+//   get(L, idx)       讀取（呼叫前先 check）
+// 沒有特化的型別在編譯期報錯。
+template<typename T, typename Enable = void>
+struct LuaValue;
+
+template<>
+struct LuaValue<bool> {
+    static constexpr int kSlots = 1;
+    static void push(lua_State* L, bool v) { lua_pushboolean(L, v ? 1 : 0); }
+    static bool check(lua_State*, int) { return true; }  // Lua 的任何值都有真假
+    static bool get(lua_State* L, int idx) { return lua_toboolean(L, idx) != 0; }
+};
+
+template<typename T>
+struct LuaValue<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    static constexpr int kSlots = 1;
+    static void push(lua_State* L, T v) { lua_pushinteger(L, (lua_Integer)v); }
+    static bool check(lua_State* L, int idx) { return lua_type(L, idx) == LUA_TNUMBER; }
+    static T get(lua_State* L, int idx) {
+        return lua_isinteger(L, idx) ? (T)lua_tointeger(L, idx) : (T)lua_tonumber(L, idx);
+    }
+};
+
+template<typename T>
+struct LuaValue<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static constexpr int kSlots = 1;
+    static void push(lua_State* L, T v) { lua_pushnumber(L, (lua_Number)v); }
+    static bool check(lua_State* L, int idx) { return lua_type(L, idx) == LUA_TNUMBER; }
+    static T get(lua_State* L, int idx) { return (T)lua_tonumber(L, idx); }
+};
+
+template<>
+struct LuaValue<Vec2> {
+    static constexpr int kSlots = 2;
+    static void push(lua_State* L, const Vec2& v) {
+        lua_pushnumber(L, v.x);
+        lua_pushnumber(L, v.y);
+    }
+    static bool check(lua_State* L, int idx) {
+        return lua_type(L, idx) == LUA_TNUMBER && lua_type(L, idx + 1) == LUA_TNUMBER;
+    }
+    static Vec2 get(lua_State* L, int idx) { return Vec2((f32)lua_tonumber(L, idx), (f32)lua_tonumber(L, idx + 1)); }
+};
+
+// 句柄打包成一個整數（世代 << 32 | 槽位），空句柄為 nil
+template<typename T>
+struct LuaValue<Handle<T>> {
+    static constexpr int kSlots = 1;
+    static void push(lua_State* L, Handle<T> h) {
+        if (h.isNull()) {
+            lua_pushnil(L);
+        } else {
+            lua_pushinteger(L, (lua_Integer)(((u64)h.generation << 32) | h.index));
+        }
+    }
+    static bool check(lua_State* L, int idx) { return lua_isnil(L, idx) || lua_isinteger(L, idx); }
+    static Handle<T> get(lua_State* L, int idx) {
+        if (lua_isnil(L, idx)) return Handle<T>();
+        const u64 packed = (u64)lua_tointeger(L, idx);
+        return Handle<T>((u32)packed, (u32)(packed >> 32));
+    }
+};
+
+// 讀出的 string_view 指向 Lua 字串，只在該字串仍被 Lua 引用時有效
+// （全域變數、表中的值、常數）；需要保留時自行複製。
+template<>
+struct LuaValue<std::string_view> {
+    static constexpr int kSlots = 1;
+    static void push(lua_State* L, std::string_view v) { lua_pushlstring(L, v.data(), v.size()); }
+    static bool check(lua_State* L, int idx) { return lua_type(L, idx) == LUA_TSTRING; }
+    static std::string_view get(lua_State* L, int idx) {
+        size_t len = 0;
+        const char* s = lua_tolstring(L, idx, &len);
+        return std::string_view(s, len);
+    }
+};
+
+template<>
+struct LuaValue<const char*> {
+    static constexpr int kSlots = 1;
+    static void push(lua_State* L, const char* v) { lua_pushstring(L, v); }
+    static bool check(lua_State* L, int idx) { return lua_type(L, idx) == LUA_TSTRING; }
+    static const char* get(lua_State* L, int idx) { return lua_tostring(L, idx); }
+};
+
+// 需要擁有權時才用；讀取會配置記憶體
+template<>
+struct LuaValue<std::string> {
+    static constexpr int kSlots = 1;
+    static void push(lua_State* L, const std::string& v) { lua_pushlstring(L, v.data(), v.size()); }
+    static bool check(lua_State* L, int idx) { return lua_type(L, idx) == LUA_TSTRING; }
+    static std::string get(lua_State* L, int idx) {
+        size_t len = 0;
+        const char* s = lua_tolstring(L, idx, &len);
+        return std::string(s, len);
+    }
+};
+
+// 無回傳值
+template<>
+struct LuaValue<void> {
+    static constexpr int kSlots = 0;
+};
+
+// 參數串（或回傳值）的總棧位數
+template<typename... Args>
+constexpr int luaSlots() { return (0 + ... + LuaValue<std::decay_t<Args>>::kSlots); }
+
+} // namespace PL
@@ -5,9 +5,15 @@
 #include "sf3.hpp"
 #include "lua/lua_manager.hpp"
 #include "game/game.hpp"
+#include "game/data_pack.hpp"
+#include "game/level_loader.hpp"
+#include "game/script_hooks.hpp"
+#include "game/hot_reload.hpp"
 #include "systems/renderer.hpp"
 #include "ui/ui_system.hpp"
+#include "core/log.hpp"
 #include <iostream>
+#include <chrono>
 
 // 使用 SF3 的類型
 using SF3::App;
@@ -26,6 +32,9 @@ int main() {
     std::cout << "  Build: " << __DATE__ << " " << __TIME__ << std::endl;
     std::cout << "========================================" << std::endl;
     
+    // 啟動日誌排空執行緒
+    Logger::instance().start();
+    
     // 初始化 SF3 引擎
     auto& app = App::instance();
     Config config;
@@ -46,18 +55,32 @@ int main() {
         return 1;
     }
     
+    // 桌面版快取腳本位元組碼（Web 版直接打包預編譯的 .luac）
+#ifndef __EMSCRIPTEN__
+    lua.setBytecodeCache(".luacache");
+#endif
+    
     // 載入遊戲資料
     std::cout << "\n[Loading] Game data..." << std::endl;
     
     bool loadSuccess = true;
     
-    if (!lua.loadScript("scripts/config.lua")) {
-        std::cerr << "[Error] Failed to load config: " << lua.getLastError() << std::endl;
-        loadSuccess = false;
+    // 烘焙好的資料包：設定、原型與關卡直接 mmap，不再解析腳本
+    DataPack& pack = DataPack::instance();
+    if (pack.open("data/game.pack")) {
+        std::cout << "[OK] data/game.pack" << std::endl;
     } else {
-        std::cout << "[OK] config.lua" << std::endl;
+        std::cout << "[Info] No valid data pack, loading data from Lua scripts" << std::endl;
+        
+        if (!lua.loadScript("scripts/config.lua")) {
+            std::cerr << "[Error] Failed to load config: " << lua.getLastError() << std::endl;
+            loadSuccess = false;
+        } else {
+            std::cout << "[OK] config.lua" << std::endl;
+        }
     }
     
+    // 植物/敵人腳本仍需載入以提供 Lua 回呼
     if (!lua.loadScript("scripts/plants/all_plants.lua")) {
         std::cerr << "[Error] Failed to load plants: " << lua.getLastError() << std::endl;
         loadSuccess = false;
@@ -72,11 +95,16 @@ int main() {
         std::cout << "[OK] all_enemies.lua" << std::endl;
     }
     
-    if (!lua.loadScript("scripts/levels/all_levels.lua")) {
-        std::cerr << "[Error] Failed to load levels: " << lua.getLastError() << std::endl;
-        loadSuccess = false;
-    } else {
-        std::cout << "[OK] all_levels.lua" << std::endl;
+    // 沒有資料包時建立關卡索引，進關時才讀取單一關卡；索引不到才整檔載入
+    if (!pack.isOpen()) {
+        if (LevelLoader::instance().getIndex().addDirectory("scripts/levels") > 0) {
+            std::cout << "[OK] Level index: " << LevelLoader::instance().getIndex().size() << " levels" << std::endl;
+        } else if (!lua.loadScript("scripts/levels/all_levels.lua")) {
+            std::cerr << "[Error] Failed to load levels: " << lua.getLastError() << std::endl;
+            loadSuccess = false;
+        } else {
+            std::cout << "[OK] all_levels.lua" << std::endl;
+        }
     }
     
     if (!loadSuccess) {
@@ -86,6 +114,16 @@ int main() {
         std::cout << "[Success] All game data loaded!\n" << std::endl;
     }
     
+    // 建立植物/敵人原型表（之後生成不再讀 Lua）
+    if (pack.isOpen()) {
+        ArchetypeRegistry::instance().build(pack);
+    } else {
+        ArchetypeRegistry::instance().build(lua.getState());
+    }
+    
+    // 回呼解析成 registry 引用存進原型（資料包模式下腳本同樣已載入）
+    ScriptHooks::instance().bind(lua.getState());
+    
     // 初始化遊戲
     Game& game = getGame();
     if (!game.initialize()) {
@@ -107,11 +145,25 @@ int main() {
         return 1;
     }
     
+#ifndef __EMSCRIPTEN__
+    // 每局錄成重播檔：回報問題時附上 last.replay，可用 plant-legends-sim --replay 重現
+    Replay replay;
+    game.setRecorder(&replay);
+#endif
+    
     // 載入並開始第一關
     if (game.loadLevel("1-1")) {
         game.startLevel();
     }
     
+#ifndef __EMSCRIPTEN__
+    // 開發模式：改存腳本後就地更新原型與場上實體
+    HotReload hotReload;
+    if (!pack.isOpen()) {
+        hotReload.watch("scripts");
+    }
+#endif
+    
     // 放置一些測試植物
     std::cout << "\n[Game] Placing test plants..." << std::endl;
     game.placePlant("pea_sprite", GridCoord(0, 2));
@@ -125,13 +177,21 @@ int main() {
     std::cout << "  Press ESC to quit" << std::endl;
     std::cout << "========================================\n" << std::endl;
     
+    // 目標幀時間（vsync 60Hz），剩餘的空閒時間拿來推進 Lua GC
+    constexpr double kFrameMs = 1000.0 / 60.0;
+    
     // 主遊戲循環
     while (app.running()) {
+        auto frameStart = std::chrono::steady_clock::now();
         app.pollEvents();
         float dt = app.deltaTime();
         
-        // 更新遊戲
-        game.update(dt);
+#ifndef __EMSCRIPTEN__
+        hotReload.update(game);
+#endif
+        
+        // 更新遊戲：固定步長，與幀率無關
+        game.advance(dt);
         uiManager.update(dt, game);
         
         // 處理輸入
@@ -142,7 +202,7 @@ int main() {
         Graphics::clear(SF3::Color(50, 120, 80));  // 綠色背景
         
         // 使用渲染器
-        renderer.render(game);
+        renderer.render(game, dt);
         
         // 渲染 UI（在最上層）
         uiManager.render(game);
@@ -152,12 +212,33 @@ int main() {
             break;
         }
         
+        double frameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+        lua.stepGc(kFrameMs - frameMs);
+        
         Graphics::endFrame();
+        
+#ifndef PL_LOG_THREADED
+        Logger::instance().flush();
+#endif
     }
     
     // 清理
+#ifndef __EMSCRIPTEN__
+    game.setRecorder(nullptr);
+    if (replay.save("last.replay")) {
+        PL_LOG_INFO(Game, "Session recorded to last.replay (%zu inputs)", replay.events.size());
+    }
+#endif
     game.shutdown();
+    ScriptHooks::instance().unbind();
+    
+    const LuaGcStats& gc = lua.getGcStats();
+    PL_LOG_INFO(Lua, "GC: %llu cycles, %.2f ms total, %.3f ms worst frame, %llu forced; heap peak %zu KB",
+                (unsigned long long)gc.cycles, gc.ms, gc.maxFrameMs, (unsigned long long)gc.forced,
+                lua.getHeapStats().peakBytes / 1024);
     lua.shutdown();
+    pack.close();
+    Logger::instance().stop();
     
     std::cout << "\n[Shutdown] Goodbye!" << std::endl;
     return 0;
@@ -3,7 +3,6 @@
 // ============================================
 
 #include "systems/renderer.hpp"
-#include "game/projectile.hpp"
 #include <iostream>
 
 namespace PL {
@@ -16,8 +15,9 @@ bool Renderer::initialize() {
     return true;
 }
 
-void Renderer::render(const Game& game) {
-    time += 0.016f;  // ~60 FPS
+void Renderer::render(const Game& game, f32 frameDt) {
+    time += frameDt;
+    alpha = game.getInterpolationAlpha();
     
     renderGrid(game);
     renderPlants(game);
@@ -30,8 +30,10 @@ void Renderer::render(const Game& game) {
 void Renderer::renderGrid(const Game& game) {
     using namespace SF3;
     
-    for (i32 row = 0; row < 5; row++) {
-        for (i32 col = 0; col < 9; col++) {
+    const GridConfig& grid = game.getGridConfig();
+    
+    for (i32 row = 0; row < grid.rows; row++) {
+        for (i32 col = 0; col < grid.cols; col++) {
             Vec2 pos = game.gridToWorld(GridCoord(col, row));
             
             // 交替顏色
@@ -51,17 +53,16 @@ void Renderer::renderPlants(const Game& game) {
     
     const auto& plants = game.getPlants();
     
-    for (const auto& plant : plants) {
-        if (!plant->isAlive()) continue;
+    for (u32 i = 0; i < plants.size(); i++) {
+        if (!plants.alive[i]) continue;
         
-        Vec2 pos = plant->getPosition();
-        const auto& stats = plant->getStats();
+        Vec2 pos = plants.position(i);
         
         // 計算動畫偏移（呼吸效果）
         f32 bounce = std::sin(time * 2.0f + pos.x * 0.02f) * 1.0f;
         
         // 植物主體顏色根據稀有度
-        Color plantColor = getRarityColor(plant->getRarity());
+        Color plantColor = getRarityColor(plants.objects[i].getRarity());
         
         // 植物主體
         Rect plantRect(pos.x - 25, pos.y - 25 + bounce, 50, 50);
@@ -76,7 +77,7 @@ void Renderer::renderPlants(const Game& game) {
         Graphics::drawRectOutline(plantRect, borderColor);
         
         // 元素效果
-        switch (plant->getElement()) {
+        switch (plants.element[i]) {
             case Element::Fire:
                 // 火焰光暈
                 Graphics::drawCircle(pos.x, pos.y, 30, Color(255, 100, 50, 100));
@@ -102,7 +103,7 @@ void Renderer::renderPlants(const Game& game) {
         Graphics::drawRect(hpBarBg, Color(100, 100, 100));
         
         // 血條
-        f32 hpPercent = stats.hp / stats.maxHp;
+        f32 hpPercent = plants.hp[i] / plants.maxHp[i];
         Rect hpBar(pos.x - 25, pos.y + 30, 50 * hpPercent, 4);
         Graphics::drawRect(hpBar, getHealthColor(hpPercent));
     }
@@ -113,11 +114,10 @@ void Renderer::renderEnemies(const Game& game) {
     
     const auto& enemies = game.getEnemies();
     
-    for (const auto& enemy : enemies) {
-        if (!enemy->isAlive()) continue;
+    for (u32 i = 0; i < enemies.size(); i++) {
+        if (!enemies.alive[i]) continue;
         
-        Vec2 pos = enemy->getPosition();
-        const auto& stats = enemy->getStats();
+        Vec2 pos = enemies.interpolated(i, alpha);
         
         // 計算動畫偏移（呼吸效果）
         f32 bounce = std::sin(time * 3.0f + pos.x * 0.01f) * 2.0f;
@@ -127,7 +127,7 @@ void Renderer::renderEnemies(const Game& game) {
         
         // 根據行為類型選擇顏色
         Color enemyColor;
-        switch (enemy->getBehavior()) {
+        switch (enemies.behavior[i]) {
             case Enemy::Behavior::Flyer:
                 enemyColor = Color(150, 100, 200);  // 紫色
                 break;
@@ -151,17 +151,18 @@ void Renderer::renderEnemies(const Game& game) {
         Graphics::drawRect(hpBarBg, Color(100, 100, 100));
         
         // 血條
-        f32 hpPercent = stats.hp / stats.maxHp;
+        f32 hpPercent = enemies.hp[i] / enemies.maxHp[i];
         Rect hpBar(pos.x - 20, pos.y - 30, 40 * hpPercent, 5);
         Graphics::drawRect(hpBar, getHealthColor(hpPercent));
         
         // 狀態效果指示器
-        if (enemy->isSlowed()) {
+        const StatusSet& status = enemies.status[i];
+        if (status.has(StatusType::Slow)) {
             // 藍色光環
             Graphics::drawCircle(pos.x, pos.y, 25, Color(100, 150, 255, 100));
         }
         
-        if (enemy->isFrozen()) {
+        if (status.has(StatusType::Freeze)) {
             // 白色冰凍效果
             Graphics::drawRect(Rect(pos.x - 22, pos.y - 22, 44, 44), Color(200, 220, 255, 150));
         }
@@ -172,17 +173,18 @@ void Renderer::renderProjectiles(const Game& game) {
     using namespace SF3;
     
     const auto& projectiles = game.getProjectiles();
+    const auto& enemies = game.getEnemies();
     
-    for (const auto& proj : projectiles) {
-        if (!proj->isAlive()) continue;
+    for (u32 i = 0; i < projectiles.size(); i++) {
+        if (!projectiles.alive[i]) continue;
         
-        Vec2 pos = proj->getPosition();
-        auto target = proj->getTarget();
+        Vec2 pos = projectiles.interpolated(i, alpha);
         
         // 計算投射物方向
         f32 angle = 0.0f;
-        if (target && target->isAlive()) {
-            Vec2 dir = (target->getPosition() - pos).normalized();
+        u32 t = enemies.resolve(projectiles.target[i]);
+        if (t != kInvalidIndex && enemies.alive[t]) {
+            Vec2 dir = (enemies.interpolated(t, alpha) - pos).normalized();
             angle = std::atan2(dir.y, dir.x);
         }
         
@@ -192,9 +194,9 @@ void Renderer::renderProjectiles(const Game& game) {
         
         // 尾跡效果
         for (int i = 1; i <= 3; i++) {
-            f32 alpha = 255 - (i * 60);
+            f32 trailAlpha = 255 - (i * 60);
             Rect trail(pos.x - 8 - i * 5, pos.y - 3, 10, 6);
-            Graphics::drawRect(trail, Color(100, 255, 100, alpha));
+            Graphics::drawRect(trail, Color(100, 255, 100, trailAlpha));
         }
     }
 }
@@ -19,8 +19,9 @@ public:
     // 初始化
     bool initialize();
     
-    // 渲染
-    void render(const Game& game);
+    // 渲染（frameDt 為實際幀時間，只推進動畫；移動中的實體依
+    // game.getInterpolationAlpha() 在前後兩個 tick 之間插值）
+    void render(const Game& game, f32 frameDt);
     
 private:
     void renderGrid(const Game& game);
@@ -36,6 +37,7 @@ private:
     
     // 動畫
     f32 time = 0.0f;
+    f32 alpha = 1.0f;   // 本幀的插值係數
 };
 
 } // namespace PL
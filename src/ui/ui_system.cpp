@@ -3,15 +3,9 @@
 // ============================================
 
 #include "ui/ui_system.hpp"
-#include "lua/lua_manager.hpp"
+#include "game/archetype.hpp"
 #include <iostream>
 
-extern "C" {
-#include <lua.h>
-#include <lualib.h>
-#include <lauxlib.h>
-}
-
 namespace PL {
 
 // ============================================
@@ -61,50 +55,20 @@ void Button::render() {
 
 PlantCard::PlantCard(const SF3::Rect& bounds, const std::string& plantId)
     : UIElement(bounds)
-    , plantId(plantId)
+    , plantId(intern(plantId))
 {
-    // 從 Lua 載入植物數據
-    LuaManager& lua = LuaManager::instance();
-    lua_State* L = lua.getState();
-    
-    lua_getglobal(L, "plants");
-    if (!lua_istable(L, -1)) {
-        lua_pop(L, 1);
-        return;
-    }
-    
-    lua_getfield(L, -1, plantId.c_str());
-    if (!lua_istable(L, -1)) {
-        lua_pop(L, 2);
+    // 從原型表取得植物數據
+    ArchetypeRegistry& registry = ArchetypeRegistry::instance();
+    archetype = registry.findPlant(this->plantId);
+    if (archetype == kInvalidArchetype) {
         return;
     }
     
-    // 讀取名稱
-    lua_getfield(L, -1, "name");
-    if (lua_isstring(L, -1)) {
-        name = lua_tostring(L, -1);
-    }
-    lua_pop(L, 1);
-    
-    // 讀取成本
-    lua_getfield(L, -1, "cost");
-    if (lua_isnumber(L, -1)) {
-        cost = (i32)lua_tointeger(L, -1);
-    }
-    lua_pop(L, 1);
-    
-    // 讀取稀有度
-    lua_getfield(L, -1, "rarity");
-    if (lua_isstring(L, -1)) {
-        std::string rarityStr = lua_tostring(L, -1);
-        if (rarityStr == "common") rarity = Rarity::Common;
-        else if (rarityStr == "rare") rarity = Rarity::Rare;
-        else if (rarityStr == "epic") rarity = Rarity::Epic;
-        else if (rarityStr == "legendary") rarity = Rarity::Legendary;
-    }
-    lua_pop(L, 1);
-    
-    lua_pop(L, 2);  // pop plant and plants
+    const PlantArchetype& data = registry.plant(archetype);
+    name = data.name;
+    cost = data.cost;
+    rarity = data.rarity;
+    maxCooldown = data.cooldown;
 }
 
 void PlantCard::update(f32 dt) {
@@ -244,7 +208,7 @@ void UIManager::onMouseClick(const Vec2& pos) {
     for (auto& card : plantCards) {
         if (card.contains(pos)) {
             selectPlant(card.getPlantId());
-            std::cout << "[UI] Selected plant: " << card.getPlantId() << std::endl;
+            std::cout << "[UI] Selected plant: " << symbolName(card.getPlantId()) << std::endl;
             return;
         }
     }
@@ -253,7 +217,7 @@ void UIManager::onMouseClick(const Vec2& pos) {
     deselectPlant();
 }
 
-void UIManager::selectPlant(const std::string& plantId) {
+void UIManager::selectPlant(Symbol plantId) {
     selectedPlant = plantId;
 }
 
@@ -297,7 +261,7 @@ void UIManager::renderPlantCards(const Game& game) {
     }
     
     // 繪製選中的卡片高亮
-    if (!selectedPlant.empty()) {
+    if (selectedPlant != kNoSymbol) {
         for (const auto& card : plantCards) {
             if (card.getPlantId() == selectedPlant) {
                 SF3::Rect highlight = card.getBounds();
@@ -55,12 +55,14 @@ public:
     void update(f32 dt) override;
     void render() override;
     
-    const std::string& getPlantId() const { return plantId; }
+    Symbol getPlantId() const { return plantId; }
+    ArchetypeId getArchetype() const { return archetype; }
     bool canAfford(i32 sun) const { return cost <= sun; }
     
 private:
-    std::string plantId;
-    std::string name;
+    Symbol plantId = kNoSymbol;
+    ArchetypeId archetype = kInvalidArchetype;
+    Symbol name = kNoSymbol;
     i32 cost = 0;
     Rarity rarity = Rarity::Common;
     f32 cooldown = 0.0f;
@@ -84,13 +86,13 @@ public:
     void onMouseClick(const Vec2& pos);
     
     // 植物選擇
-    const std::string& getSelectedPlant() const { return selectedPlant; }
-    void selectPlant(const std::string& plantId);
-    void deselectPlant() { selectedPlant.clear(); }
+    Symbol getSelectedPlant() const { return selectedPlant; }
+    void selectPlant(Symbol plantId);
+    void deselectPlant() { selectedPlant = kNoSymbol; }
     
 private:
     std::vector<PlantCard> plantCards;
-    std::string selectedPlant;
+    Symbol selectedPlant = kNoSymbol;
     
     void renderSunDisplay(const Game& game);
     void renderWaveInfo(const Game& game);
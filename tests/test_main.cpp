@@ -3,10 +3,39 @@
 // ============================================
 
 #include "lua/lua_manager.hpp"
+#include "lua/lua_alloc.hpp"
+#include "core/handle.hpp"
+#include "core/fixed_timestep.hpp"
+#include "core/random.hpp"
+#include "core/status.hpp"
+#include "core/spatial_hash.hpp"
+#include "core/simd_distance.hpp"
+#include "core/log.hpp"
+#include "core/work_pool.hpp"
+#include "core/symbol.hpp"
+#include "game/entity_store.hpp"
+#include "game/lane_index.hpp"
+#include "game/plant_grid.hpp"
+#include "game/archetype.hpp"
+#include "game/data_pack.hpp"
+#include "game/game_data.hpp"
+#include "game/level_loader.hpp"
+#include "game/script_hooks.hpp"
+#include "game/hot_reload.hpp"
+#include "game/game.hpp"
+#include "game/replay.hpp"
+#include <atomic>
 #include <iostream>
 #include <cassert>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <iterator>
 #include <stdexcept>
+#include <thread>
 
 using namespace PL;
 
@@ -167,6 +196,368 @@ void test_enemies() {
     tests_passed++;
 }
 
+void test_archetypes() {
+    TEST("Archetypes - Build registry from Lua tables");
+    
+    ArchetypeRegistry& registry = ArchetypeRegistry::instance();
+    if (!registry.build(LuaManager::instance().getState())) {
+        FAIL("Failed to build archetype registry");
+    }
+    
+    ArchetypeId pea = registry.findPlant("pea_sprite");
+    if (pea == kInvalidArchetype) {
+        FAIL("pea_sprite archetype not found");
+    }
+    
+    const PlantArchetype& data = registry.plant(pea);
+    if (data.stats.damage != 25.0f || data.cost != 100 || data.cooldown != 5.0f) {
+        FAIL("pea_sprite archetype stats mismatch");
+    }
+    if (data.rarity != Rarity::Common) {
+        FAIL("pea_sprite should be common");
+    }
+    if (data.evolvesTo != registry.findPlant("twin_sprite")) {
+        FAIL("pea_sprite should evolve to twin_sprite");
+    }
+    
+    if (std::string(symbolName(data.name)) != "豌豆精靈") {
+        FAIL("pea_sprite name symbol mismatch");
+    }
+    
+    if (registry.findEnemy("corrupted_slime") == kInvalidArchetype) {
+        FAIL("corrupted_slime archetype not found");
+    }
+    if (registry.findPlant("no_such_plant") != kInvalidArchetype) {
+        FAIL("unknown id should return kInvalidArchetype");
+    }
+    
+    // 原型對齊到快取行
+    if (alignof(PlantArchetype) != 64 || alignof(EnemyArchetype) != 64) {
+        FAIL("archetypes should be cache-line aligned");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_script_hooks() {
+    TEST("Script Hooks - Cached refs and batched dispatch");
+    
+    LuaManager& lua = LuaManager::instance();
+    lua_State* L = lua.getState();
+    ArchetypeRegistry& registry = ArchetypeRegistry::instance();
+    ScriptHooks& scripts = ScriptHooks::instance();
+    
+    // 測試用植物：每次更新扣 1 血、加第幾次更新的陽光；攻擊時改發三顆
+    bool ok = lua.executeString(
+        "plants.hook_test = {"
+        "  cost = 0, stats = { hp = 100, damage = 5, range = 2000 },"
+        "  bonus = 1,"
+        "  on_update = function(self, dt)"
+        "    self.hp = self.hp - 1; self.ticks = (self.ticks or 0) + 1; game:add_sun(self.bonus * self.ticks)"
+        "  end,"
+        "  on_attack = function(self, target) self:shoot({ count = 3 }) end,"
+        "}");
+    if (!ok || !registry.build(L) || !scripts.bind(L)) {
+        FAIL("Failed to bind script hooks");
+    }
+    
+    // 解析結果存在原型內
+    const HookSet& pea = registry.plant(registry.findPlant("pea_sprite")).hooks;
+    if (!pea.has(Hook::Attack) || !pea.has(Hook::Kill) || pea.has(Hook::Update)) {
+        FAIL("pea_sprite hooks mismatch");
+    }
+    if (!registry.enemy(registry.findEnemy("corrupted_larva")).hooks.has(Hook::Death)) {
+        FAIL("special.on_death should be resolved");
+    }
+    if (registry.enemy(registry.findEnemy("corrupted_slime")).hooks.any()) {
+        FAIL("corrupted_slime should have no hooks");
+    }
+    
+    scripts.resetStats();
+    {
+        Game game;
+        game.initialize();
+        game.addSun(1000);
+        if (!game.placePlant("hook_test", GridCoord(0, 2)) || !game.placePlant("hook_test", GridCoord(1, 2))) {
+            FAIL("Failed to place hook_test");
+        }
+        game.spawnEnemy("corrupted_slime", 2);
+        game.setState(GameState::Playing);
+        
+        i32 sun = game.getSun();
+        game.update(0.01f);
+        
+        if (scripts.getStats(Hook::Update).calls != 2 || game.getSun() != sun + 2) {
+            FAIL("on_update was not dispatched");
+        }
+        // 兩筆事件只有一次 C -> Lua 批次呼叫
+        if (scripts.getStats(Hook::Update).batches != 1 || scripts.getPending(Hook::Update) != 0) {
+            FAIL("on_update events should be flushed in one batch");
+        }
+        if (game.getPlants().hp[0] != 99.0f || game.getPlants().hp[1] != 99.0f) {
+            FAIL("on_update hp write was not applied");
+        }
+        if (scripts.getStats(Hook::Attack).calls != 2 || game.getProjectiles().size() != 6) {
+            FAIL("on_attack should replace the default shot");
+        }
+        if (scripts.getStats(Hook::Update).errors != 0 || scripts.getStats(Hook::Attack).errors != 0) {
+            FAIL("hooks raised errors");
+        }
+        
+        // 自訂欄位存在各實體自己的表，原型定義表不變
+        game.update(0.01f);
+        if (game.getSun() != sun + 6 || scripts.getStats(Hook::Update).errors != 0) {
+            FAIL("per-instance script fields should persist between calls");
+        }
+        lua_getglobal(L, "plants");
+        lua_getfield(L, -1, "hook_test");
+        lua_getfield(L, -1, "ticks");
+        bool leaked = !lua_isnil(L, -1);
+        lua_pop(L, 3);
+        if (leaked) {
+            FAIL("instance writes should not touch the archetype table");
+        }
+    }
+    
+    // 鳳凰花：on_death 在死亡前同步呼叫，回傳 false 時復活一次
+    {
+        Game game;
+        game.initialize();
+        game.addSun(1000);
+        if (!game.placePlant("phoenix_bloom", GridCoord(0, 0))) {
+            FAIL("Failed to place phoenix_bloom");
+        }
+        game.setState(GameState::Playing);
+        
+        const PlantStore& plants = game.getPlants();
+        const PlantHandle phoenix = plants.handleAt(0);
+        game.addStatus(phoenix, StatusEffect(StatusType::Burn, 10.0f, 100000.0f));
+        
+        game.update(0.01f);
+        u32 p = plants.resolve(phoenix);
+        if (p == kInvalidIndex || !plants.alive[p] || plants.hp[p] != plants.maxHp[p] || game.getPlantsLost() != 0) {
+            FAIL("phoenix_bloom should revive at full hp");
+        }
+        
+        game.update(0.01f);
+        if (plants.resolve(phoenix) != kInvalidIndex || game.getPlantsLost() != 1) {
+            FAIL("phoenix_bloom should die once its revive is spent");
+        }
+        if (scripts.getStats(Hook::Death).calls != 2 || scripts.getStats(Hook::Death).errors != 0) {
+            FAIL("on_death should run once per death without errors");
+        }
+    }
+    
+    // dragon_breath 的錐形傷害與燃燒只打到射程內、60 度扇形裡的敵人
+    {
+        Game game;
+        game.initialize();
+        game.addSun(1000);
+        if (!game.placePlant("dragon_breath", GridCoord(0, 2))) {
+            FAIL("Failed to place dragon_breath");
+        }
+        
+        // 植物在 (140, 350)：同排 x=300 在扇形內，鄰排 x=300 偏出半角，同排 x=600 超出射程
+        const ArchetypeId bucket = registry.findEnemy("bucket_skeleton");
+        game.spawnEnemy(bucket, 2, 300.0f);
+        game.spawnEnemy(bucket, 1, 300.0f);
+        game.spawnEnemy(bucket, 2, 600.0f);
+        game.setState(GameState::Playing);
+        game.update(0.01f);
+        
+        // 80 傷害經 30% 護甲減為 56
+        const EnemyStore& enemies = game.getEnemies();
+        if (enemies.size() != 3 || enemies.hp[0] < 243.5f || enemies.hp[0] > 244.5f ||
+            !enemies.status[0].has(StatusType::Burn)) {
+            FAIL("enemy inside the cone should take breath damage and burn");
+        }
+        for (u32 e = 1; e < 3; e++) {
+            if (enemies.hp[e] != enemies.maxHp[e] || enemies.status[e].has(StatusType::Burn)) {
+                FAIL("enemies outside the cone should be untouched");
+            }
+        }
+        if (scripts.getStats(Hook::Attack).errors != 0) {
+            FAIL("dragon_breath on_attack should run without errors");
+        }
+    }
+    
+    lua.executeString("plants.hook_test = nil");
+    registry.build(L);
+    scripts.unbind();
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_hot_reload() {
+    TEST("Hot Reload - In-place archetype patching");
+    
+    namespace fs = std::filesystem;
+    LuaManager& lua = LuaManager::instance();
+    lua_State* L = lua.getState();
+    ArchetypeRegistry& registry = ArchetypeRegistry::instance();
+    const char* dir = "test_hot_reload";
+    const std::string script = std::string(dir) + "/patch.lua";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    
+    auto writeScript = [&](const char* code) {
+        std::ofstream file(script, std::ios::binary | std::ios::trunc);
+        file << code;
+    };
+    
+    const ArchetypeId pea = registry.findPlant("pea_sprite");
+    const ArchetypeId slime = registry.findEnemy("corrupted_slime");
+    const u32 plantCount = registry.getPlantCount();
+    const Stats before = registry.plant(pea).stats;
+    
+    HotReload reload;
+    if (!reload.watch(dir)) {
+        FAIL("Failed to watch directory");
+    }
+    
+    {
+        Game game;
+        game.initialize();
+        game.addSun(1000);
+        game.placePlant("pea_sprite", GridCoord(0, 1));
+        game.placePlant("nut_guard", GridCoord(1, 1));
+        game.spawnEnemy("corrupted_slime", 1);
+        
+        // 只改 pea_sprite 的數值並新增一個原型
+        writeScript(
+            "plants.pea_sprite.stats.damage = plants.pea_sprite.stats.damage + 10\n"
+            "plants.pea_sprite.stats.hp = plants.pea_sprite.stats.hp * 2\n"
+            "plants.reload_probe = { cost = 0, stats = { hp = 1 } }\n");
+        if (reload.update(game) != 1) {
+            FAIL("watcher did not report the written script");
+        }
+        
+        const ReloadStats& stats = reload.getLastReload();
+        if (!stats.ok || stats.plantsChanged != 1 || stats.enemiesChanged != 0 || stats.added != 1) {
+            FAIL("only pea_sprite should change");
+        }
+        if (registry.findPlant("pea_sprite") != pea || registry.findPlant("reload_probe") != plantCount) {
+            FAIL("existing ids must stay stable, new archetypes appended");
+        }
+        if (registry.plant(pea).stats.damage != before.damage + 10) {
+            FAIL("archetype was not patched");
+        }
+        
+        // 場上的實體套用新的基礎數值，滿血仍是滿血
+        const PlantStore& plants = game.getPlants();
+        if (stats.entitiesPatched != 1 || plants.objects[0].getStats().damage != before.damage + 10 ||
+            plants.maxHp[0] != before.maxHp * 2 || plants.hp[0] != plants.maxHp[0]) {
+            FAIL("live plant was not patched");
+        }
+        if (game.getEnemies().objects[0].getArchetypeId() != slime ||
+            game.getEnemies().maxHp[0] != registry.enemy(slime).stats.maxHp) {
+            FAIL("unchanged enemy should be untouched");
+        }
+        
+        // 腳本出錯時保留原本的表與原型
+        writeScript("plants = {}\nerror('broken on purpose')\n");
+        if (reload.reloadFile(game, script)) {
+            FAIL("broken script should fail to reload");
+        }
+        lua_getglobal(L, "plants");
+        lua_getfield(L, -1, "pea_sprite");
+        bool kept = lua_istable(L, -1);
+        lua_pop(L, 2);
+        if (!kept || registry.plant(pea).stats.damage != before.damage + 10) {
+            FAIL("failed reload should keep the previous data");
+        }
+        
+        // 還原：重新執行原始腳本，數值回到原樣
+        if (!reload.reloadFile(game, "scripts/plants/all_plants.lua") ||
+            registry.plant(pea).stats.damage != before.damage ||
+            game.getPlants().maxHp[0] != before.maxHp) {
+            FAIL("reloading the original script should restore stats");
+        }
+    }
+    
+    // 射程加大後，閒置植物要被走進新覆蓋桶的敵人喚醒
+    {
+        Game game;
+        game.initialize();
+        game.addSun(1000);
+        game.placePlant("pea_sprite", GridCoord(0, 1));
+        game.spawnEnemy(slime, 1, 950.0f);
+        game.setState(GameState::Playing);
+        game.update(1.0f / 60.0f);
+        
+        writeScript("plants.pea_sprite.stats.range = 700\n");
+        if (!reload.reloadFile(game, script) || game.getPlants().range[0] != 700.0f) {
+            FAIL("range was not patched");
+        }
+        
+        // 舊射程 400 只到 x = 540，新射程到 x = 840
+        const PlantStore& plants = game.getPlants();
+        const EnemyStore& enemies = game.getEnemies();
+        for (u32 t = 0; t < 600 && enemies.size() > 0 && enemies.x[0] > 820.0f; t++) {
+            game.update(1.0f / 60.0f);
+        }
+        if (enemies.size() != 1 || enemies.x[0] > 820.0f) {
+            FAIL("enemy did not walk into the new range");
+        }
+        if (plants.target[0] != enemies.handleAt(0)) {
+            FAIL("idle plant was not woken inside the raised range");
+        }
+        
+        if (!reload.reloadFile(game, "scripts/plants/all_plants.lua") || plants.range[0] != before.range) {
+            FAIL("reloading the original script should restore range");
+        }
+    }
+    
+    lua.executeString("plants.reload_probe = nil");
+    registry.build(L);
+    fs::remove_all(dir);
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_symbols() {
+    TEST("Symbols - Interned ids");
+    
+    SymbolTable& table = SymbolTable::instance();
+    
+    Symbol a = intern("test_symbol_a");
+    Symbol b = intern("test_symbol_b");
+    if (a == kNoSymbol || b == kNoSymbol || a == b) {
+        FAIL("distinct strings should get distinct symbols");
+    }
+    
+    // 同一字串（不同緩衝區）回傳同一符號
+    std::string copy = "test_symbol_a";
+    if (intern(copy) != a || table.find(copy) != a) {
+        FAIL("interning is not stable");
+    }
+    
+    if (table.str(a) != "test_symbol_a") {
+        FAIL("symbol should map back to its string");
+    }
+    if (table.find("test_symbol_missing") != kNoSymbol) {
+        FAIL("find should not register new strings");
+    }
+    if (intern("") != kNoSymbol || table.str(kNoSymbol) != "") {
+        FAIL("empty string should be kNoSymbol");
+    }
+    
+    // 大量登記後舊符號的字串仍有效（元素不搬移）
+    const std::string& before = table.str(a);
+    for (u32 i = 0; i < 1000; i++) {
+        intern("test_symbol_" + std::to_string(i));
+    }
+    if (&before != &table.str(a) || table.find("test_symbol_999") == kNoSymbol) {
+        FAIL("symbol strings should stay put as the table grows");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
 void test_levels() {
     TEST("Levels - Load all_levels.lua");
     
@@ -224,6 +615,233 @@ void test_levels() {
     tests_passed++;
 }
 
+void test_data_pack() {
+    TEST("DataPack - Bake, map and read back");
+    
+    lua_State* L = LuaManager::instance().getState();
+    const char* path = "test_game.pack";
+    
+    GameConfig config;
+    if (!readConfig(L, config)) {
+        FAIL("config table not found");
+    }
+    
+    std::vector<LevelData> levels;
+    for (const std::string& id : listLevels(L)) {
+        levels.emplace_back();
+        readLevel(L, id, levels.back());
+    }
+    if (levels.empty()) {
+        FAIL("no levels to bake");
+    }
+    
+    ArchetypeRegistry& registry = ArchetypeRegistry::instance();
+    if (!writePack(path, config, registry, levels)) {
+        FAIL("writePack failed");
+    }
+    
+    DataPack pack;
+    if (!pack.open(path)) {
+        FAIL("baked pack failed validation");
+    }
+    if (pack.getPlantCount() != registry.getPlantCount() || pack.getEnemyCount() != registry.getEnemyCount() ||
+        pack.getLevelCount() != levels.size()) {
+        FAIL("pack record counts mismatch");
+    }
+    
+    GameConfig packed;
+    pack.readConfig(packed);
+    if (packed.grid.cols != config.grid.cols || packed.startingSun != config.startingSun ||
+        packed.elements.chainRange != config.elements.chainRange) {
+        FAIL("pack config mismatch");
+    }
+    
+    // 關卡與 Lua 讀到的一致
+    LevelData fromLua;
+    readLevel(L, "1-1", fromLua);
+    const PackLevel* level = pack.findLevel("1-1");
+    if (!level) {
+        FAIL("level 1-1 not found in pack");
+    }
+    LevelData fromPack;
+    pack.readLevel(*level, fromPack);
+    if (fromPack.id != fromLua.id || fromPack.waves.size() != fromLua.waves.size() ||
+        fromPack.initialSun != fromLua.initialSun) {
+        FAIL("pack level 1-1 mismatch");
+    }
+    for (size_t w = 0; w < fromLua.waves.size(); w++) {
+        if (fromPack.waves[w].time != fromLua.waves[w].time ||
+            fromPack.waves[w].enemies != fromLua.waves[w].enemies) {
+            FAIL("pack wave mismatch");
+        }
+    }
+    if (pack.findLevel("no_such_level") != nullptr) {
+        FAIL("unknown level should not be found");
+    }
+    pack.close();
+    
+    // 原型表可由資料包重建，ID 不變
+    ArchetypeId pea = registry.findPlant("pea_sprite");
+    Stats peaStats = registry.plant(pea).stats;
+    pack.open(path);
+    registry.build(pack);
+    if (registry.findPlant("pea_sprite") != pea || registry.plant(pea).stats.damage != peaStats.damage ||
+        registry.plant(pea).evolvesTo != registry.findPlant("twin_sprite")) {
+        FAIL("registry rebuilt from pack mismatch");
+    }
+    pack.close();
+    
+    // 校驗和正確但索引越界的資料包也要被拒絕
+    {
+        std::vector<u8> bytes;
+        {
+            std::ifstream file(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        auto rejects = [&](auto patch) {
+            std::vector<u8> broken = bytes;
+            PackHeader* h = reinterpret_cast<PackHeader*>(broken.data());
+            patch(broken.data(), *h);
+            h->checksum = packChecksum(broken.data() + sizeof(PackHeader), (u32)(broken.size() - sizeof(PackHeader)));
+            {
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<const char*>(broken.data()), (std::streamsize)broken.size());
+            }
+            DataPack bad;
+            return !bad.open(path);
+        };
+        auto first = [](u8* base, const PackHeader& h, PackSection s) {
+            return base + h.sections[(u32)s].offset;
+        };
+        if (!rejects([&](u8* base, const PackHeader& h) {
+                reinterpret_cast<PackLevel*>(first(base, h, PackSection::Levels))->waveCount = 0x10000;
+            })) {
+            FAIL("level wave range past the Waves section should be rejected");
+        }
+        if (!rejects([&](u8* base, const PackHeader& h) {
+                PackWave* wave = reinterpret_cast<PackWave*>(first(base, h, PackSection::Waves));
+                wave->firstEnemy = h.sections[(u32)PackSection::WaveEnemies].count;
+                wave->enemyCount = 1;
+            })) {
+            FAIL("wave enemy range past the WaveEnemies section should be rejected");
+        }
+        if (!rejects([&](u8* base, const PackHeader& h) {
+                reinterpret_cast<PackPlant*>(first(base, h, PackSection::Plants))->name =
+                    h.sections[(u32)PackSection::Strings].count;
+            })) {
+            FAIL("string reference past the Strings section should be rejected");
+        }
+        
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+    }
+    if (!pack.open(path)) {
+        FAIL("restored pack should open again");
+    }
+    pack.close();
+    
+    // 損毀一個位元組後必須被拒絕
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(sizeof(PackHeader) + 8);
+        file.put('\x7f');
+    }
+    if (pack.open(path)) {
+        FAIL("corrupted pack should fail checksum");
+    }
+    std::remove(path);
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_level_loader() {
+    TEST("Levels - Index and load a single level on demand");
+    
+    lua_State* L = LuaManager::instance().getState();
+    const char* path = "test_levels.lua";
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "levels = {}\n"
+                "\n"
+                "-- 區域\n"
+                "levels[\"t-1\"] = {\n"
+                "    grid = { cols = 7, rows = 3 },\n"
+                "    waves = {\n"
+                "        { time = 1, enemies = { { type = \"corrupted_slime\", count = 2 } } },\n"
+                "    },\n"
+                "}\n"
+                "\n"
+                "levels.bonus = {\n"
+                "    initial = { sun = 300 },\n"
+                "    waves = {\n"
+                "        { time = 0, enemies = { { type = \"skeleton_minion\", count = 1 } } },\n"
+                "        { time = 5, enemies = { { type = \"corrupted_slime\", count = 4 } } },\n"
+                "    },\n"
+                "}\n"
+                "\n"
+                "return levels\n";
+    }
+    
+    LevelLoader& loader = LevelLoader::instance();
+    LevelIndex& index = loader.getIndex();
+    index.clear();
+    if (index.addFile(path) != 2) {
+        FAIL("test_levels.lua should index 2 levels");
+    }
+    
+    LevelData level;
+    if (!loader.load(L, "bonus", level)) {
+        FAIL("failed to load indexed level 'bonus'");
+    }
+    if (loader.getLastLoad().source != LevelSource::Index || loader.getLastLoad().bytes == 0) {
+        FAIL("bonus should come from the index");
+    }
+    if (level.initialSun != 300 || level.waves.size() != 2 || level.waves[1].enemies[0].second != 4) {
+        FAIL("bonus level data mismatch");
+    }
+    
+    if (!loader.load(L, "t-1", level) || level.cols != 7 || level.rows != 3 || level.waves.size() != 1) {
+        FAIL("t-1 level data mismatch");
+    }
+    
+    // 區塊在區域表中執行，不會寫入全域 levels
+    lua_getglobal(L, "levels");
+    lua_getfield(L, -1, "bonus");
+    bool leaked = !lua_isnil(L, -1);
+    lua_pop(L, 2);
+    if (leaked) {
+        FAIL("indexed load should not touch the global levels table");
+    }
+    
+    // 真實關卡檔：逐關載入的結果與整表讀取一致
+    index.clear();
+    if (index.addDirectory("scripts/levels") == 0) {
+        FAIL("scripts/levels should index at least one level");
+    }
+    LevelData fromTable;
+    readLevel(L, "1-1", fromTable);
+    if (!loader.load(L, "1-1", level) || level.waves.size() != fromTable.waves.size() ||
+        level.initialSun != fromTable.initialSun) {
+        FAIL("indexed 1-1 differs from table read");
+    }
+    for (size_t w = 0; w < level.waves.size(); w++) {
+        if (level.waves[w].enemies != fromTable.waves[w].enemies) {
+            FAIL("indexed 1-1 wave mismatch");
+        }
+    }
+    
+    if (loader.load(L, "no_such_level", level)) {
+        FAIL("unknown level should fail");
+    }
+    
+    index.clear();
+    std::remove(path);
+    
+    PASS();
+    tests_passed++;
+}
+
 void test_evolution() {
     TEST("Evolution - Test plant evolution chain");
     
@@ -314,6 +932,924 @@ void test_elements() {
     tests_passed++;
 }
 
+void test_lua_allocator() {
+    TEST("Lua Allocator - Size-class pool and GC budget");
+    
+    LuaAllocator pool;
+    
+    // 分級邊界
+    if (LuaAllocator::classOf(1) != 0 || LuaAllocator::classOf(16) != 0 || LuaAllocator::classOf(17) != 1 ||
+        LuaAllocator::classOf(256) != LuaAllocator::kClassCount - 1 ||
+        LuaAllocator::classOf(257) != LuaAllocator::kClassCount) {
+        FAIL("size class mapping mismatch");
+    }
+    
+    void* a = LuaAllocator::alloc(&pool, nullptr, 0, 24);
+    void* b = LuaAllocator::alloc(&pool, nullptr, 0, 24);
+    if (!a || !b || a == b || pool.getStats().bytes != 48) {
+        FAIL("pooled allocation failed");
+    }
+    
+    // 同一級內 realloc 原地返回，釋放後的區塊優先重用
+    if (LuaAllocator::alloc(&pool, a, 24, 30) != a) {
+        FAIL("realloc within a class should not move");
+    }
+    LuaAllocator::alloc(&pool, a, 30, 0);
+    if (LuaAllocator::alloc(&pool, nullptr, 0, 20) != a) {
+        FAIL("freed block should be reused");
+    }
+    
+    // 跨級搬移保留內容，大區塊交給 malloc
+    std::memcpy(b, "plant-legends", 14);
+    void* c = LuaAllocator::alloc(&pool, b, 24, 1000);
+    if (!c || std::memcmp(c, "plant-legends", 14) != 0 || pool.getStats().largeAllocs != 1) {
+        FAIL("cross-class realloc lost data");
+    }
+    LuaAllocator::alloc(&pool, c, 1000, 0);
+    LuaAllocator::alloc(&pool, a, 20, 0);
+    if (pool.getStats().bytes != 0 || pool.getStats().reservedBytes == 0) {
+        FAIL("heap accounting mismatch");
+    }
+    
+    // LuaManager 的 state 走同一個配置器；GC 只在給定的時間內推進
+    LuaManager& lua = LuaManager::instance();
+    if (lua.getHeapStats().bytes == 0) {
+        FAIL("Lua state should allocate through the pool");
+    }
+    
+    double previous = lua.getGcBudget();
+    lua.setGcBudget(2.0);
+    lua.executeString("local t = {} for i = 1, 2000 do t[i] = { i } end");
+    LuaGcStats before = lua.getGcStats();
+    lua.stepGc(0.0);
+    if (lua.getGcStats().steps != before.steps) {
+        FAIL("GC should not step without slack");
+    }
+    lua.stepGc(5.0);
+    if (lua.getGcStats().steps == before.steps) {
+        FAIL("GC should step with slack");
+    }
+    lua.setGcBudget(previous);
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_call_function() {
+    TEST("Lua - Typed callFunction");
+    
+    LuaManager& lua = LuaManager::instance();
+    lua_State* L = lua.getState();
+    const int top = lua_gettop(L);
+    
+    bool ok = lua.executeString(
+        "function call_add(a, b) return a + b end\n"
+        "function call_scale(x, y, k) return x * k, y * k end\n"
+        "function call_handle(h) return h end\n"
+        "function call_name(kind) if kind == 'plant' then return 'pea_sprite' end return 'slime' end\n"
+        "function call_fail() error('call failed on purpose') end\n"
+        "call_label = 'pea_sprite'\n");
+    if (!ok) FAIL("Failed to define test functions");
+    
+    LuaFunction add = lua.findFunction("call_add");
+    if (!add.isValid() || lua.findFunction("call_missing").isValid()) {
+        FAIL("findFunction should only resolve functions");
+    }
+    
+    if (lua.callFunction<int>(add, 2, 40) != 42 || lua.callFunction<int>("call_add", 1, 2) != 3) {
+        FAIL("int call returned wrong value");
+    }
+    if (std::fabs(lua.callFunction<f32>(add, 0.25f, 0.5) - 0.75f) > 1e-6f) {
+        FAIL("float call returned wrong value");
+    }
+    Vec2 scaled = lua.callFunction<Vec2>("call_scale", Vec2(1.5f, -2.0f), 2);
+    if (scaled.x != 3.0f || scaled.y != -4.0f) {
+        FAIL("Vec2 should round-trip as two numbers");
+    }
+    EnemyHandle handle(7, 3);
+    if (lua.callFunction<EnemyHandle>("call_handle", handle) != handle ||
+        !lua.callFunction<EnemyHandle>("call_handle", EnemyHandle()).isNull()) {
+        FAIL("handle should round-trip");
+    }
+    if (lua.callFunction<std::string>("call_name", std::string_view("plant")) != "pea_sprite") {
+        FAIL("string call returned wrong value");
+    }
+    if (lua.getGlobal<std::string_view>("call_label") != "pea_sprite" || lua.getGlobal<std::string>("call_missing") != "") {
+        FAIL("string globals mismatch");
+    }
+    
+    // 錯誤路徑：回傳預設值，狀態與訊息另外查詢
+    u64 errors = lua.getCallStats().errors;
+    lua.callFunction("call_fail");
+    if (lua.getCallStatus() != LuaCallStatus::RuntimeError || !std::strstr(lua.getCallError(), "on purpose")) {
+        FAIL("runtime error not reported");
+    }
+    if (lua.callFunction<int>("call_missing", 1) != 0 || lua.getCallStatus() != LuaCallStatus::NotFound) {
+        FAIL("missing function not reported");
+    }
+    if (lua.callFunction<int>("call_name", "plant") != 0 || lua.getCallStatus() != LuaCallStatus::BadResult) {
+        FAIL("result type mismatch not reported");
+    }
+    if (lua.getCallStats().errors != errors + 3) {
+        FAIL("error count mismatch");
+    }
+    
+    // 數值呼叫在暖身後不向 Lua 堆配置
+    for (int i = 0; i < 16; i++) lua.callFunction<int>(add, i, i);
+    u64 allocs = lua.getHeapStats().allocs;
+    i64 sum = 0;
+    for (int i = 0; i < 1000; i++) sum += lua.callFunction<int>(add, i, 1);
+    if (lua.getHeapStats().allocs != allocs || sum != 500500) {
+        FAIL("numeric calls should not allocate");
+    }
+    
+    if (lua_gettop(L) != top) {
+        FAIL("callFunction left values on the stack");
+    }
+    
+    lua.releaseFunction(add);
+    lua.executeString("call_add, call_scale, call_handle, call_name, call_fail, call_label = nil");
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_bytecode_cache() {
+    TEST("Lua - Bytecode cache keyed by source hash");
+    
+    namespace fs = std::filesystem;
+    LuaManager& lua = LuaManager::instance();
+    lua_State* L = lua.getState();
+    const char* script = "test_cache_script.lua";
+    fs::remove_all("test_luacache");
+    
+    auto writeScript = [&](const char* code) {
+        std::ofstream file(script, std::ios::binary | std::ios::trunc);
+        file << code;
+    };
+    auto runScript = [&]() -> lua_Integer {
+        if (!lua.loadScript(script)) {
+            FAIL("loadScript failed: " + lua.getLastError());
+        }
+        lua_Integer result = lua_tointeger(L, -1);  // 回傳值留在棧上
+        lua_pop(L, 1);
+        return result;
+    };
+    
+    lua.setBytecodeCache("test_luacache");
+    BytecodeCacheStats before = lua.getCacheStats();
+    
+    writeScript("cache_probe = 41\nreturn 7\n");
+    if (runScript() != 7) FAIL("first load returned wrong value");
+    if (lua.getCacheStats().misses != before.misses + 1 || lua.getCacheStats().writes != before.writes + 1) {
+        FAIL("first load should miss and write the cache");
+    }
+    
+    if (runScript() != 7) FAIL("cached load returned wrong value");
+    if (lua.getCacheStats().hits != before.hits + 1) {
+        FAIL("second load should hit the cache");
+    }
+    if (lua.getGlobal<int>("cache_probe") != 41) {
+        FAIL("cached chunk did not run");
+    }
+    
+    // 原始碼變了，雜湊不同必須重新編譯
+    writeScript("cache_probe = 42\nreturn 8\n");
+    if (runScript() != 8 || lua.getCacheStats().misses != before.misses + 2) {
+        FAIL("changed source should miss the cache");
+    }
+    
+    // 只有預編譯 .luac 時也能載入
+    if (luaL_loadstring(L, "return 9") != LUA_OK) FAIL("luaL_loadstring failed");
+    std::string bytecode;
+    LuaManager::dumpChunk(L, bytecode, true);
+    lua_pop(L, 1);
+    {
+        std::ofstream file("test_precompiled.luac", std::ios::binary | std::ios::trunc);
+        file.write(bytecode.data(), (std::streamsize)bytecode.size());
+    }
+    if (!lua.loadScript("test_precompiled.lua") || lua_tointeger(L, -1) != 9) {
+        FAIL("precompiled bytecode fallback failed");
+    }
+    lua_pop(L, 1);
+    if (lua.getCacheStats().precompiled != before.precompiled + 1) {
+        FAIL("precompiled load not counted");
+    }
+    
+    lua.setBytecodeCache(".luacache");
+    fs::remove(script);
+    fs::remove("test_precompiled.luac");
+    fs::remove_all("test_luacache");
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_fixed_timestep() {
+    TEST("Fixed Timestep - Accumulator, clamp and determinism");
+    
+    // 2 的冪步長，累加沒有捨入誤差
+    FixedTimestep step;
+    step.configure(64.0f, 4);
+    if (step.advance(1.0f / 32.0f) != 2 || step.getAlpha() != 0.0f) {
+        FAIL("two ticks expected");
+    }
+    if (step.advance(1.0f / 128.0f) != 0 || step.getAlpha() != 0.5f) {
+        FAIL("half a tick should be left for interpolation");
+    }
+    if (step.advance(1.0f / 128.0f) != 1 || step.getAlpha() != 0.0f) {
+        FAIL("leftover should carry into the next frame");
+    }
+    // 慢幀：最多 4 個 tick，其餘捨棄
+    if (step.advance(1.0f) != 4 || step.getDroppedSteps() != 60 || step.getAlpha() != 0.0f) {
+        FAIL("slow frame should be clamped");
+    }
+    if (step.getTicks() != 7) {
+        FAIL("tick count mismatch");
+    }
+    
+    // 同樣的 tick 數，不論幀怎麼切，結果相同
+    auto run = [](auto&& drive) {
+        Game game;
+        game.initialize();
+        game.spawnEnemy("corrupted_slime", 2);
+        game.setState(GameState::Playing);
+        drive(game);
+        return std::make_pair(game.getEnemies().x[0], game.getTimestep().getTicks());
+    };
+    auto direct = run([](Game& g) {
+        for (int i = 0; i < 120; i++) g.update(g.getTimestep().getStep());
+    });
+    auto perTick = run([](Game& g) {
+        for (int i = 0; i < 120; i++) g.advance(g.getTimestep().getStep());
+    });
+    auto slowFrames = run([](Game& g) {
+        const u32 maxSteps = g.getTimestep().getMaxSteps();
+        for (u32 i = 0; i < 120 / maxSteps; i++) g.advance(1.0f);  // 每幀被限制在 maxSteps
+    });
+    if (perTick.second != 120 || slowFrames.second != 120) {
+        FAIL("advance ran the wrong number of ticks");
+    }
+    if (direct.first != perTick.first || direct.first != slowFrames.first) {
+        FAIL("simulation depends on frame slicing");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_random() {
+    TEST("Random - PCG32 streams and seeded games");
+    
+    // PCG32 參考實作的輸出（pcg32_srandom(42, 54)）
+    Pcg32 reference(42, 54);
+    const u32 expected[] = { 0xa15c02b7, 0x7b47f409, 0xba1d3330, 0x83d2f293, 0xbfa4784b, 0xcbed606e };
+    for (u32 value : expected) {
+        if (reference.next() != value) {
+            FAIL("PCG32 output differs from the reference");
+        }
+    }
+    
+    Pcg32 rng(7, 0);
+    for (int i = 0; i < 1000; i++) {
+        i32 v = rng.range(-2, 3);
+        f32 f = rng.nextFloat();
+        if (v < -2 || v > 3 || f < 0.0f || f >= 1.0f || rng.nextBelow(5) >= 5) {
+            FAIL("value out of range");
+        }
+    }
+    
+    // 子串流互不影響：多抽 Combat 不會改變 Spawn
+    GameRandom a, b;
+    a.seed(123);
+    b.seed(123);
+    for (int i = 0; i < 10; i++) a[RandomStream::Combat].next();
+    if (a[RandomStream::Spawn].next() != b[RandomStream::Spawn].next()) {
+        FAIL("streams should be independent");
+    }
+    if (b[RandomStream::Spawn].next() == b[RandomStream::Combat].next()) {
+        FAIL("streams should differ for the same seed");
+    }
+    
+    // 同一種子的兩局，波次出生行完全相同
+    auto spawnRows = [](u64 seed) {
+        Game game;
+        game.setSeed(seed);
+        game.initialize();
+        LevelData level;
+        WaveConfig wave;
+        wave.enemies.emplace_back(intern("corrupted_slime"), 20);
+        level.waves.push_back(wave);
+        game.applyLevel(level);
+        game.startLevel();
+        game.update(game.getTimestep().getStep());
+        std::vector<i32> rows;
+        for (u32 i = 0; i < game.getEnemies().size(); i++) rows.push_back(game.getEnemies().row[i]);
+        return rows;
+    };
+    std::vector<i32> first = spawnRows(2024);
+    if (first.size() != 20 || first != spawnRows(2024)) {
+        FAIL("same seed should spawn the same rows");
+    }
+    if (first == spawnRows(2025)) {
+        FAIL("different seeds should spawn different rows");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_replay() {
+    TEST("Replay - Varint encoding and deterministic playback");
+    
+    // 編解碼：大 tick、負數陽光、64 位元種子
+    Replay replay;
+    replay.seed = 0xfedcba9876543210ull;
+    replay.level = intern("1-1");
+    replay.startSun = -5;
+    ReplayEvent place;
+    place.tick = 3;
+    place.plant = intern("pea_sprite");
+    place.coord = GridCoord(4, 2);
+    ReplayEvent collect;
+    collect.tick = 1ull << 40;
+    collect.command = ReplayCommand::CollectSun;
+    collect.amount = -25;
+    replay.events = { place, collect };
+    
+    std::vector<u8> bytes;
+    replay.encode(bytes);
+    Replay decoded;
+    if (!decoded.decode(bytes.data(), bytes.size()) || decoded.seed != replay.seed ||
+        decoded.level != replay.level || decoded.startSun != -5 || decoded.events.size() != 2 ||
+        decoded.events[0].plant != place.plant || decoded.events[0].coord.col != 4 ||
+        decoded.events[1].tick != collect.tick || decoded.events[1].amount != -25) {
+        FAIL("replay round trip mismatch");
+    }
+    for (size_t n = 0; n < bytes.size(); n++) {
+        if (decoded.decode(bytes.data(), n)) {
+            FAIL("truncated replay should be rejected");
+        }
+    }
+    bytes[8] ^= 1;
+    if (decoded.decode(bytes.data(), bytes.size())) {
+        FAIL("corrupted replay should be rejected");
+    }
+    
+    // 錄一局，播放後狀態逐位元相同
+    LevelIndex& index = LevelLoader::instance().getIndex();
+    index.clear();
+    index.addDirectory("scripts/levels");
+    
+    struct Snapshot {
+        i32 sun;
+        u32 plants;
+        u32 enemies;
+        f32 enemyX;
+        f32 enemyHp;
+    };
+    auto snapshot = [](const Game& game) {
+        Snapshot s = { game.getSun(), game.getPlants().size(), game.getEnemies().size(), 0.0f, 0.0f };
+        for (u32 i = 0; i < s.enemies; i++) {
+            s.enemyX += game.getEnemies().x[i];
+            s.enemyHp += game.getEnemies().hp[i];
+        }
+        return s;
+    };
+    
+    Replay recorded;
+    Snapshot live;
+    {
+        Game game;
+        game.setSeed(77);
+        game.setRecorder(&recorded);
+        game.initialize();
+        if (!game.loadLevel("1-1")) {
+            FAIL("failed to load level 1-1");
+        }
+        game.addSun(500);
+        game.startLevel();
+        const f32 dt = game.getTimestep().getStep();
+        for (u32 t = 0; t < 3600 && game.getState() == GameState::Playing; t++) {
+            if (t == 0) game.placePlant("pea_sprite", GridCoord(0, 2));
+            if (t == 60) game.placePlant("pea_sprite", GridCoord(1, 1));
+            if (t == 90) game.placePlant("pea_sprite", GridCoord(0, 1));
+            if (t == 120) game.collectSun(25);
+            if (t == 300) game.removePlant(GridCoord(1, 1));
+            if (t == 301) game.removePlant(GridCoord(1, 1));  // 已空，不會錄下
+            game.update(dt);
+        }
+        live = snapshot(game);
+    }
+    if (recorded.events.size() != 5 || recorded.seed != 77 || recorded.events[1].tick != 60) {
+        FAIL("recorder should capture successful inputs with their tick");
+    }
+    
+    recorded.encode(bytes);
+    Replay loaded;
+    if (!loaded.decode(bytes.data(), bytes.size())) {
+        FAIL("recorded replay should decode");
+    }
+    Game game;
+    game.initialize();
+    ReplayPlayer player(loaded);
+    if (!player.start(game)) {
+        FAIL("replay level should load");
+    }
+    for (u32 t = 0; t < 3600 && game.getState() == GameState::Playing; t++) {
+        player.apply(game);
+        game.update(loaded.step);
+    }
+    Snapshot played = snapshot(game);
+    if (!player.isFinished() || player.getDesyncs() != 0 || player.getApplied() != 5) {
+        FAIL("every recorded input should apply");
+    }
+    if (std::memcmp(&live, &played, sizeof(Snapshot)) != 0) {
+        FAIL("playback diverged from the recorded session");
+    }
+    
+    index.clear();
+    PASS();
+    tests_passed++;
+}
+
+void test_handles() {
+    TEST("Handles - Generational slot table");
+    
+    SlotTable slots;
+    EnemyHandle a = slots.allocate<Enemy>(0);
+    EnemyHandle b = slots.allocate<Enemy>(1);
+    
+    if (slots.resolve(a) != 0 || slots.resolve(b) != 1) {
+        FAIL("handles should resolve to their dense index");
+    }
+    
+    // 移除 a，b 搬到 dense 0
+    slots.release(a.index);
+    slots.move(b.index, 0);
+    
+    if (slots.resolve(a) != kInvalidIndex) {
+        FAIL("released handle should be stale");
+    }
+    if (slots.resolve(b) != 0) {
+        FAIL("moved handle should follow its dense index");
+    }
+    
+    // 槽位重用後舊句柄仍然失效
+    EnemyHandle c = slots.allocate<Enemy>(1);
+    if (c.index != a.index || c.generation == a.generation) {
+        FAIL("reused slot should bump generation");
+    }
+    if (slots.resolve(a) != kInvalidIndex || slots.resolve(c) != 1) {
+        FAIL("stale handle resolved after slot reuse");
+    }
+    
+    slots.releaseAll();
+    if (slots.resolve(b) != kInvalidIndex || slots.resolve(c) != kInvalidIndex) {
+        FAIL("releaseAll should invalidate every handle");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_projectile_pool() {
+    TEST("Projectiles - Fixed-capacity pool");
+    
+    ProjectilePool pool;
+    pool.reset(3);
+    if (pool.capacity() != 3 || pool.size() != 0 || pool.getStats().capacity != 3) {
+        FAIL("reset should size the pool");
+    }
+    
+    EnemyHandle target(4, 1);
+    for (u32 i = 0; i < 3; i++) {
+        if (pool.add(Vec2(i * 10.0f, 0.0f), target, 10.0f + i, Element::Fire) != i) {
+            FAIL("projectiles should fill the pool in order");
+        }
+    }
+    
+    // 池滿：捨棄並計數，不擴容
+    if (pool.add(Vec2(), target, 1.0f, Element::None) != kInvalidIndex) {
+        FAIL("full pool should reject new projectiles");
+    }
+    const ProjectilePoolStats& stats = pool.getStats();
+    if (stats.dropped != 1 || stats.spawned != 3 || pool.size() != 3 || pool.capacity() != 3) {
+        FAIL("dropped projectile should only be counted");
+    }
+    
+    // 移除以最後一筆補位，最高水位保留
+    pool.removeAt(0);
+    if (pool.size() != 2 || pool.damage[0] != 12.0f || pool.x[0] != 20.0f || pool.target[0] != target) {
+        FAIL("removeAt should swap in the last projectile");
+    }
+    if (stats.live != 2 || stats.highWater != 3 || stats.recycled != 1) {
+        FAIL("stats mismatch after removal");
+    }
+    if (pool.add(Vec2(5.0f, 0.0f), target, 1.0f, Element::Ice) != 2 || stats.dropped != 1) {
+        FAIL("freed slot should be reused");
+    }
+    
+    // 插值在上一個 tick 與目前位置之間
+    pool.savePrevious();
+    pool.x[1] += 8.0f;
+    if (pool.interpolated(1, 0.5f).x != pool.prevX[1] + 4.0f) {
+        FAIL("interpolation should blend previous and current position");
+    }
+    
+    // reset 清空並歸零統計，容量可改
+    pool.reset(3);
+    if (pool.size() != 0 || stats.highWater != 0 || stats.dropped != 0 || stats.spawned != 0) {
+        FAIL("reset should clear projectiles and stats");
+    }
+    pool.reset(5);
+    if (pool.capacity() != 5 || stats.capacity != 5 || pool.add(Vec2(), target, 1.0f, Element::None) != 0) {
+        FAIL("reset should resize the pool");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_lane_index() {
+    TEST("Lanes - Sorted per-row enemy index");
+    
+    LaneIndex lanes;
+    lanes.reset(3);
+    if (lanes.getRows() != 3 || !lanes.occupancyChanged(0)) {
+        FAIL("reset should mark every row changed");
+    }
+    lanes.clearOccupancyChanged();
+    
+    // 植物佔用遮罩
+    lanes.setOccupied(GridCoord(2, 1), true);
+    lanes.setOccupied(GridCoord(5, 1), true);
+    lanes.setOccupied(GridCoord(LaneIndex::kMaxCols, 1), true);  // 超出遮罩，忽略
+    lanes.setOccupied(GridCoord(0, 3), true);                     // 超出行數，忽略
+    if (lanes.rowMask(1) != ((u64(1) << 2) | (u64(1) << 5)) || !lanes.isOccupied(GridCoord(5, 1))) {
+        FAIL("occupancy mask mismatch");
+    }
+    if (!lanes.occupancyChanged(1) || lanes.occupancyChanged(0) || lanes.occupancyChanged(2)) {
+        FAIL("only the touched row should be marked changed");
+    }
+    lanes.setOccupied(GridCoord(2, 1), false);
+    if (lanes.isOccupied(GridCoord(2, 1)) || lanes.rowMask(1) != (u64(1) << 5)) {
+        FAIL("clearing occupancy should drop the bit");
+    }
+    
+    // 敵人：只填 refresh 用到的欄位
+    EnemyStore enemies;
+    enemies.x = {300.0f, 100.0f, 200.0f};
+    EnemyHandle handles[3];
+    for (u32 i = 0; i < 3; i++) {
+        handles[i] = enemies.slots.allocate<Enemy>(i);
+        lanes.insertEnemy(0, handles[i], i, enemies.x[i]);
+    }
+    lanes.insertEnemy(5, handles[0], 0, 0.0f);  // 無效行，忽略
+    
+    lanes.refresh(enemies);
+    const auto& lane = lanes.lane(0);
+    if (lane.size() != 3 || lane[0].dense != 1 || lane[1].dense != 2 || lane[2].dense != 0) {
+        FAIL("refresh should sort the lane by x");
+    }
+    if (lanes.lowerBound(0, 150.0f) != 1 || lanes.lowerBound(0, 50.0f) != 0 || lanes.lowerBound(0, 400.0f) != 3) {
+        FAIL("lowerBound mismatch");
+    }
+    if (!lanes.lane(1).empty() || !lanes.lane(2).empty()) {
+        FAIL("other lanes should stay empty");
+    }
+    
+    // 移動後重新排序，失效句柄被移除
+    enemies.x[0] = 50.0f;
+    enemies.slots.release(handles[2].index);
+    lanes.refresh(enemies);
+    if (lane.size() != 2 || lane[0].handle != handles[0] || lane[0].x != 50.0f || lane[1].handle != handles[1]) {
+        FAIL("refresh should re-sort and drop stale handles");
+    }
+    
+    lanes.clear();
+    if (!lane.empty() || lanes.rowMask(1) != 0 || !lanes.occupancyChanged(2)) {
+        FAIL("clear should empty lanes and occupancy");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_plant_grid() {
+    TEST("Grid - Flat per-cell plant layers");
+    
+    PlantGrid grid;
+    grid.reset(9, 5);
+    if (grid.getCols() != 9 || grid.getRows() != 5 || grid.isAnyOccupied(GridCoord(0, 0))) {
+        FAIL("reset grid should be empty");
+    }
+    
+    // 同一格的圖層互不影響
+    PlantHandle ground(1, 1);
+    PlantHandle overlay(2, 1);
+    grid.set(GridCoord(3, 2), GridLayer::Ground, ground);
+    grid.set(GridCoord(3, 2), GridLayer::Overlay, overlay);
+    if (grid.get(GridCoord(3, 2)) != ground || grid.get(GridCoord(3, 2), GridLayer::Overlay) != overlay ||
+        grid.isOccupied(GridCoord(3, 2), GridLayer::Flyer)) {
+        FAIL("layers should be stored separately");
+    }
+    if (grid.isAnyOccupied(GridCoord(4, 2)) || grid.isAnyOccupied(GridCoord(3, 1))) {
+        FAIL("neighbouring cells should stay empty");
+    }
+    
+    // 超出範圍：查詢回傳空句柄，寫入忽略
+    grid.set(GridCoord(9, 0), GridLayer::Ground, ground);
+    grid.set(GridCoord(0, -1), GridLayer::Ground, ground);
+    if (!grid.get(GridCoord(9, 0)).isNull() || grid.isAnyOccupied(GridCoord(-1, 0)) ||
+        grid.erase(GridCoord(0, 5), GridLayer::Ground, ground)) {
+        FAIL("out-of-bounds access should be ignored");
+    }
+    
+    // 只移除仍是同一句柄的植物
+    PlantHandle replaced(1, 2);
+    grid.set(GridCoord(3, 2), GridLayer::Ground, replaced);
+    if (grid.erase(GridCoord(3, 2), GridLayer::Ground, ground) || grid.get(GridCoord(3, 2)) != replaced) {
+        FAIL("stale handle should not erase a newer plant");
+    }
+    if (!grid.erase(GridCoord(3, 2), GridLayer::Ground, replaced) || grid.isOccupied(GridCoord(3, 2)) ||
+        !grid.isAnyOccupied(GridCoord(3, 2))) {
+        FAIL("erase should only clear its own layer");
+    }
+    
+    grid.clear();
+    if (grid.isAnyOccupied(GridCoord(3, 2)) || grid.getCols() != 9) {
+        FAIL("clear should empty cells and keep the size");
+    }
+    grid.reset(4, 3);
+    if (grid.inBounds(GridCoord(5, 0)) || !grid.inBounds(GridCoord(3, 2))) {
+        FAIL("reset should resize the grid");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_status_set() {
+    TEST("Status - Fixed-slot status set");
+    
+    StatusSet status;
+    if (status.any()) {
+        FAIL("new status set should be empty");
+    }
+    
+    // 中毒疊加到上限
+    for (int i = 0; i < 8; i++) {
+        status.add(StatusEffect(StatusType::Poison, 5.0f, 2.0f), 5);
+    }
+    if (!status.has(StatusType::Poison) || status.get(StatusType::Poison).stacks != 5) {
+        FAIL("poison should stack up to stack_max");
+    }
+    if (std::abs(status.damagePerSecond() - 10.0f) > 0.001f) {
+        FAIL("poison dps should scale with stacks");
+    }
+    
+    // 減速與凍結
+    status.add(StatusEffect(StatusType::Slow, 2.0f, 0.5f));
+    if (std::abs(status.speedMultiplier() - 0.5f) > 0.001f) {
+        FAIL("slow should halve speed");
+    }
+    status.add(StatusEffect(StatusType::Freeze, 1.0f, 0.0f));
+    if (status.speedMultiplier() != 0.0f) {
+        FAIL("freeze should stop movement");
+    }
+    
+    // 到期移除
+    status.update(1.5f);
+    if (status.has(StatusType::Freeze) || !status.has(StatusType::Slow)) {
+        FAIL("freeze should expire before slow");
+    }
+    status.update(4.0f);
+    if (status.any()) {
+        FAIL("all statuses should expire");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_spatial_hash() {
+    TEST("Spatial - Uniform bucket grid queries");
+    
+    // 4x4 網格上放 16 個點，其中一個已死亡
+    const u32 count = 16;
+    f32 xs[count], ys[count];
+    u8 alive[count];
+    for (u32 i = 0; i < count; i++) {
+        xs[i] = 50.0f + (i % 4) * 100.0f;
+        ys[i] = 50.0f + (i / 4) * 100.0f;
+        alive[i] = 1;
+    }
+    alive[5] = 0;
+    
+    SpatialHash hash;
+    hash.configure(0.0f, 0.0f, 400.0f, 400.0f, 100.0f);
+    hash.build(xs, ys, alive, count);
+    if (hash.size() != count - 1) {
+        FAIL("dead entries should not be indexed");
+    }
+    
+    // 半徑查詢：(150,150) 周圍 101 內有 4 個鄰居，5 號已死亡
+    u32 hits = 0;
+    hash.forEachInRadius(Vec2(150.0f, 150.0f), 101.0f, [&](u32 id, f32) {
+        if (id == 5) FAIL("dead entry returned by radius query");
+        hits++;
+    });
+    if (hits != 4) {
+        FAIL("radius query should find 4 neighbours");
+    }
+    
+    // 矩形查詢
+    hits = 0;
+    hash.forEachInRect(0.0f, 0.0f, 200.0f, 100.0f, [&](u32) { hits++; });
+    if (hits != 2) {
+        FAIL("rect query should find 2 entries");
+    }
+    if (hash.countInCells(0.0f, 0.0f, 199.0f, 199.0f) != 3) {
+        FAIL("cell count should skip dead entries");
+    }
+    
+    // 最近的 3 個，依距離排序
+    u32 ids[3];
+    f32 distSq[3];
+    u32 found = hash.kNearest(Vec2(60.0f, 60.0f), 3, 1000.0f, ids, distSq);
+    if (found != 3 || ids[0] != 0 || distSq[0] > distSq[1] || distSq[1] > distSq[2]) {
+        FAIL("kNearest should return sorted nearest entries");
+    }
+    found = hash.kNearest(Vec2(60.0f, 60.0f), 3, 20.0f, ids, distSq);
+    if (found != 1) {
+        FAIL("kNearest should respect max radius");
+    }
+    if (hash.nearest(Vec2(240.0f, 160.0f), 1000.0f) != 6) {
+        FAIL("nearest should agree with the closest entry");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_distance_kernel() {
+    TEST("SIMD - Batch nearest-in-range kernel");
+    
+    // 固定的偽隨機點，長度不是 8 的倍數以涵蓋尾端
+    const u32 count = 1003;
+    std::vector<f32> xs(count), ys(count);
+    u32 seed = 12345;
+    for (u32 i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        xs[i] = (f32)(seed % 1200);
+        seed = seed * 1664525u + 1013904223u;
+        ys[i] = (f32)(seed % 700);
+    }
+    // 兩個等距的點：應取索引較小者
+    xs[500] = 610.0f; ys[500] = 300.0f;
+    xs[900] = 590.0f; ys[900] = 300.0f;
+    
+    const Vec2 origin(600.0f, 300.0f);
+    const f32 rangeSq = 400.0f * 400.0f;
+    NearestResult expected = simd::nearestScalar(origin, xs.data(), ys.data(), count, rangeSq);
+    if (expected.index == kInvalidIndex) {
+        FAIL("scalar kernel should find a point in range");
+    }
+    
+    const simd::Level levels[] = {simd::Level::SSE2, simd::Level::AVX2};
+    for (simd::Level level : levels) {
+        if (level > simd::detectLevel()) continue;
+        NearestResult got = level == simd::Level::AVX2
+            ? simd::nearestAVX2(origin, xs.data(), ys.data(), count, rangeSq)
+            : simd::nearestSSE2(origin, xs.data(), ys.data(), count, rangeSq);
+        if (got.index != expected.index || got.distSq != expected.distSq) {
+            FAIL(std::string(simd::levelName(level)) + " kernel disagrees with scalar");
+        }
+    }
+    
+    // 射程外回傳無效索引
+    NearestResult none = nearestInRange(Vec2(-5000.0f, -5000.0f), xs.data(), ys.data(), count, 100.0f);
+    if (none.index != kInvalidIndex) {
+        FAIL("out-of-range query should return kInvalidIndex");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_work_pool() {
+    TEST("Work Pool - Work stealing and per-thread Lua state");
+    
+    // 前段的工作特別慢，其他執行緒必須竊取才能分攤
+    const u32 jobCount = 2000;
+    std::vector<std::atomic<u32>> hits(jobCount);
+    WorkStealingPool pool(4);
+    u64 done = pool.run(jobCount, [&](u32, u32 job) {
+        if (job < 50) std::this_thread::sleep_for(std::chrono::microseconds(500));
+        hits[job].fetch_add(1, std::memory_order_relaxed);
+    });
+    if (done != jobCount) {
+        FAIL("not every job ran");
+    }
+    for (u32 j = 0; j < jobCount; j++) {
+        if (hits[j].load() != 1) {
+            FAIL("job ran more than once or not at all");
+        }
+    }
+    if (pool.getStats().steals == 0) {
+        FAIL("idle workers should steal");
+    }
+    
+    // 初始化失敗的執行緒不接工作，它的工作由其他執行緒完成
+    std::atomic<u32> count{0};
+    std::atomic<u32> wrongWorker{0};
+    done = pool.run(100, [&](u32 worker, u32) {
+        if (worker == 1) wrongWorker++;
+        count++;
+    }, [](u32 worker) { return worker != 1; });
+    if (wrongWorker.load() != 0) {
+        FAIL("failed worker should not run jobs");
+    }
+    if (done != 100 || count.load() != 100 || pool.getStats().failedWorkers != 1) {
+        FAIL("jobs of a failed worker should be stolen");
+    }
+    
+    // 每個工作執行緒有自己的 Lua 狀態
+    LuaManager* mainLua = &LuaManager::instance();
+    std::atomic<u32> separate{0};
+    pool.run(4, [&](u32, u32) {}, [&](u32) {
+        LuaManager& lua = LuaManager::instance();
+        if (&lua != mainLua && lua.getState() == nullptr && lua.initialize()) {
+            lua.executeString("x = 1");
+            separate++;
+        }
+        return true;
+    }, [](u32) { LuaManager::instance().shutdown(); });
+    if (separate.load() != 4) {
+        FAIL("workers should get their own LuaManager");
+    }
+    if (mainLua->getGlobal<i32>("x") == 1) {
+        FAIL("worker state leaked into the main thread");
+    }
+    
+    PASS();
+    tests_passed++;
+}
+
+void test_logger() {
+    TEST("Logger - Levels, rate limit and concurrent producers");
+    
+    Logger& logger = Logger::instance();
+    const LogLevel previousLevel = logger.getMinLevel();
+    
+    // 低於最低等級的訊息不通過
+    logger.setMinLevel(LogLevel::Warn);
+    if (logger.shouldLog(LogLevel::Info, LogCategory::General)) {
+        FAIL("info should be filtered below warn");
+    }
+    if (!logger.shouldLog(LogLevel::Error, LogCategory::General)) {
+        FAIL("error should pass the level filter");
+    }
+    
+    // 每秒 5 條的分類，連續 20 次只放行 5 次
+    logger.setMinLevel(LogLevel::Info);
+    logger.setRateLimit(LogCategory::Economy, 5);
+    u32 allowed = 0;
+    for (int i = 0; i < 20; i++) {
+        if (logger.shouldLog(LogLevel::Info, LogCategory::Economy)) allowed++;
+    }
+    if (allowed != 5) {
+        FAIL("rate limit should allow 5 messages per second");
+    }
+    logger.setRateLimit(LogCategory::Economy, 0);
+    
+    // 多個生產者同時寫入，排空後全部計入
+    LoggerStats before = logger.getStats();
+    std::thread producers[4];
+    for (int t = 0; t < 4; t++) {
+        producers[t] = std::thread([&logger, t] {
+            for (int i = 0; i < 10; i++) {
+                logger.write(LogLevel::Info, LogCategory::General, "producer %d message %d", t, i);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    logger.flush();
+    
+    LoggerStats after = logger.getStats();
+    if ((after.written - before.written) + (after.dropped - before.dropped) != 40) {
+        FAIL("every message should be written or counted as dropped");
+    }
+    
+    logger.setMinLevel(previousLevel);
+    
+    PASS();
+    tests_passed++;
+}
+
 int main() {
     std::cout << "========================================" << std::endl;
     std::cout << "  Plant Legends - Test Suite" << std::endl;
@@ -324,15 +1860,37 @@ int main() {
         std::cerr << "[Error] Failed to initialize Lua" << std::endl;
         return 1;
     }
+    lua.setBytecodeCache(".luacache");
     
     // 運行測試
     try {
         test_config();
         test_plants();
         test_enemies();
+        test_symbols();
+        test_archetypes();
         test_levels();
+        test_data_pack();
+        test_level_loader();
+        test_script_hooks();
+        test_hot_reload();
         test_evolution();
         test_elements();
+        test_bytecode_cache();
+        test_lua_allocator();
+        test_call_function();
+        test_handles();
+        test_projectile_pool();
+        test_lane_index();
+        test_plant_grid();
+        test_fixed_timestep();
+        test_random();
+        test_replay();
+        test_status_set();
+        test_spatial_hash();
+        test_distance_kernel();
+        test_logger();
+        test_work_pool();
     } catch (const std::exception& e) {
         std::cerr << "\n[EXCEPTION] " << e.what() << std::endl;
         tests_failed++;
@@ -0,0 +1,106 @@
+// ============================================
+// Plant Legends - 資料包烘焙工具
+// ============================================
+// 離線執行一次 Lua 腳本，把設定、植物/敵人原型與所有關卡寫成
+// 帶版本與校驗和的二進位資料包，遊戲啟動時直接 mmap 使用。
+//
+// 用法: plant-legends-bake <scripts 目錄> <輸出檔>
+
+#include "lua/lua_manager.hpp"
+#include "game/archetype.hpp"
+#include "game/data_pack.hpp"
+#include "game/game_data.hpp"
+#include "core/log.hpp"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace PL;
+
+namespace {
+
+int bake(const std::string& scripts, const std::string& output) {
+    auto start = std::chrono::steady_clock::now();
+    
+    LuaManager& lua = LuaManager::instance();
+    if (!lua.initialize()) {
+        std::fprintf(stderr, "[Error] Failed to initialize Lua\n");
+        return 1;
+    }
+    
+    const char* files[] = {
+        "/config.lua",
+        "/plants/all_plants.lua",
+        "/enemies/all_enemies.lua",
+        "/levels/all_levels.lua",
+    };
+    for (const char* file : files) {
+        if (!lua.loadScript(scripts + file)) {
+            std::fprintf(stderr, "[Error] %s%s: %s\n", scripts.c_str(), file, lua.getLastError().c_str());
+            return 1;
+        }
+    }
+    
+    lua_State* L = lua.getState();
+    
+    GameConfig config;
+    if (!readConfig(L, config)) {
+        std::fprintf(stderr, "[Error] config table not found\n");
+        return 1;
+    }
+    
+    ArchetypeRegistry& archetypes = ArchetypeRegistry::instance();
+    if (!archetypes.build(L)) {
+        return 1;
+    }
+    
+    std::vector<LevelData> levels;
+    for (const std::string& id : listLevels(L)) {
+        levels.emplace_back();
+        readLevel(L, id, levels.back());
+        
+        // 關卡引用的敵人必須存在，否則在烘焙時就擋下
+        for (const WaveConfig& wave : levels.back().waves) {
+            for (const auto& [enemyId, count] : wave.enemies) {
+                if (archetypes.findEnemy(enemyId) == kInvalidArchetype) {
+                    std::fprintf(stderr, "[Error] level %s: unknown enemy %s\n", id.c_str(), symbolName(enemyId));
+                    return 1;
+                }
+            }
+        }
+    }
+    
+    if (!writePack(output, config, archetypes, levels)) {
+        return 1;
+    }
+    
+    // 回讀驗證
+    DataPack pack;
+    if (!pack.open(output)) {
+        std::fprintf(stderr, "[Error] %s failed validation after writing\n", output.c_str());
+        return 1;
+    }
+    
+    f64 ms = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("Baked %s (v%u, %u bytes): %u plants, %u enemies, %u levels in %.1f ms\n",
+                output.c_str(), kPackVersion, pack.getSize(),
+                pack.getPlantCount(), pack.getEnemyCount(), pack.getLevelCount(), ms);
+    
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <scripts-dir> <output.pack>\n", argv[0]);
+        return 2;
+    }
+    
+    Logger::instance().start();
+    int rc = bake(argv[1], argv[2]);
+    LuaManager::instance().shutdown();
+    Logger::instance().stop();
+    return rc;
+}
@@ -0,0 +1,321 @@
+// ============================================
+// Plant Legends - 平衡測試（蒙地卡羅）
+// ============================================
+// 對「關卡 × 放置策略」矩陣的每一格跑 N 次不同種子的無頭模擬，
+// 以工作竊取執行緒池分散到所有核心；每個工作執行緒有自己的 Lua 狀態與 Game。
+// 彙總勝率、通關時間、陽光曲線、植物損失與星級達成率（all_levels.lua 的 stars）輸出成 CSV。
+//
+// 用法: plant-legends-balance [選項]
+//   --level <id>           關卡，可重複（預設 1-1）
+//   --strategy <file.lua>  放置策略（與 plant-legends-sim 的放置腳本相同），可重複；
+//                          名稱取檔名，可寫成 name=file.lua。未指定時只跑不放植物的 none
+//   --runs <n>             每格模擬次數（預設 1000）
+//   --seed <n>             起始種子（預設 1）；第 k 次模擬用 seed + k，各格共用同一組種子
+//   --threads <n>          工作執行緒數（預設硬體執行緒數）
+//   --scripts <dir>        腳本目錄（預設 scripts）
+//   --max-time <seconds>   單次模擬的遊戲時間上限（預設 600）
+//   --sun-interval <s>     陽光曲線取樣間隔（預設 10）
+//   --sun-samples <n>      陽光曲線取樣數（預設 13，即 0..120 秒）
+//   --out <file.csv>       輸出檔（預設 balance.csv，- 為標準輸出）
+
+#include "sim_common.hpp"
+#include "lua/lua_manager.hpp"
+#include "core/log.hpp"
+#include "core/work_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace PL;
+
+namespace {
+
+struct Strategy {
+    std::string name;
+    std::string file;  // 空字串：不放植物
+};
+
+struct Options {
+    std::vector<std::string> levels;
+    std::vector<Strategy> strategies;
+    std::string scripts = "scripts";
+    std::string out = "balance.csv";
+    u32 runs = 1000;
+    u64 seed = 1;
+    u32 threads = 0;
+    f32 maxTime = 600.0f;
+    f32 sunInterval = 10.0f;
+    u32 sunSamples = 13;
+};
+
+// 星級（對應 stars 的 id）
+enum StarBits : u8 {
+    kStarComplete = 1 << 0,     // complete
+    kStarNoPlantLost = 1 << 1,  // no_plant_lost
+    kStarUnderTime = 1 << 2,    // under_time
+};
+
+struct RunResult {
+    GameState outcome = GameState::Menu;  // Menu：關卡載入失敗
+    f32 time = 0.0f;
+    u32 plantsLost = 0;
+    u8 stars = 0;
+};
+
+// 每個工作執行緒各自的放置策略（原型 ID 來自該執行緒的原型表）
+struct WorkerState {
+    std::vector<std::vector<sim::Placement>> strategies;
+};
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "usage: %s [--level id]... [--strategy [name=]file.lua]... [--runs n] [--seed n] [--threads n]\n"
+        "          [--scripts dir] [--max-time seconds] [--sun-interval seconds] [--sun-samples n] [--out file.csv]\n",
+        argv0);
+}
+
+Strategy parseStrategy(const std::string& spec) {
+    Strategy s;
+    size_t eq = spec.find('=');
+    if (eq != std::string::npos) {
+        s.name = spec.substr(0, eq);
+        s.file = spec.substr(eq + 1);
+        return s;
+    }
+    s.file = spec;
+    size_t slash = spec.find_last_of("/\\");
+    s.name = spec.substr(slash == std::string::npos ? 0 : slash + 1);
+    size_t dot = s.name.rfind('.');
+    if (dot != std::string::npos && dot > 0) s.name.resize(dot);
+    return s;
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) {
+            std::fprintf(stderr, "[Error] %s needs a value\n", arg);
+            return false;
+        }
+        i++;
+        
+        if (std::strcmp(arg, "--level") == 0) {
+            opt.levels.push_back(value);
+        } else if (std::strcmp(arg, "--strategy") == 0) {
+            opt.strategies.push_back(parseStrategy(value));
+        } else if (std::strcmp(arg, "--runs") == 0) {
+            opt.runs = (u32)std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            opt.seed = std::strtoull(value, nullptr, 0);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            opt.threads = (u32)std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--scripts") == 0) {
+            opt.scripts = value;
+        } else if (std::strcmp(arg, "--max-time") == 0) {
+            opt.maxTime = (f32)std::atof(value);
+        } else if (std::strcmp(arg, "--sun-interval") == 0) {
+            opt.sunInterval = (f32)std::atof(value);
+        } else if (std::strcmp(arg, "--sun-samples") == 0) {
+            opt.sunSamples = (u32)std::strtoul(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--out") == 0) {
+            opt.out = value;
+        } else {
+            std::fprintf(stderr, "[Error] unknown option %s\n", arg);
+            return false;
+        }
+    }
+    if (opt.levels.empty()) opt.levels.push_back("1-1");
+    if (opt.strategies.empty()) opt.strategies.push_back({ "none", "" });
+    if (opt.runs == 0 || opt.maxTime <= 0.0f || opt.sunInterval <= 0.0f) {
+        std::fprintf(stderr, "[Error] --runs, --max-time and --sun-interval must be positive\n");
+        return false;
+    }
+    return true;
+}
+
+// 單次模擬；sun 寫入 sunSamples 個取樣，提早結束的模擬以最後的陽光補滿
+void runOne(const Options& opt, const std::string& level, const std::vector<sim::Placement>& placements,
+            u64 seed, RunResult& result, f32* sun, u64& ticks) {
+    Game game;
+    game.setSeed(seed);
+    if (!game.initialize() || !game.loadLevel(level)) {
+        return;
+    }
+    LuaManager::instance().setGcBudget(0.0);
+    game.startLevel();
+    
+    const f32 dt = game.getTimestep().getStep();
+    const u64 maxTicks = (u64)(opt.maxTime / dt);
+    sim::PlacementDriver driver(placements);
+    u32 sampled = 0;
+    u64 n = 0;
+    while (game.getState() == GameState::Playing && n < maxTicks) {
+        if (sampled < opt.sunSamples && game.getLevelTime() >= sampled * opt.sunInterval) {
+            sun[sampled++] = (f32)game.getSun();
+        }
+        driver.apply(game);
+        game.update(dt);
+        n++;
+    }
+    while (sampled < opt.sunSamples) {
+        sun[sampled++] = (f32)game.getSun();
+    }
+    ticks += n;
+    
+    result.outcome = game.getState();
+    result.time = game.getLevelTime();
+    result.plantsLost = game.getPlantsLost();
+    if (result.outcome == GameState::Victory) {
+        result.stars |= kStarComplete;
+        if (result.plantsLost == 0) result.stars |= kStarNoPlantLost;
+        if (game.getStarTime() > 0.0f && result.time <= game.getStarTime()) result.stars |= kStarUnderTime;
+    }
+}
+
+f32 percentile(const std::vector<f32>& sorted, f32 p) {
+    if (sorted.empty()) return 0.0f;
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5f);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+// 每格一列
+void writeCsv(std::FILE* f, const Options& opt, const std::vector<RunResult>& results, const std::vector<f32>& sun) {
+    std::fprintf(f, "level,strategy,runs,errors,win_rate,defeat_rate,timeout_rate,clear_time_mean,clear_time_p50,"
+                    "clear_time_p90,plants_lost_mean,star_complete,star_no_plant_lost,star_under_time,stars_mean");
+    for (u32 s = 0; s < opt.sunSamples; s++) {
+        std::fprintf(f, ",sun_%g", s * opt.sunInterval);
+    }
+    std::fprintf(f, "\n");
+    
+    const u32 strategyCount = (u32)opt.strategies.size();
+    std::vector<f32> clearTimes;
+    std::vector<f64> sunSum(opt.sunSamples);
+    for (u32 cell = 0; cell < opt.levels.size() * strategyCount; cell++) {
+        u32 valid = 0, wins = 0, defeats = 0, lost = 0;
+        u32 starCount[3] = {};
+        f64 clearSum = 0.0;
+        clearTimes.clear();
+        std::fill(sunSum.begin(), sunSum.end(), 0.0);
+        
+        for (u32 run = 0; run < opt.runs; run++) {
+            const u32 job = cell * opt.runs + run;
+            const RunResult& r = results[job];
+            if (r.outcome == GameState::Menu) continue;
+            valid++;
+            lost += r.plantsLost;
+            if (r.outcome == GameState::Victory) {
+                wins++;
+                clearSum += r.time;
+                clearTimes.push_back(r.time);
+            } else if (r.outcome == GameState::GameOver) {
+                defeats++;
+            }
+            for (u32 b = 0; b < 3; b++) {
+                if (r.stars & (1u << b)) starCount[b]++;
+            }
+            for (u32 s = 0; s < opt.sunSamples; s++) {
+                sunSum[s] += sun[(size_t)job * opt.sunSamples + s];
+            }
+        }
+        std::sort(clearTimes.begin(), clearTimes.end());
+        
+        const f64 inv = valid > 0 ? 1.0 / valid : 0.0;
+        std::fprintf(f, "%s,%s,%u,%u,%.4f,%.4f,%.4f,%.2f,%.2f,%.2f,%.3f,%.4f,%.4f,%.4f,%.3f",
+                     opt.levels[cell / strategyCount].c_str(), opt.strategies[cell % strategyCount].name.c_str(),
+                     valid, opt.runs - valid, wins * inv, defeats * inv, (valid - wins - defeats) * inv,
+                     wins > 0 ? clearSum / wins : 0.0, percentile(clearTimes, 0.5f), percentile(clearTimes, 0.9f),
+                     lost * inv, starCount[0] * inv, starCount[1] * inv, starCount[2] * inv,
+                     (starCount[0] + starCount[1] + starCount[2]) * inv);
+        for (u32 s = 0; s < opt.sunSamples; s++) {
+            std::fprintf(f, ",%.1f", sunSum[s] * inv);
+        }
+        std::fprintf(f, "\n");
+    }
+}
+
+int balance(const Options& opt) {
+    const u32 strategyCount = (u32)opt.strategies.size();
+    const u64 jobCount64 = (u64)opt.levels.size() * strategyCount * opt.runs;
+    if (jobCount64 > 0xffffffffull) {
+        std::fprintf(stderr, "[Error] too many runs\n");
+        return 2;
+    }
+    const u32 jobCount = (u32)jobCount64;
+    
+    std::vector<RunResult> results(jobCount);
+    std::vector<f32> sun((size_t)jobCount * opt.sunSamples);
+    
+    WorkStealingPool pool(opt.threads);
+    std::vector<WorkerState> workers(pool.getThreadCount());
+    std::vector<u64> ticks(pool.getThreadCount());
+    
+    // 每個工作執行緒載入自己的 Lua 狀態、原型與策略
+    auto onStart = [&](u32 w) {
+        if (!sim::loadScripts(opt.scripts)) return false;
+        workers[w].strategies.resize(strategyCount);
+        for (u32 s = 0; s < strategyCount; s++) {
+            const std::string& file = opt.strategies[s].file;
+            if (!file.empty() && !sim::loadPlacements(file, workers[w].strategies[s])) return false;
+            sim::sortPlacements(workers[w].strategies[s]);
+        }
+        return true;
+    };
+    auto onExit = [&](u32) { sim::unloadScripts(); };
+    
+    // 工作 = (格, 次)；同一次的種子在每一格相同，策略之間的差異不受亂數影響
+    auto job = [&](u32 w, u32 index) {
+        const u32 cell = index / opt.runs;
+        const u32 run = index % opt.runs;
+        runOne(opt, opt.levels[cell / strategyCount], workers[w].strategies[cell % strategyCount],
+               opt.seed + run, results[index], &sun[(size_t)index * opt.sunSamples], ticks[w]);
+    };
+    
+    auto start = std::chrono::steady_clock::now();
+    const u64 executed = pool.run(jobCount, job, onStart, onExit);
+    f64 wall = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    
+    if (executed != jobCount) {
+        std::fprintf(stderr, "[Error] only %llu of %u runs executed (%u workers failed to load scripts)\n",
+                     (unsigned long long)executed, jobCount, pool.getStats().failedWorkers);
+        return 1;
+    }
+    
+    std::FILE* f = opt.out == "-" ? stdout : std::fopen(opt.out.c_str(), "w");
+    if (!f) {
+        std::fprintf(stderr, "[Error] cannot write %s\n", opt.out.c_str());
+        return 1;
+    }
+    writeCsv(f, opt, results, sun);
+    if (f != stdout) std::fclose(f);
+    
+    u64 totalTicks = 0;
+    for (u64 t : ticks) totalTicks += t;
+    std::fprintf(stderr, "%u runs on %u threads in %.2f s (%.0f runs/s, %.0f ticks/s, %llu steals) -> %s\n",
+                 jobCount, pool.getThreadCount(), wall, wall > 0.0 ? jobCount / wall : 0.0,
+                 wall > 0.0 ? totalTicks / wall : 0.0, (unsigned long long)pool.getStats().steals, opt.out.c_str());
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    
+    Logger& logger = Logger::instance();
+    logger.setMinLevel(LogLevel::Warn);
+    logger.start();
+    
+    int rc = balance(opt);
+    
+    logger.stop();
+    return rc;
+}
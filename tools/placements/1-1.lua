@@ -0,0 +1,14 @@
+-- ============================================
+-- plant-legends-sim 放置腳本範例（關卡 1-1）
+-- ============================================
+-- 每筆：plant 原型、col / row 格子、at 最早放置時間（秒，預設 0）。
+-- 依 at 排序後逐筆放置；陽光不足時等到足夠再放，後面的項目跟著排隊。
+
+return {
+    { plant = "pea_sprite", col = 0, row = 2 },
+    { plant = "pea_sprite", col = 0, row = 1 },
+    { plant = "pea_sprite", col = 0, row = 3 },
+    { plant = "pea_sprite", col = 0, row = 0 },
+    { plant = "pea_sprite", col = 0, row = 4 },
+    { plant = "pea_sprite", col = 1, row = 2, at = 30 },
+}
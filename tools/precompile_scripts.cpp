@@ -0,0 +1,83 @@
+// ============================================
+// Plant Legends - Lua 腳本預編譯工具
+// ============================================
+// 將 scripts/**.lua 編譯成去除除錯資訊的位元組碼，保留目錄結構輸出成 .luac。
+// Web 建置只打包輸出目錄，LuaManager::loadScript 找不到原始碼時會載入 .luac。
+// Lua 5.4 位元組碼只檢查 Instruction / lua_Integer / lua_Number 大小與位元組序，
+// 桌面 x86-64 / arm64 產生的檔案可直接給 wasm32 使用。
+//
+// 用法: plant-legends-luac <scripts 目錄> <輸出目錄>
+
+#include "lua/lua_manager.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <scripts-dir> <output-dir>\n", argv[0]);
+        return 2;
+    }
+    const fs::path input = argv[1];
+    const fs::path output = argv[2];
+    
+    lua_State* L = luaL_newstate();
+    if (!L) {
+        std::fprintf(stderr, "[Error] Failed to create Lua state\n");
+        return 1;
+    }
+    
+    int rc = 0;
+    unsigned count = 0;
+    uintmax_t sourceBytes = 0;
+    size_t bytecodeBytes = 0;
+    
+    std::error_code ec;
+    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(input, ec)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".lua") continue;
+        
+        const fs::path rel = fs::relative(entry.path(), input);
+        fs::path target = output / rel;
+        target += "c";  // foo.lua -> foo.luac
+        
+        // 只編譯不執行
+        const std::string chunkName = "@scripts/" + rel.generic_string();
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (luaL_loadbufferx(L, source.data(), source.size(), chunkName.c_str(), "t") != LUA_OK) {
+            std::fprintf(stderr, "[Error] %s\n", lua_tostring(L, -1));
+            lua_pop(L, 1);
+            rc = 1;
+            continue;
+        }
+        
+        std::string bytecode;
+        PL::LuaManager::dumpChunk(L, bytecode, true);
+        lua_pop(L, 1);
+        
+        fs::create_directories(target.parent_path(), ec);
+        std::ofstream out(target, std::ios::binary | std::ios::trunc);
+        if (!out || !out.write(bytecode.data(), (std::streamsize)bytecode.size())) {
+            std::fprintf(stderr, "[Error] Failed to write %s\n", target.string().c_str());
+            rc = 1;
+            continue;
+        }
+        
+        count++;
+        sourceBytes += source.size();
+        bytecodeBytes += bytecode.size();
+    }
+    
+    if (ec) {
+        std::fprintf(stderr, "[Error] %s: %s\n", input.string().c_str(), ec.message().c_str());
+        rc = 1;
+    }
+    
+    lua_close(L);
+    std::printf("Precompiled %u scripts: %ju source bytes -> %zu bytecode bytes\n",
+                count, sourceBytes, bytecodeBytes);
+    return rc;
+}
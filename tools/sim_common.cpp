@@ -0,0 +1,161 @@
+// ============================================
+// Plant Legends - 無頭模擬共用部分
+// ============================================
+
+#include "sim_common.hpp"
+#include "lua/lua_manager.hpp"
+#include "game/level_loader.hpp"
+#include "game/script_hooks.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace PL {
+namespace sim {
+
+namespace {
+
+bool resolvePlant(const std::string& id, Placement& out) {
+    out.plant = ArchetypeRegistry::instance().findPlant(id);
+    if (out.plant == kInvalidArchetype) {
+        std::fprintf(stderr, "[Error] unknown plant %s\n", id.c_str());
+        return false;
+    }
+    return true;
+}
+
+// 腳本回傳的表留在棧頂
+bool readPlacements(lua_State* L, std::vector<Placement>& out) {
+    if (!lua_istable(L, -1)) {
+        std::fprintf(stderr, "[Error] placement script must return a table\n");
+        return false;
+    }
+    
+    const lua_Integer count = (lua_Integer)lua_rawlen(L, -1);
+    for (lua_Integer i = 1; i <= count; i++) {
+        lua_rawgeti(L, -1, i);
+        Placement p;
+        bool ok = lua_istable(L, -1);
+        if (ok) {
+            lua_getfield(L, -1, "plant");
+            ok = lua_type(L, -1) == LUA_TSTRING && resolvePlant(lua_tostring(L, -1), p);
+            lua_pop(L, 1);
+            
+            lua_getfield(L, -1, "col");
+            lua_getfield(L, -2, "row");
+            lua_getfield(L, -3, "at");
+            p.coord.col = (i32)lua_tointeger(L, -3);
+            p.coord.row = (i32)lua_tointeger(L, -2);
+            p.at = (f32)lua_tonumber(L, -1);
+            lua_pop(L, 3);
+        }
+        lua_pop(L, 1);
+        
+        if (!ok) {
+            std::fprintf(stderr, "[Error] placement #%lld is invalid\n", (long long)i);
+            return false;
+        }
+        out.push_back(p);
+    }
+    return true;
+}
+
+} // namespace
+
+bool loadScripts(const std::string& dir) {
+    LuaManager& lua = LuaManager::instance();
+    if (!lua.initialize()) {
+        std::fprintf(stderr, "[Error] Failed to initialize Lua\n");
+        return false;
+    }
+    
+    const char* files[] = {
+        "/config.lua",
+        "/plants/all_plants.lua",
+        "/enemies/all_enemies.lua",
+    };
+    lua_State* L = lua.getState();
+    for (const char* file : files) {
+        if (!lua.loadScript(dir + file)) {
+            std::fprintf(stderr, "[Error] %s%s: %s\n", dir.c_str(), file, lua.getLastError().c_str());
+            return false;
+        }
+        lua_settop(L, 0);
+    }
+    
+    // 關卡按需載入：只索引，不執行 all_levels.lua
+    if (LevelLoader::instance().getIndex().addDirectory(dir + "/levels") == 0) {
+        std::fprintf(stderr, "[Error] no levels found in %s/levels\n", dir.c_str());
+        return false;
+    }
+    
+    if (!ArchetypeRegistry::instance().build(L)) {
+        return false;
+    }
+    ScriptHooks::instance().bind(L);
+    return true;
+}
+
+void unloadScripts() {
+    ScriptHooks::instance().unbind();
+    LevelLoader::instance().getIndex().clear();
+    LuaManager::instance().shutdown();
+}
+
+bool loadPlacements(const std::string& file, std::vector<Placement>& out) {
+    LuaManager& lua = LuaManager::instance();
+    if (!lua.loadScript(file)) {
+        std::fprintf(stderr, "[Error] %s: %s\n", file.c_str(), lua.getLastError().c_str());
+        return false;
+    }
+    lua_State* L = lua.getState();
+    bool ok = readPlacements(L, out);
+    lua_settop(L, 0);
+    return ok;
+}
+
+bool parsePlace(const std::string& spec, Placement& out) {
+    size_t at = spec.find('@');
+    if (at == std::string::npos || !resolvePlant(spec.substr(0, at), out)) {
+        std::fprintf(stderr, "[Error] bad --place %s (expected id@col,row[@t])\n", spec.c_str());
+        return false;
+    }
+    f32 time = 0.0f;
+    int fields = std::sscanf(spec.c_str() + at + 1, "%d,%d@%f", &out.coord.col, &out.coord.row, &time);
+    if (fields < 2) {
+        std::fprintf(stderr, "[Error] bad --place %s (expected id@col,row[@t])\n", spec.c_str());
+        return false;
+    }
+    out.at = time;
+    return true;
+}
+
+void sortPlacements(std::vector<Placement>& placements) {
+    std::stable_sort(placements.begin(), placements.end(),
+                     [](const Placement& a, const Placement& b) { return a.at < b.at; });
+}
+
+void PlacementDriver::apply(Game& game) {
+    const ArchetypeRegistry& registry = ArchetypeRegistry::instance();
+    while (next < placements.size() && placements[next].at <= game.getLevelTime()) {
+        const Placement& p = placements[next];
+        if (game.getSun() < registry.plant(p.plant).cost) break;
+        if (game.placePlant(p.plant, p.coord)) {
+            placed++;
+        } else if (verbose) {
+            std::fprintf(stderr, "[Warn] cannot place %s at (%d, %d)\n",
+                         symbolName(registry.plant(p.plant).id), p.coord.col, p.coord.row);
+        }
+        next++;
+    }
+}
+
+const char* outcomeName(GameState state) {
+    switch (state) {
+        case GameState::Victory:  return "victory";
+        case GameState::GameOver: return "defeat";
+        default:                  return "timeout";
+    }
+}
+
+} // namespace sim
+} // namespace PL
@@ -0,0 +1,52 @@
+// ============================================
+// Plant Legends - 無頭模擬共用部分
+// ============================================
+// plant-legends-sim 與 plant-legends-balance 共用：載入腳本、讀取放置腳本、依序放置植物。
+// 只使用目前執行緒的 LuaManager / ArchetypeRegistry，可在多個工作執行緒各自呼叫。
+
+#pragma once
+
+#include "game/archetype.hpp"
+#include "game/game.hpp"
+#include <string>
+#include <vector>
+
+namespace PL {
+namespace sim {
+
+struct Placement {
+    ArchetypeId plant = kInvalidArchetype;
+    GridCoord coord;
+    f32 at = 0.0f;
+};
+
+// 在目前執行緒建立 Lua 狀態，載入 config / 植物 / 敵人，索引關卡，建立原型並綁定回呼
+bool loadScripts(const std::string& dir);
+void unloadScripts();
+
+// 放置腳本（Lua，回傳 { { plant=, col=, row=, at= }, ... }）；結果附加在 out 之後
+bool loadPlacements(const std::string& file, std::vector<Placement>& out);
+bool parsePlace(const std::string& spec, Placement& out);  // id@col,row[@t]
+void sortPlacements(std::vector<Placement>& placements);   // 依 at 穩定排序
+
+// 每 tick 前呼叫：依序放置到時的植物。陽光不足時等待（後面的項目跟著排隊），格子無法放置則略過
+class PlacementDriver {
+public:
+    explicit PlacementDriver(const std::vector<Placement>& placements, bool verbose = false)
+        : placements(placements), verbose(verbose) {}
+    
+    void apply(Game& game);
+    
+    u32 getPlaced() const { return placed; }
+    
+private:
+    const std::vector<Placement>& placements;
+    size_t next = 0;
+    u32 placed = 0;
+    bool verbose = false;
+};
+
+const char* outcomeName(GameState state);  // victory / defeat / timeout
+
+} // namespace sim
+} // namespace PL
@@ -0,0 +1,225 @@
+// ============================================
+// Plant Legends - 無頭模擬器
+// ============================================
+// 不開視窗、不依賴 SF3，以固定步長全速執行一個關卡，
+// 依放置腳本種下植物，輸出結果與每秒 tick 數。平衡測試與 CI 效能工作使用。
+//
+// 用法: plant-legends-sim [選項]
+//   --level <id>           關卡（預設 1-1）
+//   --scripts <dir>        腳本目錄（預設 scripts）
+//   --placements <file>    放置腳本（Lua，回傳 { { plant=, col=, row=, at= }, ... }）
+//   --place <id@col,row[@t]>  追加一筆放置，可重複
+//   --sun <n>              開局額外陽光
+//   --dt <seconds>         固定步長（預設 1 / config.global.tick_rate）
+//   --max-time <seconds>   遊戲時間上限（預設 600）
+//   --seed <n>             亂數種子（預設 1；相同種子與放置得到相同結果）
+//   --record <file>        把這次模擬的種子與放置錄成重播檔
+//   --replay <file>        播放重播檔（關卡、種子、步長取自檔案，忽略放置選項）
+//   --verbose              輸出遊戲日誌
+
+#include "sim_common.hpp"
+#include "lua/lua_manager.hpp"
+#include "core/log.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace PL;
+
+namespace {
+
+struct Options {
+    std::string level = "1-1";
+    std::string scripts = "scripts";
+    std::string placements;
+    std::vector<std::string> places;
+    i32 sun = 0;
+    f32 dt = 0.0f;  // 0 = 設定檔的 tick_rate
+    f32 maxTime = 600.0f;
+    u64 seed = 1;
+    std::string record;
+    std::string replay;
+    bool verbose = false;
+};
+
+void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "usage: %s [--level id] [--scripts dir] [--placements file.lua] [--place id@col,row[@t]]...\n"
+        "          [--sun n] [--dt seconds] [--max-time seconds] [--seed n]\n"
+        "          [--record file] [--replay file] [--verbose]\n", argv0);
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        auto needs = [&]() {
+            if (!value) {
+                std::fprintf(stderr, "[Error] %s needs a value\n", arg);
+                return false;
+            }
+            i++;
+            return true;
+        };
+        
+        if (std::strcmp(arg, "--verbose") == 0) {
+            opt.verbose = true;
+        } else if (std::strcmp(arg, "--level") == 0) {
+            if (!needs()) return false;
+            opt.level = value;
+        } else if (std::strcmp(arg, "--scripts") == 0) {
+            if (!needs()) return false;
+            opt.scripts = value;
+        } else if (std::strcmp(arg, "--placements") == 0) {
+            if (!needs()) return false;
+            opt.placements = value;
+        } else if (std::strcmp(arg, "--place") == 0) {
+            if (!needs()) return false;
+            opt.places.push_back(value);
+        } else if (std::strcmp(arg, "--sun") == 0) {
+            if (!needs()) return false;
+            opt.sun = std::atoi(value);
+        } else if (std::strcmp(arg, "--dt") == 0) {
+            if (!needs()) return false;
+            opt.dt = (f32)std::atof(value);
+        } else if (std::strcmp(arg, "--max-time") == 0) {
+            if (!needs()) return false;
+            opt.maxTime = (f32)std::atof(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            if (!needs()) return false;
+            opt.seed = std::strtoull(value, nullptr, 0);
+        } else if (std::strcmp(arg, "--record") == 0) {
+            if (!needs()) return false;
+            opt.record = value;
+        } else if (std::strcmp(arg, "--replay") == 0) {
+            if (!needs()) return false;
+            opt.replay = value;
+        } else {
+            std::fprintf(stderr, "[Error] unknown option %s\n", arg);
+            return false;
+        }
+    }
+    if (opt.dt < 0.0f || opt.maxTime <= 0.0f) {
+        std::fprintf(stderr, "[Error] --dt and --max-time must be positive\n");
+        return false;
+    }
+    return true;
+}
+
+int simulate(const Options& opt) {
+    LuaManager::instance().setBytecodeCache(".luacache");
+    if (!sim::loadScripts(opt.scripts)) {
+        return 1;
+    }
+    
+    // 播放模式：關卡、種子、步長與輸入都來自重播檔
+    Replay replay;
+    const bool playback = !opt.replay.empty();
+    if (playback && !replay.load(opt.replay)) {
+        std::fprintf(stderr, "[Error] cannot read replay %s\n", opt.replay.c_str());
+        return 1;
+    }
+    
+    std::vector<sim::Placement> placements;
+    if (!playback) {
+        if (!opt.placements.empty() && !sim::loadPlacements(opt.placements, placements)) {
+            return 1;
+        }
+        for (const std::string& spec : opt.places) {
+            placements.emplace_back();
+            if (!sim::parsePlace(spec, placements.back())) return 1;
+        }
+        sim::sortPlacements(placements);
+    }
+    
+    Game game;
+    Replay recording;
+    if (!opt.record.empty()) {
+        game.setRecorder(&recording);
+    }
+    ReplayPlayer player(replay);
+    game.setSeed(opt.seed);
+    if (!game.initialize()) {
+        std::fprintf(stderr, "[Error] Failed to initialize game\n");
+        return 1;
+    }
+    if (playback) {
+        if (!player.start(game)) {
+            std::fprintf(stderr, "[Error] Failed to load replay level %s\n", symbolName(replay.level));
+            return 1;
+        }
+    } else {
+        if (!game.loadLevel(opt.level)) {
+            std::fprintf(stderr, "[Error] Failed to load level %s\n", opt.level.c_str());
+            return 1;
+        }
+        game.addSun(opt.sun);
+        game.startLevel();
+    }
+    // 全速執行沒有幀空閒時間可用，GC 交回 Lua 自動進行
+    LuaManager::instance().setGcBudget(0.0);
+    
+    // 與遊戲相同的固定步長，結果可與實際遊玩對照
+    const f32 dt = playback ? replay.step : opt.dt > 0.0f ? opt.dt : game.getTimestep().getStep();
+    recording.step = dt;
+    const u64 maxTicks = (u64)(opt.maxTime / dt);
+    sim::PlacementDriver driver(placements, opt.verbose);
+    u64 ticks = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    while (game.getState() == GameState::Playing && ticks < maxTicks) {
+        if (playback) {
+            player.apply(game);
+        } else {
+            driver.apply(game);
+        }
+        game.update(dt);
+        ticks++;
+    }
+    f64 wall = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    
+    std::printf("level %s: %s at %.2f s (%llu ticks, dt %.4f, seed %llu)\n", symbolName(game.getCurrentLevel()),
+                sim::outcomeName(game.getState()), game.getLevelTime(), (unsigned long long)ticks, dt,
+                (unsigned long long)game.getSeed());
+    std::printf("ticks/sec: %.0f (wall %.3f s, %.0fx real time)\n",
+                wall > 0.0 ? ticks / wall : 0.0, wall, wall > 0.0 ? game.getLevelTime() / wall : 0.0);
+    std::printf("waves %d/%d, placed %u/%zu, plants %u, enemies %u, sun %d\n",
+                game.getCurrentWave(), game.getWaveCount(), driver.getPlaced(), placements.size(),
+                game.getPlants().size(), game.getEnemies().size(), game.getSun());
+    
+    int rc = 0;
+    if (playback) {
+        std::printf("replay %s: %u/%zu inputs applied, %u desyncs\n", opt.replay.c_str(),
+                    player.getApplied(), replay.events.size(), player.getDesyncs());
+        rc = player.getDesyncs() > 0 ? 1 : 0;
+    }
+    if (!opt.record.empty()) {
+        game.setRecorder(nullptr);
+        if (!recording.save(opt.record)) return 1;
+        std::printf("recorded %zu inputs to %s\n", recording.events.size(), opt.record.c_str());
+    }
+    return rc;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+    
+    Logger& logger = Logger::instance();
+    logger.setMinLevel(opt.verbose ? LogLevel::Info : LogLevel::Warn);
+    logger.start();
+    
+    int rc = simulate(opt);
+    
+    sim::unloadScripts();
+    logger.stop();
+    return rc;
+}